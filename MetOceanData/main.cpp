@@ -46,6 +46,7 @@ int main(int argc, char *argv[]) {
   d = new MetOceanData(opt.service, opt.station, opt.product, opt.parameterId,
                        opt.vdatum, opt.datum, opt.startDate, opt.endDate,
                        opt.outputFile, &a);
+  d->setBatchSize(opt.batchSize);
   d->setLoggingActive();
   QObject::connect(d, SIGNAL(finished()), &a, SLOT(quit()));
   QTimer::singleShot(0, d, SLOT(run()));
@@ -27,6 +27,7 @@
 #include "ndbcdata.h"
 #include "noaacoops.h"
 #include "usgswaterdata.h"
+#include "waterdatabatch.h"
 #include "xtidedata.h"
 
 static const QHash<int, QString> noaaProducts = {
@@ -60,6 +61,7 @@ MetOceanData::MetOceanData(QObject *parent)
       m_product(0),
       m_station(nullptr),
       m_datum(0),
+      m_batchSize(0),
       m_startDate(QDateTime()),
       m_endDate(QDateTime()),
       m_outputFile(QString()),
@@ -76,6 +78,7 @@ MetOceanData::MetOceanData(serviceTypes service, QStringList station,
       m_product(product),
       m_station(station),
       m_datum(datum),
+      m_batchSize(0),
       m_startDate(startDate),
       m_endDate(endDate),
       m_outputFile(outputFile),
@@ -264,35 +267,58 @@ void MetOceanData::getNdbcData() {
 
   Hmdf *dataOut = new Hmdf(this);
 
-  for (size_t i = 0; i < s.size(); ++i) {
-    Hmdf *data = new Hmdf(this);
-    NdbcData *ndbc =
-        new NdbcData(s[i], this->startDate(), this->endDate(), this);
-    int ierr = ndbc->get(data);
-    if (ierr != 0) {
-      emit warning(QString(s[i].id() + ": " + ndbc->errorString()));
-      delete data;
-      delete ndbc;
-      continue;
+  if (this->m_batchSize > 0 && s.size() > 1) {
+    QVector<WaterData *> fetchers;
+    for (auto &st : s) {
+      fetchers.push_back(
+          new NdbcData(st, this->startDate(), this->endDate(), this));
     }
 
-    bool useStation = false;
-    ierr = this->printAvailableProducts(data);
-    if (ierr != 0) {
-      useStation = false;
-    } else {
-      useStation = true;
+    QVector<HmdfStation *> result(s.size(), nullptr);
+    this->runBatch(fetchers, s, [&](int i, Hmdf *data) {
+      if (this->printAvailableProducts(data) != 0) return;
+      HmdfStation *st = data->station(this->m_product - 1);
+      st->setName(s[i].name());
+      st->setId(s[i].id());
+      st->setParent(dataOut);
+      result[i] = st;
+    });
+    qDeleteAll(fetchers);
+
+    for (auto st : result) {
+      if (st != nullptr) dataOut->addStation(st);
     }
+  } else {
+    for (size_t i = 0; i < s.size(); ++i) {
+      Hmdf *data = new Hmdf(this);
+      NdbcData *ndbc =
+          new NdbcData(s[i], this->startDate(), this->endDate(), this);
+      int ierr = ndbc->get(data);
+      if (ierr != 0) {
+        emit warning(QString(s[i].id() + ": " + ndbc->errorString()));
+        delete data;
+        delete ndbc;
+        continue;
+      }
 
-    if (useStation) {
-      data->station(this->m_product - 1)->setName(s[i].name());
-      data->station(this->m_product - 1)->setId(s[i].id());
-      dataOut->addStation(data->station(this->m_product - 1));
-      data->station(this->m_product - 1)->setParent(dataOut);
-    }
+      bool useStation = false;
+      ierr = this->printAvailableProducts(data);
+      if (ierr != 0) {
+        useStation = false;
+      } else {
+        useStation = true;
+      }
 
-    delete ndbc;
-    delete data;
+      if (useStation) {
+        data->station(this->m_product - 1)->setName(s[i].name());
+        data->station(this->m_product - 1)->setId(s[i].id());
+        dataOut->addStation(data->station(this->m_product - 1));
+        data->station(this->m_product - 1)->setParent(dataOut);
+      }
+
+      delete ndbc;
+      delete data;
+    }
   }
 
   if (dataOut->nstations() == 0) return;
@@ -377,35 +403,73 @@ void MetOceanData::getUsgsData() {
 
   Hmdf *data2 = new Hmdf(this);
 
-  for (size_t i = 0; i < s.size(); ++i) {
-    Hmdf *data = new Hmdf(this);
-    UsgsWaterdata *usgs =
-        new UsgsWaterdata(s[i], this->startDate(), this->endDate(), 0, this);
-    int ierr = usgs->get(data);
-    if (ierr != 0) {
-      emit error(s[i].name() + ": " + usgs->errorString());
-      continue;
+  if (this->m_batchSize > 0 && s.size() > 1) {
+    QVector<WaterData *> fetchers;
+    for (auto &st : s) {
+      fetchers.push_back(
+          new UsgsWaterdata(st, this->startDate(), this->endDate(), 0, this));
     }
 
-    if (productId == QString() && this->m_product == -1) {
-      if (this->printAvailableProducts(data, false) != 0) return;
-    }
+    QVector<HmdfStation *> result(s.size(), nullptr);
+    this->runBatch(fetchers, s, [&](int i, Hmdf *data) {
+      if (productId == QString() && this->m_product == -1) {
+        if (this->printAvailableProducts(data, false) != 0) return;
+      }
 
-    int productIndex;
-    if (productId != QString()) {
-      productIndex = this->getUSGSProductIndex(data, productId);
-    } else {
-      productIndex = this->m_product - 1;
-      productId = data->station(productIndex)->id();
+      int productIndex;
+      if (productId != QString()) {
+        productIndex = this->getUSGSProductIndex(data, productId);
+      } else {
+        productIndex = this->m_product - 1;
+        productId = data->station(productIndex)->id();
+      }
+
+      if (productIndex < 0) return;
+
+      HmdfStation *st = data->station(productIndex);
+      data2->setUnits(st->name().split(",").value(0));
+      data2->setDatum("usgs_datum");
+      st->setName(s.at(i).name());
+      st->setId(s.at(i).id());
+      st->setParent(data2);
+      result[i] = st;
+    });
+    qDeleteAll(fetchers);
+
+    for (auto st : result) {
+      if (st != nullptr) data2->addStation(st);
     }
+  } else {
+    for (size_t i = 0; i < s.size(); ++i) {
+      Hmdf *data = new Hmdf(this);
+      UsgsWaterdata *usgs =
+          new UsgsWaterdata(s[i], this->startDate(), this->endDate(), 0, this);
+      int ierr = usgs->get(data);
+      if (ierr != 0) {
+        emit error(s[i].name() + ": " + usgs->errorString());
+        continue;
+      }
+
+      if (productId == QString() && this->m_product == -1) {
+        if (this->printAvailableProducts(data, false) != 0) return;
+      }
+
+      int productIndex;
+      if (productId != QString()) {
+        productIndex = this->getUSGSProductIndex(data, productId);
+      } else {
+        productIndex = this->m_product - 1;
+        productId = data->station(productIndex)->id();
+      }
 
-    if (productIndex < 0) continue;
+      if (productIndex < 0) continue;
 
-    data2->addStation(data->station(productIndex));
-    data2->setUnits(data->station(productIndex)->name().split(",").value(0));
-    data2->setDatum("usgs_datum");
-    data2->station(i)->setName(s.at(i).name());
-    data2->station(i)->setId(s.at(i).id());
+      data2->addStation(data->station(productIndex));
+      data2->setUnits(data->station(productIndex)->name().split(",").value(0));
+      data2->setDatum("usgs_datum");
+      data2->station(i)->setName(s.at(i).name());
+      data2->station(i)->setId(s.at(i).id());
+    }
   }
 
   if (data2->nstations() > 0) {
@@ -489,40 +553,72 @@ void MetOceanData::getNoaaData() {
 
   Hmdf *dataOut = new Hmdf(this);
 
-  for (size_t i = 0; i < s.size(); ++i) {
+  if (this->m_batchSize > 0 && s.size() > 1) {
     QString d2 = "MSL";
     if (!this->m_usevdatum) d2 = d;
 
-    NoaaCoOps *coops = new NoaaCoOps(s[i], this->startDate(), this->endDate(),
-                                     p, d2, this->m_usevdatum, "metric", this);
-    Hmdf *data = new Hmdf(this);
-    int ierr = coops->get(data);
-    if (ierr != 0) {
-      emit warning(QString(s[i].id() + ": " + coops->errorString()));
-      delete data;
-      delete coops;
-      continue;
+    QVector<WaterData *> fetchers;
+    for (auto &st : s) {
+      fetchers.push_back(new NoaaCoOps(st, this->startDate(), this->endDate(),
+                                       p, d2, this->m_usevdatum, "metric",
+                                       this));
     }
 
-    if (this->m_usevdatum) {
-      if (!data->applyDatumCorrection(s[i], datumid)) {
-        std::cout << "Warning: Could not convert datum for "
-                  << s[i].name().toStdString() << ". Using MSL." << std::endl;
-        data->setDatum("MSL");
+    QVector<HmdfStation *> result(s.size(), nullptr);
+    this->runBatch(fetchers, s, [&](int i, Hmdf *data) {
+      if (this->m_usevdatum) {
+        if (!data->applyDatumCorrection(s[i], datumid)) {
+          std::cout << "Warning: Could not convert datum for "
+                    << s[i].name().toStdString() << ". Using MSL."
+                    << std::endl;
+        }
+      }
+      HmdfStation *st = data->station(0);
+      st->setParent(dataOut);
+      result[i] = st;
+    });
+    qDeleteAll(fetchers);
+
+    for (auto st : result) {
+      if (st != nullptr) dataOut->addStation(st);
+    }
+  } else {
+    for (size_t i = 0; i < s.size(); ++i) {
+      QString d2 = "MSL";
+      if (!this->m_usevdatum) d2 = d;
+
+      NoaaCoOps *coops =
+          new NoaaCoOps(s[i], this->startDate(), this->endDate(), p, d2,
+                        this->m_usevdatum, "metric", this);
+      Hmdf *data = new Hmdf(this);
+      int ierr = coops->get(data);
+      if (ierr != 0) {
+        emit warning(QString(s[i].id() + ": " + coops->errorString()));
+        delete data;
+        delete coops;
+        continue;
+      }
+
+      if (this->m_usevdatum) {
+        if (!data->applyDatumCorrection(s[i], datumid)) {
+          std::cout << "Warning: Could not convert datum for "
+                    << s[i].name().toStdString() << ". Using MSL." << std::endl;
+          data->setDatum("MSL");
+        } else {
+          data->setDatum(d);
+        }
       } else {
         data->setDatum(d);
       }
-    } else {
-      data->setDatum(d);
-    }
 
-    data->setUnits(u);
+      data->setUnits(u);
 
-    dataOut->addStation(data->station(0));
-    data->station(0)->setParent(dataOut);
+      dataOut->addStation(data->station(0));
+      data->station(0)->setParent(dataOut);
 
-    delete data;
-    delete coops;
+      delete data;
+      delete coops;
+    }
   }
 
   int ierr = dataOut->write(this->m_outputFile);
@@ -607,3 +703,40 @@ QString MetOceanData::noaaIndexToUnits() { return noaaUnits[this->m_product]; }
 int MetOceanData::getDatum() const { return m_datum; }
 
 void MetOceanData::setDatum(int datum) { m_datum = datum; }
+
+int MetOceanData::batchSize() const { return m_batchSize; }
+
+void MetOceanData::setBatchSize(int batchSize) { m_batchSize = batchSize; }
+
+int MetOceanData::runBatch(const QVector<WaterData *> &fetchers,
+                           const QVector<Station> &s,
+                           std::function<void(int, Hmdf *)> stationHandler) {
+  WaterDataBatch batch;
+  batch.setMaxConcurrent(this->m_batchSize);
+  for (auto f : fetchers) batch.addFetcher(f);
+
+  connect(&batch, &WaterDataBatch::stationFinished, stationHandler);
+  connect(&batch, &WaterDataBatch::stationFailed,
+          [&](int index, QString errorString) {
+            emit warning(QString(s[index].id() + ": " + errorString));
+          });
+  connect(&batch, &WaterDataBatch::progress, [&](int complete, int total) {
+    emit status(QString("Retrieved " + QString::number(complete) + " of " +
+                        QString::number(total) + " stations"),
+                total > 0 ? (complete * 100) / total : 100);
+  });
+
+  batch.run();
+
+  emit status(
+      QString("Downloaded %1 stations (%2 failed), %3 MB in %4 s, %5 kB/s")
+          .arg(batch.numSucceeded())
+          .arg(batch.numFailed())
+          .arg(static_cast<double>(batch.bytesReceived()) / 1048576.0, 0,
+               'f', 2)
+          .arg(static_cast<double>(batch.elapsed()) / 1000.0, 0, 'f', 1)
+          .arg(batch.throughput() / 1024.0, 0, 'f', 1),
+      100);
+
+  return batch.numSucceeded();
+}
@@ -22,9 +22,11 @@
 
 #include <QDateTime>
 #include <QObject>
+#include <functional>
 #include "hmdf.h"
 #include "station.h"
 #include "stationlocations.h"
+#include "waterdata.h"
 
 class MetOceanData : public QObject {
   Q_OBJECT
@@ -63,6 +65,9 @@ class MetOceanData : public QObject {
   int getDatum() const;
   void setDatum(int datum);
 
+  int batchSize() const;
+  void setBatchSize(int batchSize);
+
   static StationLocations::MarkerType serviceToMarkerType(
       MetOceanData::serviceTypes type);
   static bool findStation(QStringList name, StationLocations::MarkerType type,
@@ -94,11 +99,16 @@ class MetOceanData : public QObject {
   int printAvailableProducts(Hmdf *data, bool reselect = true);
   int getUSGSProductIndex(Hmdf *stationdata, const QString &product);
 
+  int runBatch(const QVector<WaterData *> &fetchers,
+               const QVector<Station> &s,
+               std::function<void(int, Hmdf *)> stationHandler);
+
   bool m_usevdatum;
   int m_service;
   QStringList m_station;
   int m_product;
   int m_datum;
+  int m_batchSize;
   QDateTime m_startDate;
   QDateTime m_endDate;
   QString m_outputFile;
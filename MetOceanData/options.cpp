@@ -37,7 +37,8 @@ void Options::addOptions() {
                              << m_serviceType << m_stationId << m_boundingBox
                              << m_nearest << m_startDate << m_endDate
                              << m_product << m_parameterId << m_outputFile
-                             << m_datum << m_vdatum << m_list << m_show);
+                             << m_datum << m_vdatum << m_list << m_show
+                             << m_batch);
 }
 
 Options::CommandLineOptions Options::getCommandLineOptions() {
@@ -179,6 +180,16 @@ Options::CommandLineOptions Options::getCommandLineOptions() {
     }
   }
 
+  opt.batchSize = 0;
+  if (this->parser()->isSet(m_batch)) {
+    opt.batchSize = checkIntegerString(this->parser()->value(m_batch));
+    if (opt.batchSize < 1) {
+      std::cerr << "Error: Invalid batch size." << std::endl;
+      std::cerr.flush();
+      this->parser()->showHelp(1);
+    }
+  }
+
   opt.vdatum = false;
   if (this->parser()->isSet(m_vdatum)) {
     opt.vdatum = true;
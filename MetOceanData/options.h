@@ -40,6 +40,7 @@ class Options : public QObject {
     QString outputFile;
     QStringList station;
     QString parameterId;
+    int batchSize;
   };
 
   void processOptions();
@@ -95,6 +95,12 @@ static const QCommandLineOption m_vdatum =
     QCommandLineOption(QStringList() << "vdatum",
                        "Use NOAA VDatum transformations where available");
 
+static const QCommandLineOption m_batch = QCommandLineOption(
+    QStringList() << "batch",
+    "Download multiple stations concurrently through a shared connection "
+    "pool with up to n requests in flight at once",
+    "n");
+
 static const QCommandLineOption m_parameterId = QCommandLineOption(
     QStringList() << "parameter", "Parameter codes for USGS", "code");
 
@@ -18,7 +18,7 @@
 #
 #-----------------------------------------------------------------------#
 
-QT  += core gui network xml charts printsupport
+QT  += core gui network xml charts printsupport concurrent
 QT  += qml quick positioning location quickwidgets
 
 include($$PWD/../global.pri)
@@ -33,6 +33,8 @@ TEMPLATE = app
 SOURCES +=\
     src/crms.cpp \
     src/crmsdialog.cpp \
+    src/seriesdecimator.cpp \
+    src/stationmatcher.cpp \
     src/stationmodel.cpp \
     src/colors.cpp \
     src/dflow.cpp \
@@ -66,6 +68,8 @@ HEADERS  += \
     src/crms.h \
     src/crmsdialog.h \
     src/metoceanviewer.h \
+    src/seriesdecimator.h \
+    src/stationmatcher.h \
     src/stationmodel.h \
     src/colors.h \
     src/dflow.h \
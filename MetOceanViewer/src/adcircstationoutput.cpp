@@ -21,18 +21,110 @@
 #include <QFile>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iterator>
+#include <memory>
+#include "boost/spirit/include/qi.hpp"
 #include "errors.h"
 #include "hmdf.h"
 #include "netcdf.h"
+#include "timeaxis.h"
 
 AdcircStationOutput::AdcircStationOutput(QObject *parent) : QObject(parent) {
   this->_error = MetOceanViewer::Error::NOERR;
   this->_ncerr = NC_NOERR;
   this->nStations = 0;
   this->nSnaps = 0;
+  this->m_readBufferSize = 64 * 1024 * 1024;
+  this->m_lazy = false;
+  this->m_varid1 = -1;
+  this->m_varid2 = -1;
+  this->m_isVector = false;
+  this->m_fillValue = 0.0;
 }
 
+size_t AdcircStationOutput::readBufferSize() const {
+  return this->m_readBufferSize;
+}
+
+void AdcircStationOutput::setReadBufferSize(size_t bytes) {
+  this->m_readBufferSize = bytes;
+}
+
+bool AdcircStationOutput::lazy() const { return this->m_lazy; }
+
+void AdcircStationOutput::setLazy(bool lazy) { this->m_lazy = lazy; }
+
+namespace {
+//...Reads one station's column of the (time, station) variable on demand
+class AdcircStationLoader : public HmdfStationLoader {
+ public:
+  AdcircStationLoader(const QString &filename, int varid1, int varid2,
+                      bool isVector, double fillValue,
+                      const QVector<size_t> &stationIndex,
+                      const QVector<qint64> &date)
+      : m_filename(filename),
+        m_varid1(varid1),
+        m_varid2(varid2),
+        m_isVector(isVector),
+        m_fillValue(fillValue),
+        m_stationIndex(stationIndex),
+        m_date(date),
+        m_ncid(-1) {}
+
+  ~AdcircStationLoader() override {
+    if (this->m_ncid >= 0) nc_close(this->m_ncid);
+  }
+
+ protected:
+  int readStation(size_t index, size_t length, qint64 *date,
+                  double *data) override {
+    if (this->m_ncid < 0) {
+      int ncid;
+      int ierr = nc_open(this->m_filename.toUtf8(), NC_NOWRITE, &ncid);
+      if (ierr != NC_NOERR) return ierr;
+      this->m_ncid = ncid;
+    }
+
+    size_t start[2] = {0, this->m_stationIndex[index]};
+    size_t count[2] = {length, 1};
+    int ierr = nc_get_vara_double(this->m_ncid, this->m_varid1, start, count,
+                                  data);
+    if (ierr != NC_NOERR) return ierr;
+
+    std::vector<double> v;
+    if (this->m_isVector) {
+      v.resize(length);
+      ierr = nc_get_vara_double(this->m_ncid, this->m_varid2, start, count,
+                                v.data());
+      if (ierr != NC_NOERR) return ierr;
+    }
+
+    for (size_t j = 0; j < length; ++j) {
+      if (data[j] == this->m_fillValue) {
+        data[j] = HmdfStation::nullDataValue();
+      } else if (this->m_isVector) {
+        data[j] = std::sqrt(data[j] * data[j] + v[j] * v[j]);
+      }
+    }
+
+    std::copy(this->m_date.constBegin(), this->m_date.constBegin() + length,
+              date);
+    return NC_NOERR;
+  }
+
+ private:
+  QString m_filename;
+  int m_varid1;
+  int m_varid2;
+  bool m_isVector;
+  double m_fillValue;
+  QVector<size_t> m_stationIndex;
+  QVector<qint64> m_date;
+  int m_ncid;
+};
+}  // namespace
+
 int AdcircStationOutput::error() { return this->_error; }
 
 QString AdcircStationOutput::errorString() { return "errorString"; }
@@ -40,73 +132,157 @@ QString AdcircStationOutput::errorString() { return "errorString"; }
 int AdcircStationOutput::read(QString AdcircFile, QString AdcircStationFile,
                               QDateTime coldStart) {
   this->coldStartTime = coldStart;
+  this->m_filename.clear();
   this->_error = this->readAscii(AdcircFile, AdcircStationFile);
   return this->_error;
 }
 
 int AdcircStationOutput::read(QString AdcircFile, QDateTime coldStart) {
   this->coldStartTime = coldStart;
+  this->m_stationIndex.clear();
   this->_error = this->readNetCDF(AdcircFile);
   return this->_error;
 }
 
+int AdcircStationOutput::read(QString AdcircFile, QDateTime coldStart,
+                              const QVector<size_t> &stationIndices) {
+  this->coldStartTime = coldStart;
+  this->m_stationIndex = stationIndices;
+  std::sort(this->m_stationIndex.begin(), this->m_stationIndex.end());
+  this->m_stationIndex.erase(
+      std::unique(this->m_stationIndex.begin(), this->m_stationIndex.end()),
+      this->m_stationIndex.end());
+  this->_error = this->readNetCDF(AdcircFile);
+  return this->_error;
+}
+
+//...Helpers for the ASCII reader. These work directly on the mapped file
+//   so no QString or QStringList is created for each line
+static const char *asciiNextLine(const char *pos, const char *end) {
+  const char *eol = static_cast<const char *>(
+      memchr(pos, '\n', static_cast<size_t>(end - pos)));
+  return eol == nullptr ? end : eol + 1;
+}
+
+static inline bool asciiIsSeparator(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',';
+}
+
+static bool asciiNextDouble(const char *&pos, const char *eol, double &value) {
+  while (pos < eol && asciiIsSeparator(*pos)) ++pos;
+  if (pos >= eol) return false;
+  return boost::spirit::qi::parse(pos, eol, boost::spirit::qi::double_, value);
+}
+
+static QString asciiRemainder(const char *pos, const char *eol) {
+  while (pos < eol && asciiIsSeparator(*pos)) ++pos;
+  while (eol > pos && asciiIsSeparator(*(eol - 1))) --eol;
+  return QString::fromUtf8(pos, static_cast<int>(eol - pos)).simplified();
+}
+
 int AdcircStationOutput::readAscii(QString AdcircOutputFile,
                                    QString AdcircStationFile) {
   QFile MyFile(AdcircOutputFile), StationFile(AdcircStationFile);
-  QString header1, header2, TempLine;
-  QStringList headerData, TempList;
-  int nColumns;
 
   // Check if we can open the file
-  if (!MyFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  if (!MyFile.open(QIODevice::ReadOnly)) {
     this->_error = MetOceanViewer::Error::CANNOT_OPEN_FILE;
     return this->_error;
   }
 
-  if (!StationFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  if (!StationFile.open(QIODevice::ReadOnly)) {
     this->_error = MetOceanViewer::Error::CANNOT_OPEN_FILE;
     return this->_error;
   }
 
-  // Read the 61/62 style file
-  header1 = MyFile.readLine();
-  header2 = MyFile.readLine().simplified();
-  headerData = header2.split(" ");
+  int ierr = this->parseAsciiOutput(MyFile);
+  MyFile.close();
+  if (ierr != MetOceanViewer::Error::NOERR) {
+    StationFile.close();
+    return ierr;
+  }
 
-  this->nSnaps = headerData.value(0).toInt();
-  this->nStations = headerData.value(1).toInt();
-  nColumns = headerData.value(4).toInt();
+  ierr = this->parseAsciiStations(StationFile);
+  StationFile.close();
+
+  return ierr;
+}
+
+//...Parses a 61/62 style file. The header gives the number of snaps,
+//   stations and columns, so the contiguous data array is sized once and
+//   each value is converted in place from the mapped file.
+int AdcircStationOutput::parseAsciiOutput(QFile &file) {
+  const qint64 size = file.size();
+  uchar *map = size > 0 ? file.map(0, size) : nullptr;
+  if (map == nullptr) return MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+
+  const char *pos = reinterpret_cast<const char *>(map);
+  const char *end = pos + size;
+
+  //...Header
+  pos = asciiNextLine(pos, end);
+  const char *eol = asciiNextLine(pos, end);
+  double header[5];
+  for (size_t i = 0; i < 5; ++i) {
+    if (!asciiNextDouble(pos, eol, header[i])) {
+      file.unmap(map);
+      return MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+    }
+  }
+  pos = eol;
+
+  this->nSnaps = static_cast<size_t>(header[0]);
+  this->nStations = static_cast<size_t>(header[1]);
+  const int nColumns = static_cast<int>(header[4]);
 
   this->time.resize(this->nSnaps);
-  this->data.resize(this->nStations);
-
-  for (size_t i = 0; i < this->nStations; ++i)
-    this->data[i].resize(this->nSnaps);
-
-  for (size_t i = 0; i < this->nSnaps; ++i) {
-    TempLine = MyFile.readLine().simplified();
-    TempList = TempLine.split(" ");
-    this->time[i] = TempList.value(0).toDouble();
-    for (size_t j = 0; j < this->nStations; ++j) {
-      TempLine = MyFile.readLine().simplified();
-      TempList = TempLine.split(" ");
-      if (TempList.value(1).toDouble() < -900) {
-        this->data[j][i] = HmdfStation::nullDataValue();
-      } else {
-        this->data[j][i] = TempList.value(1).toDouble();
-        if (nColumns == 2)
-          this->data[j][i] = pow(
-              pow(this->data[j][i], 2) + pow(TempList.value(2).toDouble(), 2),
-              2);
-      }
+  this->data.resize(this->nStations * this->nSnaps);
+  std::fill(this->data.begin(), this->data.end(),
+            HmdfStation::nullDataValue());
+
+  double *out = this->data.data();
+
+  for (size_t i = 0; i < this->nSnaps && pos < end; ++i) {
+    eol = asciiNextLine(pos, end);
+    if (!asciiNextDouble(pos, eol, this->time[i])) {
+      file.unmap(map);
+      return MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+    }
+    pos = eol;
+
+    for (size_t j = 0; j < this->nStations && pos < end; ++j) {
+      eol = asciiNextLine(pos, end);
+      double index, v1, v2 = 0.0;
+      bool ok = asciiNextDouble(pos, eol, index) &&
+                asciiNextDouble(pos, eol, v1);
+      if (ok && nColumns == 2) ok = asciiNextDouble(pos, eol, v2);
+      pos = eol;
+
+      if (!ok || v1 < -900) continue;
+      out[j * this->nSnaps + i] =
+          nColumns == 2 ? std::sqrt(v1 * v1 + v2 * v2) : v1;
     }
   }
-  MyFile.close();
 
-  // Now read the station location file
-  TempLine = StationFile.readLine().simplified();
-  TempList = TempLine.split(" ");
-  int TempStations = TempList.value(0).toInt();
+  file.unmap(map);
+  return MetOceanViewer::Error::NOERR;
+}
+
+//...Parses the station location file. The first line holds the number of
+//   stations, followed by one "x y [name]" line per station with either
+//   comma or space separated fields
+int AdcircStationOutput::parseAsciiStations(QFile &file) {
+  QByteArray buffer = file.readAll();
+  const char *pos = buffer.constData();
+  const char *end = pos + buffer.size();
+
+  const char *eol = asciiNextLine(pos, end);
+  double n;
+  if (!asciiNextDouble(pos, eol, n))
+    return MetOceanViewer::Error::WRONG_NUMBER_OF_STATIONS;
+  pos = eol;
+
+  size_t TempStations = static_cast<size_t>(n);
   if (TempStations != this->nStations)
     return MetOceanViewer::Error::WRONG_NUMBER_OF_STATIONS;
 
@@ -115,19 +291,20 @@ int AdcircStationOutput::readAscii(QString AdcircOutputFile,
   this->station_name.resize(this->nStations);
 
   for (size_t i = 0; i < TempStations; ++i) {
-    TempLine = StationFile.readLine().simplified();
-    TempList = TempLine.split(QRegExp(",| "));
-    this->longitude[i] = TempList.value(0).toDouble();
-    this->latitude[i] = TempList.value(1).toDouble();
-
-    if (TempList.length() > 2) {
-      this->station_name[i] = "";
-      for (int j = 2; j < TempList.length(); ++j)
-        this->station_name[i] = this->station_name[i] + " " + TempList.value(j);
-    } else
+    eol = asciiNextLine(pos, end);
+    double x = 0.0, y = 0.0;
+    if (!asciiNextDouble(pos, eol, x) || !asciiNextDouble(pos, eol, y))
+      return MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
+    this->longitude[i] = x;
+    this->latitude[i] = y;
+
+    QString name = asciiRemainder(pos, eol);
+    if (name.isEmpty())
       this->station_name[i] = tr("Station_") + QString::number(i);
+    else
+      this->station_name[i] = name;
+    pos = eol;
   }
-  StationFile.close();
 
   return MetOceanViewer::Error::NOERR;
 }
@@ -209,14 +386,24 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
     if (i == 5) return MetOceanViewer::Error::NO_VARIABLE_FOUND;
   }
 
+  // Select the stations to read. With no subset requested, every station
+  // in the file is read
+  if (this->m_stationIndex.isEmpty()) {
+    this->m_stationIndex.resize(station_size);
+    for (size_t i = 0; i < station_size; ++i) this->m_stationIndex[i] = i;
+  } else if (this->m_stationIndex.last() >= station_size) {
+    nc_close(ncid);
+    this->_error = MetOceanViewer::Error::WRONG_NUMBER_OF_STATIONS;
+    return this->_error;
+  }
+
   // Size the output variables
-  this->latitude.reserve(station_size);
-  this->longitude.reserve(station_size);
-  this->nStations = station_size;
+  this->nStations = this->m_stationIndex.size();
   this->nSnaps = time_size;
+  this->latitude.reserve(this->nStations);
+  this->longitude.reserve(this->nStations);
   this->time.reserve(time_size);
-  this->data.resize(station_size);
-  for (size_t i = 0; i < station_size; ++i) this->data[i].resize(time_size);
+  if (!this->m_lazy) this->data.resize(this->nStations * time_size);
 
   // Read the station locations and times
   this->_ncerr = nc_inq_varid(ncid, "time", &varid_time);
@@ -262,7 +449,7 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
     delete[] coor;
     return this->_error;
   }
-  std::copy(coor, coor + station_size, std::back_inserter(this->longitude));
+  for (auto s : this->m_stationIndex) this->longitude.push_back(coor[s]);
   delete[] coor;
 
   coor = new double[station_size];
@@ -272,56 +459,25 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
     delete[] coor;
     return this->_error;
   }
-  std::copy(coor, coor + station_size, std::back_inserter(this->latitude));
+  for (auto s : this->m_stationIndex) this->latitude.push_back(coor[s]);
   delete[] coor;
 
-  // Loop over the stations, reading the data into memory
-  for (size_t i = 0; i < station_size; ++i) {
-    double *tempVar1 = new double[time_size];
-    double *tempVar2 = new double[time_size];
-
-    // Read from netCDF
-    start[0] = 0;
-    start[1] = i;
-    count[0] = time_size;
-    count[1] = 1;
-    this->_ncerr = nc_get_vara(ncid, varid_zeta, start, count, tempVar1);
-    if (this->_ncerr != NC_NOERR) {
-      delete[] tempVar1;
-      delete[] tempVar2;
-      this->_error = MetOceanViewer::Error::NETCDF;
-      return this->_error;
-    }
-
-    if (isVector) {
-      this->_ncerr = nc_get_vara(ncid, varid_zeta2, start, count, tempVar2);
-      if (this->_ncerr != NC_NOERR) {
-        delete[] tempVar1;
-        delete[] tempVar2;
-        this->_error = MetOceanViewer::Error::NETCDF;
-        return this->_error;
-      }
-      for (size_t j = 0; j < time_size; j++) {
-        if (tempVar1[j] != fillVal) {
-          this->data[i][j] =
-              sqrt(pow(tempVar1[j], 2.0) + pow(tempVar2[j], 2.0));
-        } else {
-          this->data[i][j] = HmdfStation::nullDataValue();
-        }
-      }
-    } else {
-      for (size_t j = 0; j < time_size; ++j) {
-        if (tempVar1[j] != fillVal) {
-          this->data[i][j] = tempVar1[j];
-        } else {
-          this->data[i][j] = HmdfStation::nullDataValue();
-        }
-      }
-    }
-
-    delete[] tempVar1;
-    delete[] tempVar2;
+  // Read the data in blocks of time snaps spanning the selected stations.
+  // In lazy mode only remember where the data lives
+  this->m_filename = AdcircOutputFile;
+  this->m_varid1 = varid_zeta;
+  this->m_varid2 = isVector ? varid_zeta2 : -1;
+  this->m_isVector = isVector;
+  this->m_fillValue = fillVal;
+  if (!this->m_lazy)
+    this->_ncerr = this->readNetCDFBlocks(ncid, varid_zeta, varid_zeta2,
+                                          isVector, fillVal, time_size);
+  if (this->_ncerr != NC_NOERR) {
+    nc_close(ncid);
+    this->_error = MetOceanViewer::Error::NETCDF;
+    return this->_error;
   }
+
   this->_error = nc_close(ncid);
   if (this->_error != NC_NOERR) {
     this->_ncerr = this->_error;
@@ -332,26 +488,154 @@ int AdcircStationOutput::readNetCDF(QString AdcircOutputFile) {
   // Finally, name the stations the default names for now. Later
   // we can get fancy and try to get the ADCIRC written names in
   // the NetCDF file
-  this->station_name.resize(station_size);
-  for (int i = 0; i < station_size; ++i)
-    this->station_name[i] = tr("Station ") + QString::number(i);
+  this->station_name.resize(this->nStations);
+  for (int i = 0; i < this->nStations; ++i)
+    this->station_name[i] =
+        tr("Station ") + QString::number(this->m_stationIndex[i]);
 
   return 0;
 }
 
+//...Reads the (time, station) variable as contiguous hyperslabs of
+//   [nt, station range] instead of one strided column per station. The
+//   number of snaps in a block is chosen so the read buffers stay within
+//   readBufferSize() bytes. Each block is transposed into the station-major
+//   output a tile at a time so that both the source rows and destination
+//   series stay in cache.
+//
+//   A sparse subset is read as one hyperslab per run of requested stations.
+//   Runs separated by no more than maxGap stations are read as one, since a
+//   few unused columns cost less than another request to the library.
+int AdcircStationOutput::readNetCDFBlocks(int ncid, int varid1, int varid2,
+                                          bool isVector, double fillVal,
+                                          size_t time_size) {
+  const size_t tile = 64;
+  const size_t maxGap = 64;
+  const size_t nBuffers = isVector ? 2 : 1;
+
+  //...Station range in the file and the requested stations it covers
+  struct Run {
+    size_t firstStation;
+    size_t span;
+    size_t begin;
+    size_t end;
+  };
+
+  QVector<Run> runs;
+  size_t maxSpan = 0;
+  for (size_t i = 0; i < this->nStations; ++i) {
+    const size_t s = this->m_stationIndex[i];
+    if (!runs.isEmpty() &&
+        s - (runs.last().firstStation + runs.last().span) <= maxGap) {
+      runs.last().span = s - runs.last().firstStation + 1;
+      runs.last().end = i + 1;
+    } else {
+      runs.push_back({s, 1, i, i + 1});
+    }
+    maxSpan = std::max(maxSpan, runs.last().span);
+  }
+  if (runs.isEmpty()) return NC_NOERR;
+
+  const size_t snapsPerBlock = std::max<size_t>(
+      1, std::min(time_size, this->m_readBufferSize /
+                                 (maxSpan * sizeof(double) * nBuffers)));
+
+  std::unique_ptr<double[]> buffer1(new double[snapsPerBlock * maxSpan]);
+  std::unique_ptr<double[]> buffer2(
+      isVector ? new double[snapsPerBlock * maxSpan] : nullptr);
+
+  for (const Run &run : runs) {
+    const size_t stationSpan = run.span;
+    for (size_t t0 = 0; t0 < time_size; t0 += snapsPerBlock) {
+      const size_t nt = std::min(snapsPerBlock, time_size - t0);
+      size_t start[2] = {t0, run.firstStation};
+      size_t count[2] = {nt, stationSpan};
+
+      int ierr = nc_get_vara_double(ncid, varid1, start, count, buffer1.get());
+      if (ierr != NC_NOERR) return ierr;
+      if (isVector) {
+        ierr = nc_get_vara_double(ncid, varid2, start, count, buffer2.get());
+        if (ierr != NC_NOERR) return ierr;
+      }
+
+      const double *u = buffer1.get();
+      const double *v = buffer2.get();
+
+      for (size_t sb = run.begin; sb < run.end; sb += tile) {
+        const size_t se = std::min(sb + tile, run.end);
+        for (size_t tb = 0; tb < nt; tb += tile) {
+          const size_t te = std::min(tb + tile, nt);
+          for (size_t i = sb; i < se; ++i) {
+            double *out = this->data.data() + i * time_size + t0;
+            const size_t c = this->m_stationIndex[i] - run.firstStation;
+            for (size_t j = tb; j < te; ++j) {
+              const double a = u[j * stationSpan + c];
+              if (a == fillVal) {
+                out[j] = HmdfStation::nullDataValue();
+              } else if (isVector) {
+                const double b = v[j * stationSpan + c];
+                out[j] = std::sqrt(a * a + b * b);
+              } else {
+                out[j] = a;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return NC_NOERR;
+}
+
 int AdcircStationOutput::toHmdf(Hmdf *outputHmdf) {
+  //...Every station shares the same time axis, so convert it once
+  QVector<qint64> date(this->nSnaps);
+  TimeAxis::toMSecsSinceEpoch(this->coldStartTime.toMSecsSinceEpoch(), 1000.0,
+                              this->time.constData(), this->nSnaps,
+                              date.data());
+
+  //...Stations read lazily share one loader that reads their column of the
+  //   file when first accessed
+  if (this->m_lazy && !this->m_filename.isEmpty()) {
+    QSharedPointer<HmdfStationLoader> loader(new AdcircStationLoader(
+        this->m_filename, this->m_varid1, this->m_varid2, this->m_isVector,
+        this->m_fillValue, this->m_stationIndex, date));
+    for (int i = 0; i < this->nStations; ++i) {
+      HmdfStation *tempStation = new HmdfStation(outputHmdf);
+      tempStation->setName(this->station_name[i]);
+      tempStation->setId(this->station_name[i]);
+      tempStation->setLongitude(this->longitude[i]);
+      tempStation->setLatitude(this->latitude[i]);
+      tempStation->setStationIndex(static_cast<int>(this->m_stationIndex[i]));
+      tempStation->setLoader(loader, i, this->nSnaps);
+      outputHmdf->addStation(tempStation);
+    }
+    outputHmdf->setSuccess(true);
+    return 0;
+  }
+
+  //...All stations are stored in one arena using the same station-major
+  //   layout as the data read from the file
+  QSharedPointer<HmdfArena> arena(new HmdfArena());
+  arena->allocate(this->nStations * this->nSnaps);
+
   for (int i = 0; i < this->nStations; ++i) {
+    const size_t offset = i * this->nSnaps;
+    std::copy(date.constBegin(), date.constEnd(), arena->date(offset));
+    std::copy(this->data.constBegin() + offset,
+              this->data.constBegin() + offset + this->nSnaps,
+              arena->data(offset));
+
     HmdfStation *tempStation = new HmdfStation(outputHmdf);
     tempStation->setName(this->station_name[i]);
     tempStation->setId(this->station_name[i]);
     tempStation->setLongitude(this->longitude[i]);
     tempStation->setLatitude(this->latitude[i]);
-    tempStation->setStationIndex(i);
-    for (int j = 0; j < this->nSnaps; ++j) {
-      tempStation->setNext(
-          this->coldStartTime.addSecs(this->time[j]).toMSecsSinceEpoch(),
-          this->data[i][j]);
-    }
+    if (this->m_stationIndex.isEmpty())
+      tempStation->setStationIndex(i);
+    else
+      tempStation->setStationIndex(static_cast<int>(this->m_stationIndex[i]));
+    tempStation->setStorage(arena, offset, this->nSnaps);
     outputHmdf->addStation(tempStation);
   }
   outputHmdf->setSuccess(true);
@@ -21,6 +21,7 @@
 #define ADCIRCSTATIONOUTPUT_H
 
 #include <QDateTime>
+#include <QFile>
 #include <QObject>
 #include <QVector>
 #include "hmdf.h"
@@ -31,20 +32,44 @@ public:
   explicit AdcircStationOutput(QObject *parent = nullptr);
 
   int read(QString AdcircFile, QDateTime coldStart);
+  int read(QString AdcircFile, QDateTime coldStart,
+           const QVector<size_t> &stationIndices);
   int read(QString AdcircFile, QString AdcircStationFile, QDateTime coldStart);
   QString errorString();
   int error();
   int toHmdf(Hmdf *outputHmdf);
 
+  size_t readBufferSize() const;
+  void setReadBufferSize(size_t bytes);
+
+  //...In lazy mode reading a netCDF file only reads the station locations
+  //   and times. Each station's series is read when first accessed.
+  bool lazy() const;
+  void setLazy(bool lazy);
+
 private:
   int readAscii(QString AdcircOutputFile, QString AdcircStationFile);
+  int parseAsciiOutput(QFile &file);
+  int parseAsciiStations(QFile &file);
 
   int readNetCDF(QString AdicrcOutputFile);
 
+  int readNetCDFBlocks(int ncid, int varid1, int varid2, bool isVector,
+                       double fillVal, size_t time_size);
+
   size_t nStations;
   size_t nSnaps;
   int _error;
   int _ncerr;
+  size_t m_readBufferSize;
+  bool m_lazy;
+
+  //...Location of the data in the netCDF file, kept for the lazy mode
+  QString m_filename;
+  int m_varid1;
+  int m_varid2;
+  bool m_isVector;
+  double m_fillValue;
 
   QDateTime coldStartTime;
 
@@ -52,9 +77,11 @@ private:
   QVector<double> longitude;
   QVector<double> time;
 
-  QVector<QVector<double>> data;
+  //...Station-major: data[station * nSnaps + snap]
+  QVector<double> data;
 
   QVector<QString> station_name;
+  QVector<size_t> m_stationIndex;
 };
 
 #endif // ADCIRCSTATIONOUTPUT_H
@@ -56,6 +56,14 @@ AddTimeseriesDialog::AddTimeseriesDialog(QWidget *parent)
 
   this->m_unitMenu = this->buildUnitConversionMenu();
   ui->button_unitConversions->setMenu(this->m_unitMenu);
+
+  //...A 3D D-Flow variable is read as one layer or reduced over all of its
+  //   layers into one of the profile products
+  ui->combo_layerMode->addItem(tr("Single layer"));
+  for (int p = 0; p < Dflow::NumProfileProducts; ++p) {
+    ui->combo_layerMode->addItem(
+        Dflow::profileProductName(static_cast<Dflow::ProfileProduct>(p)));
+  }
 }
 //-------------------------------------------//
 
@@ -183,7 +191,14 @@ void AddTimeseriesDialog::setItemsByFiletype() {
       this->setVerticalLayerElements(true);
       ui->spin_layer->setMinimum(1);
       ui->spin_layer->setMaximum(dflow->getNumLayers());
-      ui->spin_layer->setValue(this->m_layer);
+      if (Dflow::isProfileLayer(this->m_layer)) {
+        ui->combo_layerMode->setCurrentIndex(
+            Dflow::profileProduct(this->m_layer) + 1);
+        ui->spin_layer->setValue(1);
+      } else {
+        ui->combo_layerMode->setCurrentIndex(0);
+        ui->spin_layer->setValue(this->m_layer);
+      }
       ui->label_layerinfo->setText(tr("Layer 1 = bottom\nLayer ") +
                                    QString::number(dflow->getNumLayers()) +
                                    tr(" = top"));
@@ -432,12 +447,16 @@ void AddTimeseriesDialog::setPreviousDirectory(
 }
 
 void AddTimeseriesDialog::setVerticalLayerElements(bool enabled) {
-  ui->spin_layer->setEnabled(enabled);
+  ui->combo_layerMode->setEnabled(enabled);
+  ui->spin_layer->setEnabled(enabled &&
+                             ui->combo_layerMode->currentIndex() == 0);
   if (enabled) {
+    ui->combo_layerMode->show();
     ui->spin_layer->show();
     ui->label_layer->show();
     ui->label_layerinfo->show();
   } else {
+    ui->combo_layerMode->hide();
     ui->spin_layer->hide();
     ui->label_layer->hide();
     ui->label_layerinfo->hide();
@@ -567,7 +586,13 @@ void AddTimeseriesDialog::accept() {
   this->m_inputSeriesName = ui->text_seriesname->text();
   this->m_inputFileColdstart = ui->date_coldstart->dateTime();
   this->m_epsg = ui->spin_epsg->value();
-  this->m_layer = ui->spin_layer->value();
+  if (ui->combo_layerMode->isVisible() &&
+      ui->combo_layerMode->currentIndex() > 0) {
+    this->m_layer = Dflow::profileLayer(static_cast<Dflow::ProfileProduct>(
+        ui->combo_layerMode->currentIndex() - 1));
+  } else {
+    this->m_layer = ui->spin_layer->value();
+  }
   this->m_dflowVariable = ui->combo_variableSelect->currentText();
   this->m_lineStyle = ui->combo_linestyle->currentIndex() + 1;
   TempString = ui->text_unitconvert->text();
@@ -693,13 +718,20 @@ void AddTimeseriesDialog::on_combo_variableSelect_currentIndexChanged(
     const QString &arg1) {
   this->m_dflowVariable = arg1;
   if (this->dflow->variableIs3d(arg1)) {
+    ui->combo_layerMode->show();
     ui->spin_layer->show();
     ui->label_layer->show();
     ui->label_layerinfo->show();
   } else {
+    ui->combo_layerMode->hide();
     ui->spin_layer->hide();
     ui->label_layer->hide();
     ui->label_layerinfo->hide();
   }
   return;
 }
+
+void AddTimeseriesDialog::on_combo_layerMode_currentIndexChanged(int index) {
+  ui->spin_layer->setEnabled(ui->combo_layerMode->isEnabled() && index == 0);
+  return;
+}
@@ -134,6 +134,8 @@ class AddTimeseriesDialog : public QDialog {
 
   void on_combo_variableSelect_currentIndexChanged(const QString &arg1);
 
+  void on_combo_layerMode_currentIndexChanged(int index);
+
  signals:
   void addTimeseriesError(QString);
 
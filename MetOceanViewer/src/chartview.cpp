@@ -27,12 +27,9 @@
 #include <QtGui/QResizeEvent>
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QGraphicsTextItem>
+#include <cmath>
 #include "timezone.h"
 
-bool ChartView::pointXLessThan(const QPointF &p1, const QPointF &p2) {
-  return p1.x() < p2.x();
-}
-
 ChartView::ChartView(QWidget *parent) : QChartView(new QChart(), parent) {
   this->m_coord = new QGraphicsSimpleTextItem(this->chart());
   this->m_yAxis = nullptr;
@@ -148,6 +145,7 @@ void ChartView::clear() {
   if (this->chart()->series().length() > 0) this->chart()->removeAllSeries();
   this->m_legendNames.clear();
   this->m_series.clear();
+  this->m_seriesData.clear();
   this->removeTraceLines();
   return;
 }
@@ -173,7 +171,21 @@ void ChartView::initializeLegendMarkers() {
 }
 
 void ChartView::addSeries(QLineSeries *series, QString name) {
+  this->addSeries(series, name, series->pointsVector());
+  return;
+}
+
+void ChartView::addSeries(QLineSeries *series, QString name,
+                          const QVector<QPointF> &points) {
+  //...The chart only ever holds the points that can be seen at the
+  //   current plot width. The full series is kept here and decimated again
+  //   whenever the visible range changes
+  SeriesDecimator data(points);
+  series->replace(data.decimate(data.xmin(), data.xmax(),
+                                this->plotWidthInPixels()));
+
   this->m_series.push_back(series);
+  this->m_seriesData.push_back(data);
   this->m_legendNames.push_back(name);
 
   this->chart()->addSeries(series);
@@ -186,6 +198,30 @@ void ChartView::addSeries(QLineSeries *series, QString name) {
   return;
 }
 
+void ChartView::shiftSeries(qreal dx) {
+  for (int i = 0; i < this->m_seriesData.length(); i++) {
+    this->m_seriesData[i].shift(dx);
+  }
+  this->updateSeriesResolution();
+  return;
+}
+
+int ChartView::plotWidthInPixels() const {
+  qreal width = this->chart()->plotArea().width();
+  if (width < 1.0) width = this->width();
+  return std::max(static_cast<int>(std::ceil(width)), 1);
+}
+
+void ChartView::updateSeriesResolution() {
+  if (this->current_x_axis_max <= this->current_x_axis_min) return;
+  int pixels = this->plotWidthInPixels();
+  for (int i = 0; i < this->m_series.length(); i++) {
+    this->m_series[i]->replace(this->m_seriesData[i].decimate(
+        this->current_x_axis_min, this->current_x_axis_max, pixels));
+  }
+  return;
+}
+
 void ChartView::rebuild() {
   this->initializeAxisLimits();
   return;
@@ -197,6 +233,7 @@ void ChartView::resizeEvent(QResizeEvent *event) {
     if (this->chart()) {
       this->resetAxisLimits();
       this->chart()->resize(event->size());
+      this->updateSeriesResolution();
       this->m_coord->setPos(this->chart()->size().width() / 2 - 100,
                             this->chart()->size().height() - 20);
       if (this->m_displayValues) {
@@ -259,34 +296,20 @@ void ChartView::addTraceLines(QMouseEvent *event) {
   return;
 }
 
-bool ChartView::getNearestPointToCursor(qreal cursorXPosition, int seriesIndex,
-                                        qreal &x, qreal &y) {
-  QVector<QPointF> pv = this->m_series[seriesIndex]->pointsVector();
-  qreal x_ll = pv.at(0).x();
-  qreal x_ul = pv.last().x();
-
-  if (cursorXPosition >= x_ll && cursorXPosition <= x_ul) {
-    QPointF c = QPointF(cursorXPosition, 0);
-    size_t i_min =
-        std::lower_bound(pv.begin(), pv.end(), c, ChartView::pointXLessThan) -
-        pv.begin();
-    x = pv.at(i_min).x();
-    y = pv.at(i_min).y();
-    return true;
-  } else {
-    return false;
-  }
+bool ChartView::getValueAtCursor(qreal cursorXPosition, int seriesIndex,
+                                 qreal &y) {
+  return this->m_seriesData[seriesIndex].valueAt(cursorXPosition, y);
 }
 
 void ChartView::addLineValuesToLegend(qreal x) {
   for (int i = 0; i < this->m_series.length(); i++) {
-    qreal xv, yv;
-    bool found = this->getNearestPointToCursor(x, i, xv, yv);
+    qreal yv;
+    bool found = this->getValueAtCursor(x, i, yv);
     if (found)
-      this->chart()->series().at(i)->setName(this->m_legendNames.at(i) + ": " +
-                                             QString::number(yv));
+      this->m_series[i]->setName(this->m_legendNames.at(i) + ": " +
+                                 QString::number(yv));
     else
-      this->chart()->series().at(i)->setName(this->m_legendNames.at(i));
+      this->m_series[i]->setName(this->m_legendNames.at(i));
   }
   QDateTime date = QDateTime::fromMSecsSinceEpoch(x);
   QString dateString = QString("Date: ") + date.toString("MM/dd/yyyy hh:mm AP");
@@ -327,7 +350,7 @@ void ChartView::resetPlotLegend() {
   this->m_coord->setText("");
   if (this->m_statusBar) this->m_statusBar->clearMessage();
   for (int i = 0; i < this->m_series.length(); i++)
-    this->chart()->series().at(i)->setName(this->m_legendNames.at(i));
+    this->m_series[i]->setName(this->m_legendNames.at(i));
   this->removeTraceLines();
 }
 
@@ -395,6 +418,7 @@ void ChartView::resetAxisLimits() {
     this->current_x_axis_max = this->chart()->mapToValue(box.topRight()).x();
     this->current_y_axis_min = this->chart()->mapToValue(box.bottomLeft()).y();
     this->current_y_axis_max = this->chart()->mapToValue(box.topRight()).y();
+    this->updateSeriesResolution();
   }
   return;
 }
@@ -467,6 +491,7 @@ void ChartView::initializeAxisLimits() {
   this->current_y_axis_max = this->y_axis_max;
   this->current_x_axis_min = this->x_axis_min;
   this->current_y_axis_min = this->y_axis_min;
+  this->updateSeriesResolution();
   return;
 }
 
@@ -27,6 +27,7 @@
 #include <QValueAxis>
 #include <QtCharts/QChartGlobal>
 #include <QtWidgets>
+#include "seriesdecimator.h"
 
 QT_BEGIN_NAMESPACE
 class QGraphicsScene;
@@ -52,6 +53,9 @@ class ChartView : public QChartView {
   void resetZoom();
   void setStatusBar(QStatusBar *inStatusBar);
   void addSeries(QLineSeries *series, QString name);
+  void addSeries(QLineSeries *series, QString name,
+                 const QVector<QPointF> &points);
+  void shiftSeries(qreal dx);
   void setDisplayValues(bool value);
   void rebuild();
   void clear();
@@ -93,8 +97,8 @@ class ChartView : public QChartView {
 
  private:
   void resetAxisLimits();
-
-  static bool pointXLessThan(const QPointF &p1, const QPointF &p2);
+  void updateSeriesResolution();
+  int plotWidthInPixels() const;
 
   qreal x_axis_min, x_axis_max;
   qreal y_axis_min, y_axis_max;
@@ -103,6 +107,7 @@ class ChartView : public QChartView {
   QStatusBar *m_statusBar;
   QVector<QString> m_legendNames;
   QVector<QLineSeries *> m_series;
+  QVector<SeriesDecimator> m_seriesData;
   QLineF m_yTraceLine;
   QLineF m_xTraceLine;
   QGraphicsItem *m_yTraceLinePtr;
@@ -118,8 +123,7 @@ class ChartView : public QChartView {
   QGraphicsRectItem *m_infoRectItem;
   QGraphicsTextItem *m_infoItem;
 
-  bool getNearestPointToCursor(qreal cursorXPosition, int seriesIndex, qreal &x,
-                               qreal &y);
+  bool getValueAtCursor(qreal cursorXPosition, int seriesIndex, qreal &y);
   bool isOnPlot(qreal x, qreal y);
   void addTraceLines(QMouseEvent *event);
   void addXTraceLine(QMouseEvent *event);
@@ -97,6 +97,7 @@ int Crms::getData() {
   end = end.addDays(1);
   CrmsData *c = new CrmsData(this->m_station, start, end, this->m_header,
                              this->m_map, Generic::crmsDataFile(), this);
+  c->setResolution(this->m_chartView->width());
   int ierr = c->get(this->m_data);
   delete c;
   return ierr;
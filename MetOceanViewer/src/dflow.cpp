@@ -1,9 +1,14 @@
 #include "dflow.h"
 #include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 #include "netcdf.h"
 #include "errors.h"
 #include "hmdf.h"
 #include "metoceanviewer.h"
+#include "timeaxis.h"
 
 Dflow::Dflow(QString filename, QObject *parent) : QObject(parent) {
   this->_isInitialized = false;
@@ -14,6 +19,8 @@ Dflow::Dflow(QString filename, QObject *parent) : QObject(parent) {
   this->_nSteps = 0;
   this->_nStations = 0;
   this->_nLayers = 0;
+  this->_ncid = -1;
+  this->_readBufferSize = 64 * 1024 * 1024;
 
   int ierr = this->_init();
 
@@ -29,6 +36,10 @@ Dflow::Dflow(QString filename, QObject *parent) : QObject(parent) {
   return;
 }
 
+Dflow::~Dflow() {
+  if (this->_ncid >= 0) nc_close(this->_ncid);
+}
+
 bool Dflow::is3d() { return this->_is3d; }
 
 QStringList Dflow::getVaribleList() { return QStringList(this->_plotvarnames); }
@@ -48,197 +59,197 @@ bool Dflow::variableIs3d(QString variable) {
     return false;
 }
 
-int Dflow::_get2DVelocityMagnitude(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
-
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
+//...Fill value used in D-Flow FM history files
+static const double dflowFillValue = -999.0;
 
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
+//...Fused kernels that combine the components of one block of the file in
+//   place into the first component. Each is a single pass over contiguous
+//   memory with the fill value test done as a select so the loops can be
+//   vectorized.
+static void dflowValue(double *const *c, size_t n) {
+  double *out = c[0];
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = out[i] == dflowFillValue ? HmdfStation::nullDataValue() : out[i];
   }
+}
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == HmdfStation::nullDataValue() ||
-          y_data[i][j] == HmdfStation::nullDataValue())
-        data[i][j] = HmdfStation::nullDataValue();
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0));
+//...Sum of squares accumulated in the first component. A fill value in any
+//   component turns the sum into NaN, which becomes the null value
+static void dflowMagnitude(double *const *c, size_t nComponents, size_t n) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  double *out = c[0];
+  for (size_t i = 0; i < n; ++i) {
+    const double v = out[i];
+    out[i] = v == dflowFillValue ? nan : v * v;
+  }
+  for (size_t k = 1; k < nComponents; ++k) {
+    const double *in = c[k];
+    for (size_t i = 0; i < n; ++i) {
+      const double v = in[i];
+      out[i] += v == dflowFillValue ? nan : v * v;
     }
   }
-  return MetOceanViewer::Error::NOERR;
+  for (size_t i = 0; i < n; ++i) {
+    out[i] =
+        out[i] == out[i] ? std::sqrt(out[i]) : HmdfStation::nullDataValue();
+  }
 }
 
-int Dflow::_get2DVelocityDirection(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
-
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
+static void dflowDirection(double *const *c, size_t n) {
+  double *x = c[0];
+  const double *y = c[1];
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = x[i] == dflowFillValue || y[i] == dflowFillValue
+               ? HmdfStation::nullDataValue()
+               : std::atan2(y[i], x[i]) * 180.0 / M_PI;
   }
+}
 
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
+int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
+  if (isProfileLayer(layer))
+    return this->getProfile(variable, profileProduct(layer), hmdf);
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++)
-      if (x_data[i][j] == HmdfStation::nullDataValue() ||
-          y_data[i][j] == HmdfStation::nullDataValue())
-        data[i][j] = HmdfStation::nullDataValue();
-      else
-        data[i][j] = qAtan2(y_data[i][j], x_data[i][j]) * 180.0 / M_PI;
-  }
-  return MetOceanViewer::Error::NOERR;
-}
+  int ierr;
+  QVector<qint64> time;
 
-int Dflow::_get3DVeloctiyMagnitude(int layer, QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data, z_data;
+  ierr = this->_getTime(time);
+  this->error->setErrorCode(ierr);
+  if (this->error->isError()) return this->error->errorCode();
 
-  ierr = this->_getVar(QStringLiteral("x_velocity"), layer, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
+  //...Every station is stored in one arena using the station-major layout
+  //   that the block reader writes
+  QSharedPointer<HmdfArena> arena(new HmdfArena());
+  arena->allocate(this->_nStations * this->_nSteps);
 
-  ierr = this->_getVar(QStringLiteral("y_velocity"), layer, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
+  QStringList components;
+  Kernel kernel;
+  this->_getComponents(variable, components, kernel);
 
-  ierr = this->_getVar(QStringLiteral("z_velocity"), layer, z_data);
+  ierr = this->_getVar(components, layer, kernel, arena->data(0));
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOZVELOCITY);
+    this->error->setErrorCode(ierr);
     return this->error->errorCode();
   }
 
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == HmdfStation::nullDataValue() ||
-          y_data[i][j] == HmdfStation::nullDataValue() ||
-          z_data[i][j] == HmdfStation::nullDataValue())
-        data[i][j] = HmdfStation::nullDataValue();
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0) +
-                           qPow(z_data[i][j], 2.0));
-    }
-  }
+  this->_toHmdf(arena, time, QStringLiteral("DFlowFM"), hmdf);
+
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getWindVelocityMagnitude(QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
-
-  ierr = this->_getVar(QStringLiteral("windx"), 0, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
-  ierr = this->_getVar(QStringLiteral("windy"), 0, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++) {
-      if (x_data[i][j] == HmdfStation::nullDataValue() ||
-          y_data[i][j] == HmdfStation::nullDataValue())
-        data[i][j] = HmdfStation::nullDataValue();
-      else
-        data[i][j] = qSqrt(qPow(x_data[i][j], 2.0) + qPow(y_data[i][j], 2.0));
-    }
+QString Dflow::profileProductName(ProfileProduct product) {
+  switch (product) {
+    case ProfileDepthAverage:
+      return tr("Depth average");
+    case ProfileSurface:
+      return tr("Surface");
+    case ProfileBottom:
+      return tr("Bottom");
+    case ProfileMinimum:
+      return tr("Layer minimum");
+    case ProfileMaximum:
+      return tr("Layer maximum");
+    default:
+      return QString();
   }
-  return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getWindDirection(QVector<QVector<double>> &data) {
-  int ierr, i, j;
-  QVector<QVector<double>> x_data, y_data;
+//...Profile products are stored in the layer number as -1 - product so
+//   they cannot be mistaken for a real layer
+int Dflow::profileLayer(ProfileProduct product) { return -1 - product; }
 
-  ierr = this->_getVar(QStringLiteral("windx"), 0, x_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOXVELOCITY);
-    return this->error->errorCode();
-  }
-  ierr = this->_getVar(QStringLiteral("windy"), 0, y_data);
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_NOYVELOCITY);
-    return this->error->errorCode();
-  }
-  data.resize(this->_nStations);
-  for (i = 0; i < this->_nStations; i++) {
-    data[i].resize(this->_nSteps);
-    for (j = 0; j < this->_nSteps; j++)
-      if (x_data[i][j] == HmdfStation::nullDataValue() ||
-          y_data[i][j] == HmdfStation::nullDataValue())
-        data[i][j] = HmdfStation::nullDataValue();
-      else
-        data[i][j] = qAtan2(y_data[i][j], x_data[i][j]) * 180.0 / M_PI;
-  }
-  return MetOceanViewer::Error::NOERR;
+bool Dflow::isProfileLayer(int layer) {
+  return layer < 0 && layer >= -NumProfileProducts;
 }
 
-int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
-  int i, ierr;
+Dflow::ProfileProduct Dflow::profileProduct(int layer) {
+  return static_cast<ProfileProduct>(-1 - layer);
+}
+
+//...Reads every layer of a 3D variable in one pass and reduces it to one
+//   series per station for the requested product
+int Dflow::getProfile(QString variable, ProfileProduct product, Hmdf *hmdf) {
+  int ierr;
   QVector<qint64> time;
-  QVector<QVector<double>> data;
 
   ierr = this->_getTime(time);
   this->error->setErrorCode(ierr);
   if (this->error->isError()) return this->error->errorCode();
 
-  //...Check for derrived data or just retrieve the
-  //   requested variable
-  if (variable == QStringLiteral("2D_current_speed"))
-    ierr = this->_get2DVelocityMagnitude(layer, data);
-  else if (variable == QStringLiteral("2D_current_direction"))
-    ierr = this->_get2DVelocityDirection(layer, data);
-  else if (variable == QStringLiteral("3D_current_speed"))
-    ierr = this->_get3DVeloctiyMagnitude(layer, data);
-  else if (variable == QStringLiteral("wind_speed"))
-    ierr = this->_getWindVelocityMagnitude(data);
-  else if (variable == QStringLiteral("wind_direction"))
-    ierr = this->_getWindDirection(data);
-  else
-    ierr = this->_getVar(variable, layer, data);
+  QStringList components;
+  Kernel kernel;
+  this->_getComponents(variable, components, kernel);
 
+  //...Directions cannot be averaged or ranked, and 2D variables have no
+  //   profile
+  bool is3d = kernel != KernelDirection;
+  for (auto &c : components) is3d = is3d && this->_nDims.value(c) == 3;
+  if (!is3d) {
+    this->error->setErrorCode(MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION);
+    return this->error->errorCode();
+  }
+
+  QSharedPointer<HmdfArena> arena(new HmdfArena());
+  arena->allocate(this->_nStations * this->_nSteps);
+
+  ierr = this->_getProfile(components, kernel, product, arena->data(0));
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->error->setErrorCode(ierr);
     return this->error->errorCode();
   }
 
+  this->_toHmdf(arena, time, profileProductName(product), hmdf);
+
+  return MetOceanViewer::Error::NOERR;
+}
+
+//...Components read from the file for a variable and how they combine
+void Dflow::_getComponents(const QString &variable, QStringList &components,
+                           Kernel &kernel) {
+  QStringList velocity2d = {QStringLiteral("x_velocity"),
+                            QStringLiteral("y_velocity")};
+  QStringList velocity3d = {QStringLiteral("x_velocity"),
+                            QStringLiteral("y_velocity"),
+                            QStringLiteral("z_velocity")};
+  QStringList wind = {QStringLiteral("windx"), QStringLiteral("windy")};
+
+  //...Check for derrived data or just retrieve the
+  //   requested variable
+  if (variable == QStringLiteral("2D_current_speed")) {
+    components = velocity2d;
+    kernel = KernelMagnitude;
+  } else if (variable == QStringLiteral("2D_current_direction")) {
+    components = velocity2d;
+    kernel = KernelDirection;
+  } else if (variable == QStringLiteral("3D_current_speed")) {
+    components = velocity3d;
+    kernel = KernelMagnitude;
+  } else if (variable == QStringLiteral("wind_speed")) {
+    components = wind;
+    kernel = KernelMagnitude;
+  } else if (variable == QStringLiteral("wind_direction")) {
+    components = wind;
+    kernel = KernelDirection;
+  } else {
+    components = QStringList(variable);
+    kernel = KernelValue;
+  }
+}
+
+void Dflow::_toHmdf(QSharedPointer<HmdfArena> arena,
+                    const QVector<qint64> &time, const QString &header,
+                    Hmdf *hmdf) {
   hmdf->setSuccess(false);
   hmdf->setDatum("dflowfm_datum");
   hmdf->setHeader1("DFlowFM");
-  hmdf->setHeader2("DFlowFM");
+  hmdf->setHeader2(header);
   hmdf->setHeader3("DFlowFM");
 
-  for (i = 0; i < this->_nStations; i++) {
+  for (size_t i = 0; i < this->_nStations; i++) {
+    const size_t offset = i * this->_nSteps;
+    std::copy(time.constBegin(), time.constEnd(), arena->date(offset));
+
     HmdfStation *station = new HmdfStation(hmdf);
-    station->setDate(time);
-    station->setData(data[i]);
+    station->setStorage(arena, offset, this->_nSteps);
     station->setLatitude(this->_yCoordinates[i]);
     station->setLongitude(this->_xCoordinates[i]);
     station->setStationIndex(i);
@@ -247,13 +258,28 @@ int Dflow::getVariable(QString variable, int layer, Hmdf *hmdf) {
     hmdf->addStation(station);
   }
   hmdf->setSuccess(true);
+}
 
-  return MetOceanViewer::Error::NOERR;
+int Dflow::_ncError(int ierr) {
+  this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
+  this->error->setNcErrorCode(ierr);
+  return MetOceanViewer::Error::NETCDF;
 }
 
+//...The file is opened once and the handle is shared by every read until
+//   the object is destroyed
 int Dflow::_init() {
   int ierr;
 
+  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE,
+                 &this->_ncid);
+  if (ierr != NC_NOERR) {
+    this->_ncid = -1;
+    this->error->setNcErrorCode(ierr);
+    this->error->setErrorCode(MetOceanViewer::Error::CANNOT_OPEN_FILE);
+    return this->error->errorCode();
+  }
+
   ierr = this->_getPlottingVariables();
   if (ierr != MetOceanViewer::Error::NOERR) {
     this->error->setErrorCode(MetOceanViewer::Error::DFLOW_GETPLOTVARS);
@@ -270,7 +296,7 @@ int Dflow::_init() {
 }
 
 int Dflow::_get3d() {
-  int ierr, ncid;
+  int ierr;
   size_t nLayers;
 
   if (this->_dimnames.contains("laydimw"))
@@ -280,26 +306,8 @@ int Dflow::_get3d() {
     return MetOceanViewer::Error::NOERR;
   }
 
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = nc_inq_dimlen(ncid, this->_dimnames["laydim"], &nLayers);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  ierr = nc_inq_dimlen(this->_ncid, this->_dimnames["laydim"], &nLayers);
+  if (ierr != NC_NOERR) return this->_ncError(ierr);
 
   this->_nLayers = (int)nLayers;
 
@@ -307,31 +315,22 @@ int Dflow::_get3d() {
 }
 
 int Dflow::_getPlottingVariables() {
-  int ncid, nvar, ndim;
+  int nvar, ndim;
   int nd;
   int i, ierr;
   QString sname;
 
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
+  ierr = nc_inq_nvars(this->_ncid, &nvar);
   this->error->setNcErrorCode(ierr);
   if (this->error->isNcError()) {
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
     return this->error->errorCode();
   }
 
-  ierr = nc_inq_nvars(ncid, &nvar);
+  ierr = nc_inq_ndims(this->_ncid, &ndim);
   this->error->setNcErrorCode(ierr);
   if (this->error->isNcError()) {
     this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    ierr = nc_close(ncid);
-    return this->error->errorCode();
-  }
-
-  ierr = nc_inq_ndims(ncid, &ndim);
-  this->error->setNcErrorCode(ierr);
-  if (this->error->isNcError()) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    ierr = nc_close(ncid);
     return this->error->errorCode();
   }
 
@@ -339,13 +338,12 @@ int Dflow::_getPlottingVariables() {
   int *dims = new int[NC_MAX_DIMS];
 
   for (i = 0; i < ndim; i++) {
-    ierr = nc_inq_dimname(ncid, i, varname);
+    ierr = nc_inq_dimname(this->_ncid, i, varname);
     if (ierr != NC_NOERR) {
       delete[] varname;
       delete[] dims;
       this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
       this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
       return MetOceanViewer::Error::NETCDF;
     }
     sname = QString(varname);
@@ -353,36 +351,33 @@ int Dflow::_getPlottingVariables() {
   }
 
   for (i = 0; i < nvar; i++) {
-    ierr = nc_inq_varname(ncid, i, varname);
+    ierr = nc_inq_varname(this->_ncid, i, varname);
     if (ierr != NC_NOERR) {
       delete[] varname;
       delete[] dims;
       this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
       this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
       return MetOceanViewer::Error::NETCDF;
     }
     sname = QString(varname);
 
-    ierr = nc_inq_varndims(ncid, i, &nd);
+    ierr = nc_inq_varndims(this->_ncid, i, &nd);
     if (ierr != NC_NOERR) {
       delete[] varname;
       delete[] dims;
       this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
       this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
       return MetOceanViewer::Error::NETCDF;
     }
 
     this->_nDims[sname] = (int)nd;
 
-    ierr = nc_inq_vardimid(ncid, i, dims);
+    ierr = nc_inq_vardimid(this->_ncid, i, dims);
     if (ierr != NC_NOERR) {
       delete[] varname;
       delete[] dims;
       this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
       this->error->setNcErrorCode(ierr);
-      ierr = nc_close(ncid);
       return MetOceanViewer::Error::NETCDF;
     }
 
@@ -406,13 +401,6 @@ int Dflow::_getPlottingVariables() {
   delete[] varname;
   delete[] dims;
 
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
   ierr = this->_get3d();
   if (ierr != MetOceanViewer::Error::NOERR)
     return MetOceanViewer::Error::DFLOW_3DVARS;
@@ -442,24 +430,21 @@ int Dflow::_getPlottingVariables() {
 int Dflow::_getStations() {
   size_t nstation, name_len;
 
-  int ncid, varid_xcoor, varid_ycoor, varid_namevar;
+  int varid_xcoor, varid_ycoor, varid_namevar;
   int dimid_nsta, dimid_namelen;
-  int ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != 0) {
-    return MetOceanViewer::Error::CANNOT_OPEN_FILE;
-  }
+  int ierr = 0;
 
-  ierr += nc_inq_dimid(ncid, "stations", &dimid_nsta);
-  ierr += nc_inq_dimid(ncid, "name_len", &dimid_namelen);
-  ierr += nc_inq_varid(ncid, "station_x_coordinate", &varid_xcoor);
-  ierr += nc_inq_varid(ncid, "station_y_coordinate", &varid_ycoor);
-  ierr += nc_inq_varid(ncid, "station_name", &varid_namevar);
+  ierr += nc_inq_dimid(this->_ncid, "stations", &dimid_nsta);
+  ierr += nc_inq_dimid(this->_ncid, "name_len", &dimid_namelen);
+  ierr += nc_inq_varid(this->_ncid, "station_x_coordinate", &varid_xcoor);
+  ierr += nc_inq_varid(this->_ncid, "station_y_coordinate", &varid_ycoor);
+  ierr += nc_inq_varid(this->_ncid, "station_name", &varid_namevar);
   if (ierr != 0) {
     return MetOceanViewer::Error::DFLOW_FILEREADERROR;
   }
 
-  ierr += nc_inq_dimlen(ncid, dimid_nsta, &nstation);
-  ierr += nc_inq_dimlen(ncid, dimid_namelen, &name_len);
+  ierr += nc_inq_dimlen(this->_ncid, dimid_nsta, &nstation);
+  ierr += nc_inq_dimlen(this->_ncid, dimid_namelen, &name_len);
   if (ierr != 0) {
     return MetOceanViewer::Error::DFLOW_FILEREADERROR;
   }
@@ -473,7 +458,7 @@ int Dflow::_getStations() {
   this->_yCoordinates.resize(this->_nStations);
   this->_stationNames.resize(this->_nStations);
 
-  ierr += nc_get_var_text(ncid, varid_namevar, stationName);
+  ierr += nc_get_var_text(this->_ncid, varid_namevar, stationName);
   if (ierr != 0) {
     delete[] xcoor;
     delete[] ycoor;
@@ -488,8 +473,8 @@ int Dflow::_getStations() {
     delete[] n;
   }
 
-  ierr += nc_get_var(ncid, varid_xcoor, xcoor);
-  ierr += nc_get_var(ncid, varid_ycoor, ycoor);
+  ierr += nc_get_var(this->_ncid, varid_xcoor, xcoor);
+  ierr += nc_get_var(this->_ncid, varid_ycoor, ycoor);
   if (ierr != 0) {
     delete[] xcoor;
     delete[] ycoor;
@@ -502,8 +487,6 @@ int Dflow::_getStations() {
     this->_yCoordinates[i] = ycoor[i];
   }
 
-  nc_close(ncid);
-
   delete[] xcoor;
   delete[] ycoor;
   delete[] stationName;
@@ -512,197 +495,210 @@ int Dflow::_getStations() {
 }
 
 int Dflow::_getTime(QVector<qint64> &timeList) {
-  int i, ierr, ncid;
+  int ierr;
   size_t nsteps, unitsLen;
-  double *time;
   int varid_time = this->_varnames["time"];
   int dimid_time = this->_dimnames["time"];
-  char *units = strdup("units");
-  QString refString;
-
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    delete[] units;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  ierr = nc_inq_dimlen(ncid, dimid_time, &nsteps);
-  if (ierr != NC_NOERR) {
-    delete[] units;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
 
-  ierr = nc_inq_attlen(ncid, varid_time, units, &unitsLen);
-  if (ierr != NC_NOERR) {
-    delete[] units;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
-
-  char *refstring = new char[unitsLen];
+  ierr = nc_inq_dimlen(this->_ncid, dimid_time, &nsteps);
+  if (ierr != NC_NOERR) return this->_ncError(ierr);
 
-  ierr = nc_get_att(ncid, varid_time, units, refstring);
-  if (ierr != NC_NOERR) {
-    delete[] units;
-    delete[] refstring;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  ierr = nc_inq_attlen(this->_ncid, varid_time, "units", &unitsLen);
+  if (ierr != NC_NOERR) return this->_ncError(ierr);
 
-  refString = QString(refstring);
-  refString = refString.mid(0, (int)unitsLen).right(19);
-  delete[] units;
-  delete[] refstring;
+  std::vector<char> refstring(unitsLen + 1, '\0');
+  ierr = nc_get_att_text(this->_ncid, varid_time, "units", refstring.data());
+  if (ierr != NC_NOERR) return this->_ncError(ierr);
 
+  QString refString = QString(refstring.data()).right(19);
   this->_refTime =
       QDateTime::fromString(refString, QStringLiteral("yyyy-MM-dd hh:mm:ss"));
   this->_refTime.setTimeSpec(Qt::UTC);
 
+  std::vector<double> time(nsteps);
   timeList.resize(nsteps);
-  time = new double[nsteps];
   this->_nSteps = nsteps;
 
-  ierr = nc_get_var_double(ncid, varid_time, time);
-  if (ierr != NC_NOERR) {
-    delete[] time;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
+  if (nsteps > 0) {
+    ierr = nc_get_var_double(this->_ncid, varid_time, time.data());
+    if (ierr != NC_NOERR) return this->_ncError(ierr);
   }
 
-  for (i = 0; i < this->_nSteps; i++)
-    timeList[i] =
-        this->_refTime.addMSecs(qRound64(time[i] * 1000.0)).toMSecsSinceEpoch();
-
-  delete[] time;
+  TimeAxis::toMSecsSinceEpoch(this->_refTime.toMSecsSinceEpoch(), 1000.0,
+                              time.data(), nsteps, timeList.data());
 
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getVar(QString variable, int layer,
-                   QVector<QVector<double>> &data) {
-  if (this->_nDims[variable] == 2)
-    return this->_getVar2D(variable, data);
-  else if (this->_nDims[variable] == 3)
-    return this->_getVar3D(variable, layer, data);
-  else
-    return MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION;
-}
+//...Reads the requested components in blocks of time snaps covering every
+//   station. The number of snaps in a block keeps the read buffers within
+//   _readBufferSize bytes. Each block is combined by the kernel in place
+//   and then transposed a tile at a time into the station-major output
+//   data[station * nSteps + snap].
+int Dflow::_getVar(const QStringList &components, int layer, Kernel kernel,
+                   double *data) {
+  const size_t nComponents = static_cast<size_t>(components.size());
 
-int Dflow::_getVar2D(QString variable, QVector<QVector<double>> &data) {
-  int ierr, ncid, varid;
-  double *d = new double[this->_nSteps * this->_nStations];
-  size_t *start = new size_t[2];
-  size_t *count = new size_t[2];
+  QVector<int> varid;
+  int ierr = this->_getVarids(components, kernel, varid);
+  if (ierr != MetOceanViewer::Error::NOERR) return ierr;
 
-  data.resize(this->_nStations);
-  for (size_t i = 0; i < this->_nStations; i++) data[i].resize(this->_nSteps);
+  if (this->_nStations == 0 || this->_nSteps == 0)
+    return MetOceanViewer::Error::NOERR;
 
-  varid = this->_varnames[variable];
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    delete[] start;
-    delete[] count;
-    delete[] d;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  const size_t tile = 64;
+  const size_t nStations = this->_nStations;
+  const size_t bytesPerSnap = nStations * sizeof(double) * nComponents;
+  const size_t snapsPerBlock = std::max<size_t>(
+      1, std::min(this->_nSteps, this->_readBufferSize / bytesPerSnap));
 
-  start[0] = 0;
-  start[1] = 0;
-  count[0] = this->_nSteps;
-  count[1] = this->_nStations;
-  ierr = nc_get_vara_double(ncid, varid, start, count, d);
-  if (ierr != NC_NOERR) {
-    delete[] start;
-    delete[] count;
-    delete[] d;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  std::vector<std::vector<double>> buffer(
+      nComponents, std::vector<double>(snapsPerBlock * nStations));
+  std::vector<double *> c(nComponents);
+  for (size_t k = 0; k < nComponents; ++k) c[k] = buffer[k].data();
 
-  for (size_t i = 0; i < this->_nSteps; i++)
-    for (size_t j = 0; j < this->_nStations; j++) {
-      if (d[i * this->_nStations + j] == -999.0)
-        data[j][i] = HmdfStation::nullDataValue();
-      else
-        data[j][i] = d[i * this->_nStations + j];
-    }
+  for (size_t t0 = 0; t0 < this->_nSteps; t0 += snapsPerBlock) {
+    const size_t nt = std::min(snapsPerBlock, this->_nSteps - t0);
+    const size_t n = nt * nStations;
 
-  delete[] start;
-  delete[] count;
-  delete[] d;
+    for (size_t k = 0; k < nComponents; ++k) {
+      int ierr = this->_readBlock(varid[k], layer, t0, nt, c[k]);
+      if (ierr != NC_NOERR) return this->_ncError(ierr);
+    }
 
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
+    if (kernel == KernelMagnitude)
+      dflowMagnitude(c.data(), nComponents, n);
+    else if (kernel == KernelDirection)
+      dflowDirection(c.data(), n);
+    else
+      dflowValue(c.data(), n);
+
+    const double *v = c[0];
+    for (size_t sb = 0; sb < nStations; sb += tile) {
+      const size_t se = std::min(sb + tile, nStations);
+      for (size_t tb = 0; tb < nt; tb += tile) {
+        const size_t te = std::min(tb + tile, nt);
+        for (size_t i = sb; i < se; ++i) {
+          double *out = data + i * this->_nSteps + t0;
+          for (size_t j = tb; j < te; ++j) out[j] = v[j * nStations + i];
+        }
+      }
+    }
   }
 
   return MetOceanViewer::Error::NOERR;
 }
 
-int Dflow::_getVar3D(QString variable, int layer,
-                     QVector<QVector<double>> &data) {
-  int ierr, ncid, varid;
-  double *d = new double[this->_nSteps * this->_nStations];
-  size_t *start = new size_t[3];
-  size_t *count = new size_t[3];
-
-  data.resize(this->_nStations);
-  for (size_t i = 0; i < this->_nStations; i++) data[i].resize(this->_nSteps);
-
-  varid = this->_varnames[variable];
-  ierr = nc_open(this->_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  if (ierr != NC_NOERR) {
-    delete[] start;
-    delete[] count;
-    delete[] d;
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+//...Reads the same profile block for every component and reduces each
+//   station's layers into the requested product in one sweep. Layer 1 is
+//   the bottom of the water column. Layers holding the fill value (e.g.
+//   below the bed in z-layer models) are skipped, so the surface and bottom
+//   are the highest and lowest wet layers. The depth average is the mean of
+//   the wet layers, which assumes layers of equal thickness (sigma layers).
+int Dflow::_getProfile(const QStringList &components, Kernel kernel,
+                       ProfileProduct product, double *data) {
+  const size_t nComponents = static_cast<size_t>(components.size());
+
+  QVector<int> varid;
+  int ierr = this->_getVarids(components, kernel, varid);
+  if (ierr != MetOceanViewer::Error::NOERR) return ierr;
+
+  if (this->_nStations == 0 || this->_nSteps == 0 || this->_nLayers == 0)
+    return MetOceanViewer::Error::NOERR;
 
-  start[0] = 0;
-  start[1] = 0;
-  start[2] = layer - 1;
-  count[0] = this->_nSteps;
-  count[1] = this->_nStations;
-  count[2] = 1;
-  ierr = nc_get_vara_double(ncid, varid, start, count, d);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
-  }
+  const double null = HmdfStation::nullDataValue();
+  const size_t nStations = this->_nStations;
+  const size_t nLayers = this->_nLayers;
+  const size_t bytesPerSnap =
+      nStations * nLayers * sizeof(double) * nComponents;
+  const size_t snapsPerBlock = std::max<size_t>(
+      1, std::min(this->_nSteps, this->_readBufferSize / bytesPerSnap));
+
+  std::vector<std::vector<double>> buffer(
+      nComponents, std::vector<double>(snapsPerBlock * nStations * nLayers));
+  std::vector<double *> c(nComponents);
+  for (size_t k = 0; k < nComponents; ++k) c[k] = buffer[k].data();
+
+  for (size_t t0 = 0; t0 < this->_nSteps; t0 += snapsPerBlock) {
+    const size_t nt = std::min(snapsPerBlock, this->_nSteps - t0);
+    const size_t n = nt * nStations * nLayers;
+
+    for (size_t k = 0; k < nComponents; ++k) {
+      ierr = this->_readBlock(varid[k], AllLayers, t0, nt, c[k]);
+      if (ierr != NC_NOERR) return this->_ncError(ierr);
+    }
 
-  for (size_t i = 0; i < this->_nSteps; i++)
-    for (size_t j = 0; j < this->_nStations; j++) {
-      if (d[i * this->_nStations + j] == -999.0)
-        data[j][i] = HmdfStation::nullDataValue();
-      else
-        data[j][i] = d[i * this->_nStations + j];
+    if (kernel == KernelMagnitude)
+      dflowMagnitude(c.data(), nComponents, n);
+    else
+      dflowValue(c.data(), n);
+
+    for (size_t i = 0; i < nStations; ++i) {
+      const size_t out = i * this->_nSteps + t0;
+      for (size_t j = 0; j < nt; ++j) {
+        const double *v = c[0] + (j * nStations + i) * nLayers;
+        double sum = 0.0, minimum = null, maximum = null;
+        double bottom = null, surface = null;
+        size_t wet = 0;
+        for (size_t l = 0; l < nLayers; ++l) {
+          if (v[l] == null) continue;
+          if (wet == 0) {
+            bottom = minimum = maximum = v[l];
+          } else {
+            minimum = std::min(minimum, v[l]);
+            maximum = std::max(maximum, v[l]);
+          }
+          surface = v[l];
+          sum += v[l];
+          wet++;
+        }
+        double value[NumProfileProducts];
+        value[ProfileDepthAverage] = wet > 0 ? sum / wet : null;
+        value[ProfileSurface] = surface;
+        value[ProfileBottom] = bottom;
+        value[ProfileMinimum] = minimum;
+        value[ProfileMaximum] = maximum;
+        data[out + j] = value[product];
+      }
     }
+  }
 
-  delete[] start;
-  delete[] count;
-  delete[] d;
+  return MetOceanViewer::Error::NOERR;
+}
 
-  ierr = nc_close(ncid);
-  if (ierr != NC_NOERR) {
-    this->error->setErrorCode(MetOceanViewer::Error::NETCDF);
-    this->error->setNcErrorCode(ierr);
-    return MetOceanViewer::Error::NETCDF;
+//...Looks up the file variables behind the components of a product
+int Dflow::_getVarids(const QStringList &components, Kernel kernel,
+                      QVector<int> &varid) {
+  static const int missing[3] = {MetOceanViewer::Error::DFLOW_NOXVELOCITY,
+                                 MetOceanViewer::Error::DFLOW_NOYVELOCITY,
+                                 MetOceanViewer::Error::DFLOW_NOZVELOCITY};
+  const bool derived = kernel != KernelValue;
+
+  varid.resize(components.size());
+  for (int k = 0; k < components.size(); ++k) {
+    const QString &name = components[k];
+    if (!this->_varnames.contains(name))
+      return derived ? missing[k] : MetOceanViewer::Error::DFLOW_VARNOTFOUND;
+    if (this->_nDims[name] != 2 && this->_nDims[name] != 3)
+      return derived ? missing[k]
+                     : MetOceanViewer::Error::DFLOW_ILLEGALDIMENSION;
+    varid[k] = static_cast<int>(this->_varnames[name]);
   }
-
   return MetOceanViewer::Error::NOERR;
 }
+
+//...Reads nt snaps of every station starting at snap t0. Variables with a
+//   layer dimension are read at the requested (one based) layer, or with
+//   every layer when layer is AllLayers
+int Dflow::_readBlock(int varid, int layer, size_t t0, size_t nt,
+                      double *buffer) {
+  int ndims;
+  int ierr = nc_inq_varndims(this->_ncid, varid, &ndims);
+  if (ierr != NC_NOERR) return ierr;
+  if (ndims != 2 && ndims != 3) return NC_EINVALCOORDS;
+
+  size_t start[3] = {t0, 0, layer > 0 ? static_cast<size_t>(layer - 1) : 0};
+  size_t count[3] = {nt, this->_nStations, 1};
+  if (layer == AllLayers) count[2] = this->_nLayers;
+  return nc_get_vara_double(this->_ncid, varid, start, count, buffer);
+}
@@ -13,6 +13,7 @@ class Dflow : public QObject {
   Q_OBJECT
  public:
   explicit Dflow(QString filename, QObject *parent = nullptr);
+  ~Dflow();
 
   QStringList getVaribleList();
 
@@ -22,6 +23,25 @@ class Dflow : public QObject {
 
   int getVariable(QString variable, int layer, Hmdf *hmdf);
 
+  //...Series derived from every layer of a 3D variable
+  enum ProfileProduct {
+    ProfileDepthAverage,
+    ProfileSurface,
+    ProfileBottom,
+    ProfileMinimum,
+    ProfileMaximum,
+    NumProfileProducts
+  };
+
+  static QString profileProductName(ProfileProduct product);
+
+  //...Layer numbers below 1 passed to getVariable select a profile product
+  static int profileLayer(ProfileProduct product);
+  static bool isProfileLayer(int layer);
+  static ProfileProduct profileProduct(int layer);
+
+  int getProfile(QString variable, ProfileProduct product, Hmdf *hmdf);
+
   int getNumLayers();
 
   bool is3d();
@@ -31,20 +51,32 @@ class Dflow : public QObject {
   Errors *error;
 
  private:
+  //...How the components of a variable are combined into one value
+  enum Kernel { KernelValue, KernelMagnitude, KernelDirection };
+
+  //...Layer argument of _readBlock selecting the full profile
+  static const int AllLayers = -1;
+
   int _init();
   int _getPlottingVariables();
   int _getStations();
   int _get3d();
   int _getTime(QVector<qint64> &timeList);
-  int _getVar(QString variable, int layer, QVector<QVector<double>> &data);
-  int _getVar2D(QString variable, QVector<QVector<double>> &data);
-  int _getVar3D(QString variable, int layer, QVector<QVector<double>> &data);
-  int _get2DVelocityMagnitude(int layer, QVector<QVector<double>> &data);
-  int _get2DVelocityDirection(int layer, QVector<QVector<double>> &data);
-  int _get3DVeloctiyMagnitude(int layer, QVector<QVector<double>> &data);
-  int _getWindVelocityMagnitude(QVector<QVector<double>> &data);
-  int _getWindDirection(QVector<QVector<double>> &data);
+  void _getComponents(const QString &variable, QStringList &components,
+                      Kernel &kernel);
+  int _getVarids(const QStringList &components, Kernel kernel,
+                 QVector<int> &varid);
+  int _getVar(const QStringList &components, int layer, Kernel kernel,
+              double *data);
+  int _getProfile(const QStringList &components, Kernel kernel,
+                  ProfileProduct product, double *data);
+  void _toHmdf(QSharedPointer<HmdfArena> arena, const QVector<qint64> &time,
+               const QString &header, Hmdf *hmdf);
+  int _readBlock(int varid, int layer, size_t t0, size_t nt, double *buffer);
+  int _ncError(int ierr);
 
+  int _ncid;
+  size_t _readBufferSize;
   bool _isInitialized;
   bool _readError;
   bool _is3d;
@@ -113,6 +113,8 @@ class MainWindow : public QMainWindow {
 
   void on_button_processTimeseriesData_clicked();
 
+  void userTimeseriesProcessed(int ierr);
+
   void on_check_TimeseriesAllData_toggled(bool checked);
 
   void on_button_fitHWM_clicked();
@@ -46,7 +46,8 @@ enum _error {
   BUILDSTATIONLIST,
   BUILDREVISEDIMEDS,
   PROJECTSTATIONS,
-  MARKERSELECTION
+  MARKERSELECTION,
+  PROCESSINGCANCELED
 };
 };
 } // namespace MetOceanViewer
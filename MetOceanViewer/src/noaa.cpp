@@ -465,22 +465,7 @@ int Noaa::replotChart(Timezone *newTimezone) {
   int offset = newTimezone->utcOffset() * 1000;
   int totalOffset = -this->m_priorOffsetSeconds + offset;
 
-  QVector<QLineSeries *> series;
-  series.resize(this->m_chartView->chart()->series().length());
-
-  for (size_t i = 0; i < this->m_chartView->chart()->series().length(); i++) {
-    series[i] =
-        static_cast<QLineSeries *>(this->m_chartView->chart()->series().at(i));
-  }
-
-  for (size_t i = 0; i < series.length(); i++) {
-    QList<QPointF> data = series[i]->points();
-    series[i]->clear();
-    for (size_t j = 0; j < data.length(); j++) {
-      data[j].setX(data[j].x() + totalOffset);
-    }
-    series[i]->append(data);
-  }
+  this->m_chartView->shiftSeries(totalOffset);
 
   QDateTime minDateTime = this->m_startDateEdit->dateTime();
   QDateTime maxDateTime = this->m_endDateEdit->dateTime();
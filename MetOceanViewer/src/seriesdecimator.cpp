@@ -0,0 +1,251 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "seriesdecimator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+//...Full resolution points are stored as separate x and y arrays while
+//   pyramid levels are stored as points. These give the decimation code
+//   one way of reading both
+struct ArrayPoints {
+  const qreal *x;
+  const qreal *y;
+  int size;
+  qreal xAt(int i) const { return x[i]; }
+  qreal yAt(int i) const { return y[i]; }
+  QPointF at(int i) const { return QPointF(x[i], y[i]); }
+};
+
+struct LevelPoints {
+  const QPointF *p;
+  int size;
+  qreal xAt(int i) const { return p[i].x(); }
+  qreal yAt(int i) const { return p[i].y(); }
+  QPointF at(int i) const { return p[i]; }
+};
+
+template <typename Points>
+int lowerBound(const Points &points, qreal x) {
+  int first = 0, count = points.size;
+  while (count > 0) {
+    int step = count / 2;
+    if (points.xAt(first + step) < x) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+template <typename Points>
+int upperBound(const Points &points, qreal x) {
+  int first = 0, count = points.size;
+  while (count > 0) {
+    int step = count / 2;
+    if (!(x < points.xAt(first + step))) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+template <typename Points>
+void window(const Points &points, qreal xmin, qreal xmax, int &first,
+            int &last) {
+  //...Keep one point either side so the line runs off the edge of the plot
+  first = std::max(lowerBound(points, xmin) - 1, 0);
+  last = std::min(upperBound(points, xmax) + 1, points.size);
+}
+
+template <typename Points>
+void extremes(const Points &points, int first, int last, int &lo, int &hi) {
+  lo = first;
+  hi = first;
+  for (int j = first + 1; j < last; ++j) {
+    if (points.yAt(j) < points.yAt(lo)) lo = j;
+    if (points.yAt(j) > points.yAt(hi)) hi = j;
+  }
+}
+
+template <typename Points>
+QVector<QPointF> slice(const Points &points, int first, int last) {
+  QVector<QPointF> out;
+  out.reserve(last - first);
+  for (int i = first; i < last; ++i) out.push_back(points.at(i));
+  return out;
+}
+
+template <typename Points>
+QVector<QPointF> minMaxPerPixel(const Points &points, int first, int last,
+                                qreal xmin, qreal xmax, int pixels) {
+  QVector<QPointF> out;
+  out.reserve(4 * (pixels + 2));
+
+  const qreal scale = pixels / (xmax - xmin);
+  int i = first;
+  while (i < last) {
+    const qreal column = std::floor((points.xAt(i) - xmin) * scale);
+    int j = i + 1;
+    while (j < last && std::floor((points.xAt(j) - xmin) * scale) == column)
+      ++j;
+    int lo, hi;
+    extremes(points, i, j, lo, hi);
+
+    //...First, extremes and last of the column, in time order
+    const int keep[4] = {i, std::min(lo, hi), std::max(lo, hi), j - 1};
+    int previous = -1;
+    for (int k : keep) {
+      if (k != previous) out.push_back(points.at(k));
+      previous = k;
+    }
+    i = j;
+  }
+  return out;
+}
+
+template <typename Points>
+QVector<QPointF> halve(const Points &points) {
+  QVector<QPointF> level;
+  level.reserve(points.size / 2 + 2);
+  for (int i = 0; i < points.size; i += 4) {
+    int lo, hi;
+    extremes(points, i, std::min(i + 4, points.size), lo, hi);
+    level.push_back(points.at(std::min(lo, hi)));
+    if (lo != hi) level.push_back(points.at(std::max(lo, hi)));
+  }
+  return level;
+}
+
+template <typename Points>
+QVector<QPointF> decimateLevel(const Points &points, int first, int last,
+                               qreal xmin, qreal xmax, int pixels) {
+  if (last - first <= 4 * pixels || !(xmax > xmin)) {
+    return slice(points, first, last);
+  }
+  return minMaxPerPixel(points, first, last, xmin, xmax, pixels);
+}
+}  // namespace
+
+SeriesDecimator::SeriesDecimator() {}
+
+SeriesDecimator::SeriesDecimator(const QVector<QPointF> &points) {
+  auto xLessThan = [](const QPointF &p1, const QPointF &p2) {
+    return p1.x() < p2.x();
+  };
+
+  QVector<QPointF> sorted;
+  const QVector<QPointF> *source = &points;
+  if (!std::is_sorted(points.begin(), points.end(), xLessThan)) {
+    sorted = points;
+    std::stable_sort(sorted.begin(), sorted.end(), xLessThan);
+    source = &sorted;
+  }
+
+  this->m_x.resize(source->size());
+  this->m_y.resize(source->size());
+  for (int i = 0; i < source->size(); ++i) {
+    this->m_x[i] = (*source)[i].x();
+    this->m_y[i] = (*source)[i].y();
+  }
+
+  this->buildPyramid();
+}
+
+void SeriesDecimator::buildPyramid() {
+  const int minimumLevelSize = 64;
+
+  if (this->m_x.size() <= minimumLevelSize) return;
+  ArrayPoints base = {this->m_x.constData(), this->m_y.constData(),
+                      this->m_x.size()};
+  this->m_levels.push_back(halve(base));
+
+  while (this->m_levels.last().size() > minimumLevelSize) {
+    const QVector<QPointF> &below = this->m_levels.last();
+    LevelPoints points = {below.constData(), below.size()};
+    QVector<QPointF> level = halve(points);
+    this->m_levels.push_back(level);
+  }
+}
+
+int SeriesDecimator::size() const { return this->m_x.size(); }
+
+qreal SeriesDecimator::xmin() const {
+  return this->m_x.isEmpty() ? 0.0 : this->m_x.first();
+}
+
+qreal SeriesDecimator::xmax() const {
+  return this->m_x.isEmpty() ? 0.0 : this->m_x.last();
+}
+
+void SeriesDecimator::shift(qreal dx) {
+  for (qreal &x : this->m_x) {
+    x += dx;
+  }
+  for (QVector<QPointF> &level : this->m_levels) {
+    for (QPointF &p : level) {
+      p.setX(p.x() + dx);
+    }
+  }
+}
+
+bool SeriesDecimator::valueAt(qreal x, qreal &y) const {
+  if (this->m_x.isEmpty() || x < this->m_x.first() || x > this->m_x.last())
+    return false;
+
+  ArrayPoints points = {this->m_x.constData(), this->m_y.constData(),
+                        this->m_x.size()};
+  const int i = lowerBound(points, x);
+  if (i == 0 || this->m_x[i] == x) {
+    y = this->m_y[i];
+  } else {
+    const qreal w = (x - this->m_x[i - 1]) / (this->m_x[i] - this->m_x[i - 1]);
+    y = this->m_y[i - 1] + w * (this->m_y[i] - this->m_y[i - 1]);
+  }
+  return true;
+}
+
+QVector<QPointF> SeriesDecimator::decimate(qreal xmin, qreal xmax,
+                                           int pixels) const {
+  pixels = std::max(pixels, 1);
+
+  int first, last;
+  ArrayPoints base = {this->m_x.constData(), this->m_y.constData(),
+                      this->m_x.size()};
+  window(base, xmin, xmax, first, last);
+  if (last - first <= 8 * pixels || this->m_levels.isEmpty()) {
+    return decimateLevel(base, first, last, xmin, xmax, pixels);
+  }
+
+  //...Step up the pyramid while the window has more than twice the points
+  //   the plot can show
+  LevelPoints points;
+  for (const QVector<QPointF> &level : this->m_levels) {
+    points = {level.constData(), level.size()};
+    window(points, xmin, xmax, first, last);
+    if (last - first <= 8 * pixels) break;
+  }
+  return decimateLevel(points, first, last, xmin, xmax, pixels);
+}
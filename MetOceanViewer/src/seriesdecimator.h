@@ -0,0 +1,61 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef SERIESDECIMATOR_H
+#define SERIESDECIMATOR_H
+
+#include <QPointF>
+#include <QVector>
+
+//...Holds the full resolution points of a chart series and reduces them to
+//   what can actually be drawn for a given x range and plot width. Each
+//   pixel column keeps its first, last, minimum and maximum point, so the
+//   drawn line and its peaks are the same as if every point was plotted.
+//
+//   A min/max pyramid is built once with the series. Each level keeps the
+//   minimum and maximum of every group of four points of the level below,
+//   halving its size, so a window is decimated from the coarsest level
+//   that still has enough points for the plot width. The work for a zoom
+//   depends on the plot width rather than the length of the record.
+class SeriesDecimator {
+ public:
+  SeriesDecimator();
+  explicit SeriesDecimator(const QVector<QPointF> &points);
+
+  int size() const;
+  qreal xmin() const;
+  qreal xmax() const;
+
+  void shift(qreal dx);
+
+  //...Value at x, interpolated between the neighbouring points. Returns
+  //   false outside the series. Does not allocate
+  bool valueAt(qreal x, qreal &y) const;
+
+  QVector<QPointF> decimate(qreal xmin, qreal xmax, int pixels) const;
+
+ private:
+  void buildPyramid();
+
+  QVector<qreal> m_x;
+  QVector<qreal> m_y;
+  QVector<QVector<QPointF>> m_levels;
+};
+
+#endif  // SERIESDECIMATOR_H
@@ -0,0 +1,83 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "stationmatcher.h"
+#include <cmath>
+
+StationMatcher::StationMatcher(double tolerance)
+    : m_tolerance(tolerance), m_cellSize(tolerance > 0.0 ? tolerance : 1.0) {}
+
+size_t StationMatcher::CellHash::operator()(const Cell &c) const {
+  return std::hash<qint64>()(c.first * 73856093LL ^ c.second * 19349663LL);
+}
+
+bool StationMatcher::cell(double x, double y, Cell &c) const {
+  const double limit = 4.0e18;
+  const double cx = std::floor(x / this->m_cellSize);
+  const double cy = std::floor(y / this->m_cellSize);
+  if (!(std::abs(cx) < limit && std::abs(cy) < limit)) return false;
+  c = Cell(static_cast<qint64>(cx), static_cast<qint64>(cy));
+  return true;
+}
+
+bool StationMatcher::matches(int index, double x, double y) const {
+  const double dx = this->m_x[index] - x;
+  const double dy = this->m_y[index] - y;
+  return dx * dx + dy * dy < this->m_tolerance * this->m_tolerance;
+}
+
+void StationMatcher::add(double x, double y) {
+  const int index = static_cast<int>(this->m_x.size());
+  this->m_x.push_back(x);
+  this->m_y.push_back(y);
+
+  Cell c;
+  if (this->cell(x, y, c))
+    this->m_cells[c].push_back(index);
+  else
+    this->m_outside.push_back(index);
+}
+
+int StationMatcher::find(double x, double y) const {
+  int best = -1;
+  if (this->m_tolerance <= 0.0) return best;
+
+  Cell c;
+  if (this->cell(x, y, c)) {
+    for (qint64 i = c.first - 1; i <= c.first + 1; ++i) {
+      for (qint64 j = c.second - 1; j <= c.second + 1; ++j) {
+        auto it = this->m_cells.find(Cell(i, j));
+        if (it == this->m_cells.end()) continue;
+        for (int index : it->second) {
+          if ((best < 0 || index < best) && this->matches(index, x, y))
+            best = index;
+        }
+      }
+    }
+  }
+
+  for (int index : this->m_outside) {
+    if ((best < 0 || index < best) && this->matches(index, x, y))
+      best = index;
+  }
+
+  return best;
+}
+
+size_t StationMatcher::size() const { return this->m_x.size(); }
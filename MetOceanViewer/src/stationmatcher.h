@@ -0,0 +1,66 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef STATIONMATCHER_H
+#define STATIONMATCHER_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//...Finds station locations within a tolerance of each other using a
+//   uniform grid with cells the size of the tolerance. A query only looks
+//   at the 3x3 block of cells around the point, so building and matching a
+//   station list is close to linear in the number of stations.
+class StationMatcher {
+ public:
+  explicit StationMatcher(double tolerance);
+
+  //...Adds a location. Locations are numbered in the order they are added
+  void add(double x, double y);
+
+  //...Lowest numbered location closer than the tolerance to (x, y), or -1
+  int find(double x, double y) const;
+
+  size_t size() const;
+
+ private:
+  typedef std::pair<qint64, qint64> Cell;
+
+  struct CellHash {
+    size_t operator()(const Cell &c) const;
+  };
+
+  bool cell(double x, double y, Cell &c) const;
+  bool matches(int index, double x, double y) const;
+
+  double m_tolerance;
+  double m_cellSize;
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::unordered_map<Cell, std::vector<int>, CellHash> m_cells;
+
+  //...Locations that cannot be placed on the grid (non-finite or far out
+  //   of range) are checked one by one
+  std::vector<int> m_outside;
+};
+
+#endif  // STATIONMATCHER_H
@@ -20,6 +20,7 @@
 
 #include "addtimeseriesdialog.h"
 #include "mainwindow.h"
+#include "metoceanviewer.h"
 #include "ui_mainwindow.h"
 #include "usertimeseries.h"
 
@@ -253,9 +254,6 @@ void MainWindow::on_button_TimeseriesEditRow_clicked() {
 void MainWindow::on_button_processTimeseriesData_clicked() {
   int ierr;
 
-  // Change the mouse pointer
-  QApplication::setOverrideCursor(Qt::WaitCursor);
-
   if (this->m_userTimeseries != nullptr) delete this->m_userTimeseries;
 
   this->m_userTimeseries = new UserTimeseries(
@@ -269,20 +267,33 @@ void MainWindow::on_button_processTimeseriesData_clicked() {
       &this->userSelectedStations, this);
   connect(this->m_userTimeseries, SIGNAL(timeseriesError(QString)), this,
           SLOT(throwErrorMessageBox(QString)));
+  connect(this->m_userTimeseries, SIGNAL(processingComplete(int)), this,
+          SLOT(userTimeseriesProcessed(int)));
 
+  //...Files are read in the background and userTimeseriesProcessed is
+  //   called when they are all in
   ierr = this->m_userTimeseries->processData();
   if (ierr != 0)
     QMessageBox::critical(this, tr("ERROR"),
                           this->m_userTimeseries->getErrorString());
-  else {
+}
+//-------------------------------------------//
+
+//-------------------------------------------//
+// Called once all of the time series files
+// have been read, or reading stopped
+//-------------------------------------------//
+void MainWindow::userTimeseriesProcessed(int ierr) {
+  if (ierr == MetOceanViewer::Error::NOERR) {
     ui->MainTabs->setCurrentIndex(1);
     ui->subtab_timeseries->setCurrentIndex(1);
+  } else if (ierr != MetOceanViewer::Error::PROCESSINGCANCELED) {
+    QMessageBox::critical(this, tr("ERROR"),
+                          this->m_userTimeseries->getErrorString());
   }
 
   //...Fit the viewport to the markers
   StationModel::fitMarkers(ui->quick_timeseriesMap, this->userDataStationModel);
-
-  QApplication::restoreOverrideCursor();
 }
 //-------------------------------------------//
 
@@ -18,6 +18,8 @@
 //
 //-----------------------------------------------------------------------*/
 #include "usertimeseries.h"
+#include <QtConcurrent>
+#include <numeric>
 #include "adcircstationoutput.h"
 #include "dflow.h"
 #include "errors.h"
@@ -26,6 +28,7 @@
 #include "generic.h"
 #include "metoceanviewer.h"
 #include "netcdf.h"
+#include "stationmatcher.h"
 
 UserTimeseries::UserTimeseries(
     QTableWidget *inTable, QCheckBox *inXAxisCheck, QCheckBox *inYAxisCheck,
@@ -34,7 +37,7 @@ UserTimeseries::UserTimeseries(
     QLineEdit *inYLabelEdit, QQuickWidget *inMap, ChartView *inChart,
     QStatusBar *inStatusBar, QVector<QColor> inRandomColorList,
     StationModel *inStationModel, QString *inSelectedStation, QObject *parent)
-    : QObject(parent) {
+    : QObject(parent), m_previewStations(m_duplicateStationTolerance) {
   this->m_table = inTable;
   this->m_checkXaxis = inXAxisCheck;
   this->m_checkYaxis = inYAxisCheck;
@@ -50,11 +53,32 @@ UserTimeseries::UserTimeseries(
   this->m_statusBar = inStatusBar;
   this->m_randomColorList = inRandomColorList;
   this->m_markerId = 0;
+  this->m_matchedStations = 0;
+  this->m_unmatchedStations = 0;
+  this->m_filesPending = 0;
+  this->m_processError = MetOceanViewer::Error::NOERR;
+  this->m_progress = nullptr;
   this->m_stationmodel = inStationModel;
   this->m_currentStation = inSelectedStation;
 }
 
-UserTimeseries::~UserTimeseries() {}
+UserTimeseries::~UserTimeseries() {
+  //...Workers may still be reading. Let them all finish before throwing
+  //   away what was never collected, since closing a netCDF result here
+  //   would run alongside another worker's netCDF calls
+  this->m_cancel.storeRelease(1);
+  for (QFutureWatcher<FileResult> *watcher : this->m_fileWatchers) {
+    if (watcher == nullptr) continue;
+    watcher->disconnect(this);
+    watcher->waitForFinished();
+  }
+  for (QFutureWatcher<FileResult> *watcher : this->m_fileWatchers) {
+    if (watcher == nullptr) continue;
+    delete watcher->result().data;
+    delete watcher;
+  }
+  delete this->m_progress;
+}
 
 int UserTimeseries::getDataBounds(double &ymin, double &ymax,
                                   QDateTime &minDateOut, QDateTime &maxDateOut,
@@ -213,6 +237,8 @@ void UserTimeseries::addSingleStationToPlot(Hmdf *h, int &plottedSeriesCounter,
   double addY = this->m_table->item(seriesCounter - 1, 5)->text().toDouble();
 
   HmdfStation *st = h->station(this->m_markerId);
+  QVector<QPointF> points;
+  points.reserve(st->numSnaps());
   for (int j = 0; j < h->station(this->m_markerId)->numSnaps(); j++) {
     if (std::abs(st->data(j) - st->nullValue()) > 0.0001 &&
         st->date(j) >= startDate && st->date(j) <= endDate) {
@@ -220,14 +246,14 @@ void UserTimeseries::addSingleStationToPlot(Hmdf *h, int &plottedSeriesCounter,
       minDate = std::min(st->date(j) + addX - offset, minDate);
       maxVal = std::max(st->data(j) * unitConversion + addY, maxVal);
       minVal = std::min(st->data(j) * unitConversion + addY, minVal);
-      s->append(st->date(j) + addX - offset,
-                st->data(j) * unitConversion + addY);
+      points.push_back(QPointF(st->date(j) + addX - offset,
+                               st->data(j) * unitConversion + addY));
     }
   }
 
-  if (s->points().size() > 0) {
+  if (!points.isEmpty()) {
     plottedSeriesCounter++;
-    this->m_chartView->addSeries(s, s->name());
+    this->m_chartView->addSeries(s, s->name(), points);
   }
   return;
 }
@@ -262,6 +288,8 @@ void UserTimeseries::addMultipleStationsToPlot(
           this->m_table->item(index, 4)->text().toDouble() * 3.6e+6);
       double addY = this->m_table->item(index, 5)->text().toDouble();
 
+      QVector<QPointF> points;
+      points.reserve(st->numSnaps());
       for (int j = 0; j < st->numSnaps(); j++) {
         if (std::abs(st->data(j) - st->nullValue()) > 0.0001 &&
             st->date(j) >= startDate && st->date(j) <= endDate) {
@@ -269,13 +297,13 @@ void UserTimeseries::addMultipleStationsToPlot(
           minDate = std::min(st->date(j) + addX - offset, minDate);
           maxVal = std::max(st->data(j) * unitConversion + addY, maxVal);
           minVal = std::min(st->data(j) * unitConversion + addY, minVal);
-          s->append(st->date(j) + addX - offset,
-                    st->data(j) * unitConversion + addY);
+          points.push_back(QPointF(st->date(j) + addX - offset,
+                                   st->data(j) * unitConversion + addY));
         }
       }
 
-      if (s->points().size() > 0) {
-        this->m_chartView->addSeries(s, s->name());
+      if (!points.isEmpty()) {
+        this->m_chartView->addSeries(s, s->name(), points);
       }
     }
   }
@@ -362,13 +390,12 @@ void UserTimeseries::plot() {
 
 QString UserTimeseries::getErrorString() { return this->m_errorString; }
 
-int UserTimeseries::processImedsData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-
-  int ierr = data->readImeds(tempFile);
+int UserTimeseries::processImedsData(const FileRequest &request, Hmdf *data,
+                                     QString &errorString) {
+  int ierr = data->readImeds(request.filename, true);
 
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->m_errorString = tr("Error reading file: ") + tempFile;
+    errorString = tr("Error reading file: ") + request.filename;
     return MetOceanViewer::Error::IMEDS_FILEREADERROR;
   }
 
@@ -377,14 +404,14 @@ int UserTimeseries::processImedsData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processAdcircNetcdfData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-  QDateTime coldStart = QDateTime::fromString(
-      this->m_table->item(tableIndex, 7)->text(), "yyyy-MM-dd hh:mm:ss");
-  AdcircStationOutput *adcircData = new AdcircStationOutput(this);
-  int ierr = adcircData->read(tempFile, coldStart);
+int UserTimeseries::processAdcircNetcdfData(const FileRequest &request,
+                                            Hmdf *data, QString &errorString) {
+  AdcircStationOutput *adcircData = new AdcircStationOutput();
+  adcircData->setLazy(true);
+  int ierr = adcircData->read(request.filename, request.coldStart);
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->m_errorString = tr("Error reading file: ") + tempFile;
+    errorString = tr("Error reading file: ") + request.filename;
+    delete adcircData;
     return MetOceanViewer::Error::ADCIRC_NETCDFREADERROR;
   }
 
@@ -399,17 +426,16 @@ int UserTimeseries::processAdcircNetcdfData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processAdcircAsciiData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-  QDateTime coldStart = QDateTime::fromString(
-      this->m_table->item(tableIndex, 7)->text(), "yyyy-MM-dd hh:mm:ss");
-  QString tempStationFile = this->m_table->item(tableIndex, 10)->text();
-  AdcircStationOutput *adcircData = new AdcircStationOutput(this);
+int UserTimeseries::processAdcircAsciiData(const FileRequest &request,
+                                           Hmdf *data, QString &errorString) {
+  AdcircStationOutput *adcircData = new AdcircStationOutput();
 
-  int ierr = adcircData->read(tempFile, tempStationFile, coldStart);
+  int ierr = adcircData->read(request.filename, request.stationFile,
+                              request.coldStart);
 
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->m_errorString = tr("Error reading file: ") + tempFile;
+    errorString = tr("Error reading file: ") + request.filename;
+    delete adcircData;
     return MetOceanViewer::Error::ADCIRC_ASCIIREADERROR;
   }
 
@@ -423,17 +449,14 @@ int UserTimeseries::processAdcircAsciiData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processDflowData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-
-  Dflow *dflow = new Dflow(tempFile, this);
-  QString dflowVar = this->m_table->item(tableIndex, 12)->text();
-  int dflowLayer = this->m_table->item(tableIndex, 13)->text().toInt();
-  int ierr = dflow->getVariable(dflowVar, dflowLayer, data);
+int UserTimeseries::processDflowData(const FileRequest &request, Hmdf *data,
+                                     QString &errorString) {
+  Dflow *dflow = new Dflow(request.filename);
+  int ierr =
+      dflow->getVariable(request.dflowVariable, request.dflowLayer, data);
 
   if (ierr != MetOceanViewer::Error::NOERR) {
-    this->m_errorString =
-        tr("Error processing DFlow: ") + dflow->error->toString();
+    errorString = tr("Error processing DFlow: ") + dflow->error->toString();
     delete dflow;
     return MetOceanViewer::Error::DFLOW_FILEREADERROR;
   }
@@ -441,60 +464,236 @@ int UserTimeseries::processDflowData(int tableIndex, Hmdf *data) {
   return MetOceanViewer::Error::NOERR;
 }
 
-int UserTimeseries::processGenericNetcdfData(int tableIndex, Hmdf *data) {
-  QString tempFile = this->m_table->item(tableIndex, 6)->text();
-
-  int ierr = data->readNetcdf(tempFile);
+int UserTimeseries::processGenericNetcdfData(const FileRequest &request,
+                                             Hmdf *data,
+                                             QString &errorString) {
+  int ierr = data->readNetcdf(request.filename, true);
   if (ierr != 0) {
-    this->m_errorString = "Error processing generic netcdf file.";
+    errorString = "Error processing generic netcdf file.";
     return MetOceanViewer::Error::GENERICNETCDFERROR;
   }
   return MetOceanViewer::Error::NOERR;
 }
 
+//-------------------------------------------//
+// Read one file on a worker thread. The
+// netCDF library is not thread safe, so
+// netCDF files are read one at a time while
+// text files are read alongside them. The
+// result is handed to the target thread
+// before it is returned
+//-------------------------------------------//
+UserTimeseries::FileResult UserTimeseries::readFile(
+    const FileRequest &request, QThread *target, const QAtomicInt *cancel) {
+  static QMutex netcdfMutex;
+
+  FileResult result;
+  if (cancel->loadAcquire() != 0) return result;
+
+  bool isNetcdf =
+      request.fileType == MetOceanViewer::FileType::NETCDF_ADCIRC ||
+      request.fileType == MetOceanViewer::FileType::NETCDF_DFLOW ||
+      request.fileType == MetOceanViewer::FileType::NETCDF_GENERIC;
+  QMutexLocker lock(isNetcdf ? &netcdfMutex : nullptr);
+
+  //...A netCDF read may have waited behind others while the user canceled
+  if (cancel->loadAcquire() != 0) return result;
+
+  Hmdf *data = new Hmdf();
+
+  switch (request.fileType) {
+    case MetOceanViewer::FileType::ASCII_IMEDS:
+      result.ierr = processImedsData(request, data, result.errorString);
+      break;
+    case MetOceanViewer::FileType::NETCDF_ADCIRC:
+      result.ierr = processAdcircNetcdfData(request, data, result.errorString);
+      break;
+    case MetOceanViewer::FileType::ASCII_ADCIRC:
+      result.ierr = processAdcircAsciiData(request, data, result.errorString);
+      break;
+    case MetOceanViewer::FileType::NETCDF_DFLOW:
+      result.ierr = processDflowData(request, data, result.errorString);
+      break;
+    case MetOceanViewer::FileType::NETCDF_GENERIC:
+      result.ierr = processGenericNetcdfData(request, data, result.errorString);
+      break;
+    default:
+      result.errorString = QStringLiteral("Invalid file format");
+      result.ierr = MetOceanViewer::Error::INVALIDFILEFORMAT;
+      delete data;
+      return result;
+  }
+
+  if (!data->success() || result.ierr != MetOceanViewer::Error::NOERR) {
+    //...Keep the reader's own code and always say which file failed
+    if (result.ierr == MetOceanViewer::Error::NOERR)
+      result.ierr = MetOceanViewer::Error::GENERICFILEREADERROR;
+    if (result.errorString.isEmpty())
+      result.errorString = tr("Error reading file: ") + request.filename;
+    delete data;
+    return result;
+  }
+
+  data->moveToThread(target);
+  result.data = data;
+  return result;
+}
+
 int UserTimeseries::processDataFiles() {
-  int ierr;
+  int nFiles = this->m_table->rowCount();
+  if (nFiles == 0) {
+    this->m_errorString = tr("No files to process");
+    return MetOceanViewer::Error::GENERICFILEREADERROR;
+  }
 
-  for (int i = 0; i < this->m_table->rowCount(); i++) {
-    int inputFileType =
-        Filetypes::getIntegerFiletype(this->m_table->item(i, 6)->text());
+  this->m_cancel.storeRelease(0);
+  this->m_processError = MetOceanViewer::Error::NOERR;
+  this->m_filesPending = nFiles;
+  this->m_readThroughput.clear();
+  this->m_allFileData.fill(nullptr, nFiles);
+  this->m_fileWatchers.fill(nullptr, nFiles);
+
+  this->m_progress = new QProgressDialog(
+      tr("Reading files..."), tr("Cancel"), 0, nFiles, this->m_table->window());
+  this->m_progress->setWindowModality(Qt::WindowModal);
+  this->m_progress->setMinimumDuration(0);
+  this->m_progress->setAutoClose(false);
+  this->m_progress->setAutoReset(false);
+  this->m_progress->setValue(0);
+  connect(this->m_progress, SIGNAL(canceled()), this,
+          SLOT(cancelProcessing()));
+
+  for (int i = 0; i < nFiles; i++) {
+    FileRequest request;
+    request.filename = this->m_table->item(i, 6)->text();
+    request.fileType = Filetypes::getIntegerFiletype(request.filename);
+    request.coldStart = QDateTime::fromString(
+        this->m_table->item(i, 7)->text(), "yyyy-MM-dd hh:mm:ss");
+    request.stationFile = this->m_table->item(i, 10)->text();
+    request.dflowVariable = this->m_table->item(i, 12)->text();
+    request.dflowLayer = this->m_table->item(i, 13)->text().toInt();
     this->m_epsg.push_back(this->m_table->item(i, 11)->text().toInt());
 
-    Hmdf *stationData = new Hmdf(this);
+    QFutureWatcher<FileResult> *watcher = new QFutureWatcher<FileResult>();
+    connect(watcher, &QFutureWatcher<FileResult>::finished, this,
+            [=] { this->fileProcessed(i); });
+    this->m_fileWatchers[i] = watcher;
+    watcher->setFuture(QtConcurrent::run(UserTimeseries::readFile, request,
+                                         this->thread(), &this->m_cancel));
+  }
+  return MetOceanViewer::Error::NOERR;
+}
 
-    switch (inputFileType) {
-      case MetOceanViewer::FileType::ASCII_IMEDS:
-        ierr = this->processImedsData(i, stationData);
-        this->m_allFileData.push_back(stationData);
-        break;
-      case MetOceanViewer::FileType::NETCDF_ADCIRC:
-        ierr = this->processAdcircNetcdfData(i, stationData);
-        this->m_allFileData.push_back(stationData);
-        break;
-      case MetOceanViewer::FileType::ASCII_ADCIRC:
-        ierr = this->processAdcircAsciiData(i, stationData);
-        this->m_allFileData.push_back(stationData);
-        break;
-      case MetOceanViewer::FileType::NETCDF_DFLOW:
-        ierr = this->processDflowData(i, stationData);
-        this->m_allFileData.push_back(stationData);
-        break;
-      case MetOceanViewer::FileType::NETCDF_GENERIC:
-        ierr = this->processGenericNetcdfData(i, stationData);
-        this->m_allFileData.push_back(stationData);
-        break;
-      default:
-        this->m_errorString = QStringLiteral("Invalid file format");
-        return MetOceanViewer::Error::INVALIDFILEFORMAT;
+void UserTimeseries::cancelProcessing() {
+  this->m_cancel.storeRelease(1);
+  if (this->m_progress) this->m_progress->setLabelText(tr("Canceling..."));
+  return;
+}
+
+//-------------------------------------------//
+// Collect a file from its worker, show its
+// stations on the map and finish up once the
+// last file is in
+//-------------------------------------------//
+void UserTimeseries::fileProcessed(int index) {
+  QFutureWatcher<FileResult> *watcher = this->m_fileWatchers[index];
+  FileResult result = watcher->result();
+  this->m_fileWatchers[index] = nullptr;
+  watcher->deleteLater();
+  this->m_filesPending--;
+
+  if (result.data != nullptr) {
+    result.data->setParent(this);
+    this->m_allFileData[index] = result.data;
+    //...Only the IMEDS reader measures its throughput
+    if (result.data->readThroughput() > 0.0)
+      this->m_readThroughput.push_back(result.data->readThroughput());
+  }
+
+  if (result.ierr != MetOceanViewer::Error::NOERR &&
+      this->m_processError == MetOceanViewer::Error::NOERR) {
+    //...Stop on the first file that fails
+    this->m_processError = result.ierr;
+    this->m_errorString = result.errorString;
+    this->m_cancel.storeRelease(1);
+  }
+
+  if (result.data != nullptr && this->m_cancel.loadAcquire() == 0) {
+    QVector<Hmdf *> file(1, result.data);
+    if (this->projectStations(QVector<int>(1, this->m_epsg[index]), file) !=
+        0) {
+      this->m_processError = MetOceanViewer::Error::PROJECTSTATIONS;
+      this->m_errorString = tr("Error projecting the station locations");
+      this->m_cancel.storeRelease(1);
+    } else {
+      this->addPreviewMarkers(result.data);
     }
+  }
 
-    if (!this->m_allFileData.last()->success() ||
-        ierr != MetOceanViewer::Error::NOERR) {
-      this->m_allFileData.pop_back();
-      return MetOceanViewer::Error::GENERICFILEREADERROR;
+  int nFiles = this->m_allFileData.length();
+  if (this->m_progress) {
+    this->m_progress->setValue(nFiles - this->m_filesPending);
+    if (this->m_cancel.loadAcquire() == 0) {
+      this->m_progress->setLabelText(
+          tr("Read %1 (%2 of %3)")
+              .arg(QFileInfo(this->m_table->item(index, 6)->text()).fileName())
+              .arg(nFiles - this->m_filesPending)
+              .arg(nFiles));
     }
   }
-  return MetOceanViewer::Error::NOERR;
+
+  if (this->m_filesPending == 0) this->finishProcessing();
+  return;
+}
+
+void UserTimeseries::addPreviewMarkers(Hmdf *data) {
+  //...Markers shown while files are still being read. They are replaced
+  //   by the final station list once every file is in
+  for (int i = 0; i < data->nstations(); i++) {
+    double x = data->station(i)->longitude();
+    double y = data->station(i)->latitude();
+    if (this->m_previewStations.find(x, y) >= 0) continue;
+    Station s =
+        Station(QGeoCoordinate(y, x),
+                QString::number(this->m_previewStations.size()),
+                data->station(i)->name());
+    this->m_previewStations.add(x, y);
+    this->m_stationmodel->addMarker(s);
+  }
+  return;
+}
+
+void UserTimeseries::finishProcessing() {
+  if (this->m_progress) {
+    this->m_progress->deleteLater();
+    this->m_progress = nullptr;
+  }
+
+  int ierr = this->m_processError;
+  if (ierr == MetOceanViewer::Error::NOERR &&
+      this->m_cancel.loadAcquire() != 0) {
+    this->m_errorString = tr("Reading the files was canceled");
+    ierr = MetOceanViewer::Error::PROCESSINGCANCELED;
+  }
+
+  if (ierr == MetOceanViewer::Error::NOERR) {
+    //...Perform data organization
+    ierr = this->processStationLocations();
+  }
+
+  if (ierr == MetOceanViewer::Error::NOERR) {
+    //...Add the markers
+    ierr = this->addMarkersToMap();
+  }
+
+  if (ierr != MetOceanViewer::Error::NOERR) {
+    qDeleteAll(this->m_allFileData);
+    this->m_allFileData.clear();
+    this->m_stationmodel->clear();
+  }
+
+  emit processingComplete(ierr);
+  return;
 }
 
 int UserTimeseries::processStationLocations() {
@@ -527,6 +726,19 @@ int UserTimeseries::processStationLocations() {
 
   this->m_allFileData.clear();
 
+  QString message =
+      tr("%1 unique stations, %2 matched and %3 missing across files")
+          .arg(this->m_xLocations.length())
+          .arg(this->m_matchedStations)
+          .arg(this->m_unmatchedStations);
+  if (!this->m_readThroughput.isEmpty()) {
+    double mean = std::accumulate(this->m_readThroughput.begin(),
+                                  this->m_readThroughput.end(), 0.0) /
+                  this->m_readThroughput.size();
+    message += tr(", IMEDS files read at %1 MB/s").arg(mean, 0, 'f', 1);
+  }
+  this->m_statusBar->showMessage(message, 5000);
+
   return MetOceanViewer::Error::NOERR;
 }
 
@@ -558,32 +770,11 @@ int UserTimeseries::addMarkersToMap() {
 }
 
 int UserTimeseries::processData() {
-  //...Process the data files
-  int ierr = this->processDataFiles();
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    return ierr;
-  }
-
-  //...Project the data to WGS84
-  ierr = this->projectStations(this->m_epsg, this->m_allFileData);
-  if (ierr != 0) {
-    this->m_errorString = tr("Error projecting the station locations");
-    return MetOceanViewer::Error::PROJECTSTATIONS;
-  }
-
-  //...Perform data organization
-  ierr = this->processStationLocations();
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    return ierr;
-  }
-
-  //...Add the markers
-  ierr = this->addMarkersToMap();
-  if (ierr != MetOceanViewer::Error::NOERR) {
-    return ierr;
-  }
+  this->m_stationmodel->clear();
 
-  return MetOceanViewer::Error::NOERR;
+  //...Read the files in the background. Station locations are projected
+  //   as each file arrives and the station list is built once all are in
+  return this->processDataFiles();
 }
 
 //-------------------------------------------//
@@ -595,25 +786,20 @@ int UserTimeseries::processData() {
 int UserTimeseries::getUniqueStationList(QVector<Hmdf *> &Data,
                                          QVector<double> &X,
                                          QVector<double> &Y) {
+  StationMatcher unique(this->m_duplicateStationTolerance);
+  for (int k = 0; k < X.length(); k++) unique.add(X[k], Y[k]);
+
   for (int i = 0; i < Data.length(); i++) {
     for (int j = 0; j < Data[i]->nstations(); j++) {
-      bool found = false;
-      for (int k = 0; k < X.length(); k++) {
-        double dx = Data[i]->station(j)->longitude() - X[k];
-        double dy = Data[i]->station(j)->latitude() - Y[k];
-        double d = std::sqrt(std::pow(dx, 2.0) + std::pow(dy, 2.0));
-        if (d < this->m_duplicateStationTolerance) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
-        X.push_back(Data[i]->station(j)->longitude());
-        Y.push_back(Data[i]->station(j)->latitude());
+      double x = Data[i]->station(j)->longitude();
+      double y = Data[i]->station(j)->latitude();
+      if (unique.find(x, y) < 0) {
+        X.push_back(x);
+        Y.push_back(y);
+        unique.add(x, y);
       }
     }
   }
-  qDebug() << X.size();
   return MetOceanViewer::Error::NOERR;
 }
 //-------------------------------------------//
@@ -636,22 +822,26 @@ int UserTimeseries::buildRevisedIMEDS(QVector<Hmdf *> Data,
     DataOut[i]->setHeader3(Data[i]->header3());
   }
 
+  this->m_matchedStations = 0;
+  this->m_unmatchedStations = 0;
+
   for (int i = 0; i < Data.length(); i++) {
+    //...Stations are added in file order so that the first station in
+    //   the file within the tolerance wins, as it always has
+    StationMatcher stations(this->m_duplicateStationTolerance);
+    for (int k = 0; k < Data[i]->nstations(); k++) {
+      stations.add(Data[i]->station(k)->longitude(),
+                   Data[i]->station(k)->latitude());
+    }
+
     for (int j = 0; j < X.length(); j++) {
-      bool found = false;
-      for (int k = 0; k < Data[i]->nstations(); k++) {
-        double dx = Data[i]->station(k)->longitude() - X[j];
-        double dy = Data[i]->station(k)->latitude() - Y[j];
-        double d = std::sqrt(std::pow(dx, 2.0) + std::pow(dy, 2.0));
-        if (d < this->m_duplicateStationTolerance) {
-          HmdfStation *p = Data[i]->station(k);
-          p->setIsNull(false);
-          DataOut[i]->addStation(p);
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
+      int k = stations.find(X[j], Y[j]);
+      if (k >= 0) {
+        HmdfStation *p = Data[i]->station(k);
+        p->setIsNull(false);
+        DataOut[i]->addStation(p);
+        this->m_matchedStations++;
+      } else {
         // Build a station with a null dataset we can find later
         DataOut[i]->addStation(new HmdfStation(DataOut[i]));
         DataOut[i]->station(j)->setLongitude(X[j]);
@@ -660,6 +850,7 @@ int UserTimeseries::buildRevisedIMEDS(QVector<Hmdf *> Data,
         DataOut[i]->station(j)->setNext(HmdfStation::nullDateValue(),
                                         HmdfStation::nullDataValue());
         DataOut[i]->station(j)->setIsNull(true);
+        this->m_unmatchedStations++;
       }
     }
   }
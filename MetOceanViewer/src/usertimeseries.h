@@ -21,9 +21,12 @@
 #define USERTIMESERIES_H
 
 #include <QChartView>
+#include <QAtomicInt>
 #include <QDateTime>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QPrinter>
+#include <QProgressDialog>
 #include <QQuickItem>
 #include <QQuickView>
 #include <QQuickWidget>
@@ -34,6 +37,7 @@
 #include "chartview.h"
 #include "generic.h"
 #include "hmdf.h"
+#include "stationmatcher.h"
 #include "stationmodel.h"
 
 class UserTimeseries : public QObject {
@@ -52,6 +56,10 @@ class UserTimeseries : public QObject {
   ~UserTimeseries();
 
   //...Public functions
+
+  //...Starts reading the files in the table on worker threads and returns
+  //   straight away. processingComplete is emitted once every file has
+  //   been read, or the read has failed or been canceled
   int processData();
   int plotData();
   int getCurrentMarkerID();
@@ -62,8 +70,29 @@ class UserTimeseries : public QObject {
 
  signals:
   void timeseriesError(QString);
+  void processingComplete(int);
+
+ public slots:
+  void cancelProcessing();
 
  private:
+  //...Everything a worker needs to read one row of the table, copied from
+  //   the table on the GUI thread
+  struct FileRequest {
+    int fileType = 0;
+    QString filename;
+    QString stationFile;
+    QDateTime coldStart;
+    QString dflowVariable;
+    int dflowLayer = 0;
+  };
+
+  struct FileResult {
+    Hmdf *data = nullptr;
+    int ierr = 0;
+    QString errorString;
+  };
+
   //...Private functions
   int getStationSelections();
   int setMarkerID();
@@ -79,11 +108,21 @@ class UserTimeseries : public QObject {
 
   Qt::PenStyle setPenStyle(const int penIndex);
   int processDataFiles();
-  int processImedsData(int tableIndex, Hmdf *data);
-  int processAdcircAsciiData(int tableIndex, Hmdf *data);
-  int processAdcircNetcdfData(int tableIndex, Hmdf *data);
-  int processDflowData(int tableIndex, Hmdf *data);
-  int processGenericNetcdfData(int tableIndex, Hmdf *data);
+  void fileProcessed(int index);
+  void finishProcessing();
+  void addPreviewMarkers(Hmdf *data);
+  static FileResult readFile(const FileRequest &request, QThread *target,
+                             const QAtomicInt *cancel);
+  static int processImedsData(const FileRequest &request, Hmdf *data,
+                              QString &errorString);
+  static int processAdcircAsciiData(const FileRequest &request, Hmdf *data,
+                                    QString &errorString);
+  static int processAdcircNetcdfData(const FileRequest &request, Hmdf *data,
+                                     QString &errorString);
+  static int processDflowData(const FileRequest &request, Hmdf *data,
+                              QString &errorString);
+  static int processGenericNetcdfData(const FileRequest &request, Hmdf *data,
+                                      QString &errorString);
   int processStationLocations();
   int addMarkersToMap();
   void addSingleStationToPlot(Hmdf *h, int &plottedSeriesCounter,
@@ -106,6 +145,17 @@ class UserTimeseries : public QObject {
   QVector<QColor> m_randomColorList;
   QVector<int> m_epsg;
   const double m_duplicateStationTolerance = 0.00001;
+  int m_matchedStations;
+  int m_unmatchedStations;
+  QVector<double> m_readThroughput;
+
+  //...Background file reading
+  QVector<QFutureWatcher<FileResult> *> m_fileWatchers;
+  QAtomicInt m_cancel;
+  int m_filesPending;
+  int m_processError;
+  QProgressDialog *m_progress;
+  StationMatcher m_previewStations;
 
   //...Widgets
   QTableWidget *m_table;
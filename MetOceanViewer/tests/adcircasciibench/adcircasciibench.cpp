@@ -0,0 +1,214 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegExp>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include "adcircstationoutput.h"
+#include "hmdf.h"
+
+//...Compares the tokenizing ASCII station reader with the readLine/split
+//   reader it replaced on a synthetic fort.61 file. Usage:
+//     adcircasciibench [nStations nSnaps]
+//   The default is the 1,000 station by 50,000 snap case, which writes a
+//   file of about 1.3 GB to the working directory.
+
+struct LegacyOutput {
+  QVector<double> time;
+  QVector<QVector<double>> data;
+  QVector<double> longitude;
+  QVector<double> latitude;
+};
+
+//...The reader as it was before the tokenizing parser, kept here only to
+//   time it. Scalar files only.
+static bool legacyRead(const QString &outputFile, const QString &stationFile,
+                       LegacyOutput &out) {
+  QFile MyFile(outputFile), StationFile(stationFile);
+  QString header1, header2, TempLine;
+  QStringList headerData, TempList;
+
+  if (!MyFile.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+  if (!StationFile.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+  header1 = MyFile.readLine();
+  header2 = MyFile.readLine().simplified();
+  headerData = header2.split(" ");
+
+  int nSnaps = headerData.value(0).toInt();
+  int nStations = headerData.value(1).toInt();
+
+  out.time.resize(nSnaps);
+  out.data.resize(nStations);
+  for (int i = 0; i < nStations; ++i) out.data[i].resize(nSnaps);
+
+  for (int i = 0; i < nSnaps; ++i) {
+    TempLine = MyFile.readLine().simplified();
+    TempList = TempLine.split(" ");
+    out.time[i] = TempList.value(0).toDouble();
+    for (int j = 0; j < nStations; ++j) {
+      TempLine = MyFile.readLine().simplified();
+      TempList = TempLine.split(" ");
+      if (TempList.value(1).toDouble() < -900) {
+        out.data[j][i] = HmdfStation::nullDataValue();
+      } else {
+        out.data[j][i] = TempList.value(1).toDouble();
+      }
+    }
+  }
+  MyFile.close();
+
+  TempLine = StationFile.readLine().simplified();
+  TempList = TempLine.split(" ");
+  if (TempList.value(0).toInt() != nStations) return false;
+
+  out.longitude.resize(nStations);
+  out.latitude.resize(nStations);
+  for (int i = 0; i < nStations; ++i) {
+    TempLine = StationFile.readLine().simplified();
+    TempList = TempLine.split(QRegExp(",| "));
+    out.longitude[i] = TempList.value(0).toDouble();
+    out.latitude[i] = TempList.value(1).toDouble();
+  }
+  StationFile.close();
+
+  return true;
+}
+
+//...Every 97th value is the ADCIRC dry flag so the null handling is timed
+//   and checked too
+static bool writeFiles(const QString &outputFile, const QString &stationFile,
+                       int nStations, int nSnaps) {
+  FILE *f = std::fopen(outputFile.toUtf8().constData(), "w");
+  if (f == nullptr) return false;
+  std::fprintf(f, "  synthetic benchmark output\n");
+  std::fprintf(f, "%11d%11d  0.6000000E+003   600     1\n", nSnaps,
+               nStations);
+  long long n = 0;
+  for (int i = 0; i < nSnaps; ++i) {
+    std::fprintf(f, "%22.10E%15d\n", 600.0 * (i + 1), 600 * (i + 1));
+    for (int j = 0; j < nStations; ++j, ++n) {
+      double v = n % 97 == 0 ? -99999.0
+                             : std::sin(0.001 * i + 0.1 * j) * (1 + j % 7);
+      std::fprintf(f, "%10d%22.10E\n", j + 1, v);
+    }
+  }
+  std::fclose(f);
+
+  f = std::fopen(stationFile.toUtf8().constData(), "w");
+  if (f == nullptr) return false;
+  std::fprintf(f, "%d\n", nStations);
+  for (int j = 0; j < nStations; ++j) {
+    std::fprintf(f, "%.6f,%.6f\n", -90.0 + 0.001 * j, 29.0 + 0.001 * j);
+  }
+  std::fclose(f);
+  return true;
+}
+
+static bool sameValue(double a, double b) {
+  return std::abs(a - b) <= 1e-12 * std::max(1.0, std::abs(a));
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  int nStations = 1000;
+  int nSnaps = 50000;
+  if (argc == 3) {
+    nStations = QString(argv[1]).toInt();
+    nSnaps = QString(argv[2]).toInt();
+  }
+
+  const QString outputFile = "adcircasciibench.61";
+  const QString stationFile = "adcircasciibench_stations.txt";
+  const QDateTime coldStart(QDate(2020, 1, 1), QTime(0, 0, 0), Qt::UTC);
+
+  std::cout << "Writing " << nStations << " stations x " << nSnaps
+            << " snaps" << std::endl;
+  if (!writeFiles(outputFile, stationFile, nStations, nSnaps)) {
+    std::cerr << "Could not write the benchmark files" << std::endl;
+    return 1;
+  }
+
+  QElapsedTimer timer;
+
+  timer.start();
+  LegacyOutput legacy;
+  bool legacyOk = legacyRead(outputFile, stationFile, legacy);
+  qint64 legacyTime = timer.elapsed();
+
+  timer.start();
+  AdcircStationOutput reader;
+  int ierr = reader.read(outputFile, stationFile, coldStart);
+  Hmdf hmdf;
+  if (ierr == 0) ierr = reader.toHmdf(&hmdf);
+  qint64 parserTime = timer.elapsed();
+
+  QFile::remove(outputFile);
+  QFile::remove(stationFile);
+
+  if (!legacyOk || ierr != 0) {
+    std::cerr << "Read failed: legacy " << legacyOk << ", parser " << ierr
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "readLine/split reader: " << legacyTime << " ms" << std::endl;
+  std::cout << "tokenizing reader:     " << parserTime << " ms" << std::endl;
+
+  if (hmdf.nstations() != static_cast<size_t>(nStations)) {
+    std::cerr << "Station count differs: " << hmdf.nstations() << std::endl;
+    return 1;
+  }
+
+  size_t mismatches = 0;
+  for (int j = 0; j < nStations; ++j) {
+    HmdfStation *s = hmdf.station(j);
+    if (s->numSnaps() != static_cast<size_t>(nSnaps) ||
+        !sameValue(s->longitude(), legacy.longitude[j]) ||
+        !sameValue(s->latitude(), legacy.latitude[j])) {
+      mismatches++;
+      continue;
+    }
+    for (int i = 0; i < nSnaps; ++i) {
+      qint64 date =
+          coldStart.toMSecsSinceEpoch() +
+          static_cast<qint64>(std::llround(legacy.time[i] * 1000.0));
+      if (s->date(i) != date || !sameValue(s->data(i), legacy.data[j][i]))
+        mismatches++;
+    }
+  }
+
+  if (mismatches != 0) {
+    std::cerr << mismatches << " values differ between the readers"
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "Both readers agree" << std::endl;
+  return 0;
+}
@@ -0,0 +1,48 @@
+#-------------------------------GPL-------------------------------------#
+#
+# MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+# Copyright (C) 2019  Zach Cobell
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-----------------------------------------------------------------------#
+
+#...Standalone benchmark of the ADCIRC ASCII station reader. Not part of
+#   the default build. Build with qmake after libmetocean has been built.
+
+include($$PWD/../../../global.pri)
+
+QT += core network positioning concurrent
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = adcircasciibench
+
+INCLUDEPATH += $$PWD/../../src
+INCLUDEPATH += $$PWD/../../../thirdparty/boost_1_67_0
+INCLUDEPATH += $$PWD/../../../libraries/libmetocean
+DEPENDPATH += $$PWD/../../../libraries/libmetocean
+
+SOURCES += adcircasciibench.cpp \
+           ../../src/adcircstationoutput.cpp
+
+HEADERS += ../../src/adcircstationoutput.h
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../../libraries/libmetocean/release/ -lmetocean
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../../libraries/libmetocean/debug/ -lmetocean
+else:unix: LIBS += -L$$OUT_PWD/../../../libraries/libmetocean/ -lmetocean
+
+unix|win32: LIBS += -lnetcdf
@@ -22,7 +22,7 @@ include($$PWD/../global.pri)
 
 QT -= gui
 
-CONFIG += c++11 console
+CONFIG += c++11 console thread
 CONFIG -= app_bundle
 CONFIG -= QT
 
@@ -42,7 +42,6 @@ INCLUDEPATH += $$PWD/../thirdparty/boost_1_67_0
 SOURCES += \
         src/cdate.cpp \
         src/crmsdatabase.cpp \
-        src/crmsdatacontainer.cpp \
         src/main.cpp
 
 # Default rules for deployment.
@@ -52,5 +51,4 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 HEADERS += \
     src/cdate.h \
-    src/crmsdatabase.h \
-    src/crmsdatacontainer.h
+    src/crmsdatabase.h
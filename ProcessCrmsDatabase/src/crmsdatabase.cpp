@@ -1,409 +1,1209 @@
-/*-------------------------------GPL-------------------------------------//
-//
-// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
-// Copyright (C) 2018  Zach Cobell
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program.  If not, see <http://www.gnu.org/licenses/>.
-//
-//-----------------------------------------------------------------------*/
-#include "crmsdatabase.h"
-#include <iostream>
-#include "boost/algorithm/string/split.hpp"
-#include "boost/algorithm/string/trim.hpp"
-#include "boost/format.hpp"
-#include "boost/lexical_cast.hpp"
-#include "cdate.h"
-#include "netcdf.h"
-
-std::vector<std::string> splitString(const std::string &s) {
-  std::vector<std::string> elems;
-  boost::algorithm::split(elems, s, boost::is_any_of(","),
-                          boost::token_compress_off);
-  return elems;
-}
-
-CrmsDatabase::CrmsDatabase(const std::string &datafile,
-                           const std::string &outputFile)
-    : m_databaseFile(datafile),
-      m_outputFile(outputFile),
-      m_showProgressBar(true),
-      m_previousPercentComplete(0),
-      m_progressbar(nullptr),
-      m_fileLength(0) {}
-
-double CrmsDatabase::getPercentComplete() {
-  size_t fileposition = static_cast<size_t>(this->m_file.tellg());
-  double percent =
-      static_cast<double>(static_cast<long double>(fileposition) /
-                          static_cast<long double>(this->m_fileLength)) *
-      100.0;
-  if (this->m_showProgressBar) {
-    unsigned long dt = static_cast<unsigned long>(std::floor(percent)) -
-                       this->m_previousPercentComplete;
-    if (dt > 100 - this->m_previousPercentComplete) {
-      dt = 100 - this->m_previousPercentComplete;
-    }
-    if (dt > 0) {
-      *(this->m_progressbar) += dt;
-      this->m_previousPercentComplete += dt;
-    }
-  }
-  return percent;
-}
-
-void CrmsDatabase::parse() {
-  if (!this->fileExists(this->m_databaseFile)) {
-    std::cerr << "File does not exist." << std::endl;
-    return;
-  }
-
-  std::vector<std::string> names;
-  std::vector<size_t> length;
-  std::vector<int> varids_data, varids_time;
-
-  this->openCrmsFile();
-  this->readHeader();
-
-  std::cout << "Preprocessing CRMS file..." << std::endl;
-
-  this->m_previousPercentComplete = 0;
-  if (this->m_showProgressBar) {
-    this->m_progressbar.reset(new boost::progress_display(100));
-  }
-
-  this->prereadCrmsFile(names, length);
-
-  this->initializeOutputFile(names, length, varids_data, varids_time);
-
-  this->m_previousPercentComplete = 0;
-  if (this->m_showProgressBar) {
-    this->m_progressbar.reset(new boost::progress_display(100));
-  }
-
-  size_t nStation = 0;
-  bool finished = false;
-
-  while (!finished) {
-    this->getPercentComplete();
-    std::vector<CrmsDataContainer *> data;
-    bool valid = this->getNextStation(data, finished);
-    if (valid) {
-      this->putNextStation(data, varids_data[nStation], varids_time[nStation]);
-    }
-    this->deleteCrmsObjects(data);
-    nStation++;
-  }
-
-  if (this->m_showProgressBar) {
-    this->getPercentComplete();
-  }
-
-  this->closeOutputFile(nStation);
-  this->closeCrmsFile();
-
-  return;
-}
-
-void CrmsDatabase::deleteCrmsObjects(
-    const std::vector<CrmsDataContainer *> &data) {
-  for (auto &d : data) {
-    delete d;
-  }
-  return;
-}
-
-void CrmsDatabase::prereadCrmsFile(std::vector<std::string> &stationNames,
-                                   std::vector<size_t> &stationLengths) {
-  size_t nRecord = 1;
-  std::string stationPrev;
-  std::string line;
-  std::getline(this->m_file, line);
-
-  std::string stn1;
-  std::stringstream ss1(line);
-  std::getline(ss1, stationPrev, ',');
-
-  for (;;) {
-    if (this->m_file.eof()) break;
-    std::getline(this->m_file, line);
-    std::stringstream ss(line);
-    std::string stn;
-    std::getline(ss, stn, ',');
-    if (stn != stationPrev) {
-      stationNames.push_back(stationPrev);
-      stationLengths.push_back(nRecord);
-      nRecord = 1;
-      stationPrev = stn;
-      this->getPercentComplete();
-    } else {
-      nRecord++;
-    }
-  }
-  this->m_file.close();
-  this->m_file.open(this->m_databaseFile, std::ios::binary);
-  std::getline(this->m_file, line);
-
-  this->m_maxLength =
-      *std::max_element(stationLengths.begin(), stationLengths.end());
-
-  return;
-}
-
-void CrmsDatabase::putNextStation(std::vector<CrmsDataContainer *> &data,
-                                  int varid_data, int varid_time) {
-  int dimid_param;
-  int ierr = nc_inq_dimid(this->m_ncid, "numParam", &dimid_param);
-  ierr += nc_redef(this->m_ncid);
-
-  CDate dateMin, dateMax;
-
-  dateMin.fromSeconds(data.front()->datetime());
-  dateMax.fromSeconds(data.back()->datetime());
-
-  std::string minString = dateMin.toString();
-  std::string maxString = dateMax.toString();
-
-  ierr += nc_put_att_text(this->m_ncid, varid_time, "minimum",
-                          minString.length(), minString.c_str());
-  ierr += nc_put_att_text(this->m_ncid, varid_time, "maximum",
-                          maxString.length(), maxString.c_str());
-
-  ierr += nc_enddef(this->m_ncid);
-
-  size_t nData = data.size() * this->m_categoryMap.size();
-
-  long long *t = new long long[data.size()];
-  float *v = new float[nData];
-  size_t idx = 0;
-
-  for (size_t i = 0; i < data.size(); ++i) {
-    t[i] = data[i]->datetime();
-  }
-
-  for (size_t i = 0; i < this->m_categoryMap.size(); ++i) {
-    for (size_t j = 0; j < data.size(); ++j) {
-      v[idx] = data[j]->value(i);
-      idx++;
-    }
-  }
-
-  ierr += nc_put_var_longlong(this->m_ncid, varid_time, t);
-  ierr += nc_put_var_float(this->m_ncid, varid_data, v);
-
-  if (ierr != NC_NOERR) {
-    std::cout << "Error placing variable into netCDF file." << std::endl;
-  }
-
-  delete[] t;
-  delete[] v;
-  return;
-}
-
-void CrmsDatabase::openCrmsFile() {
-  this->m_file.open(this->m_databaseFile, std::ios::binary);
-  this->m_file.seekg(0, std::ios::end);
-  this->m_fileLength = static_cast<size_t>(this->m_file.tellg());
-  this->m_file.seekg(0, std::ios::beg);
-}
-
-void CrmsDatabase::closeOutputFile(size_t numStations) {
-  int ierr = nc_redef(this->m_ncid);
-  int dimid_nstation;
-  ierr += nc_def_dim(this->m_ncid, "nstation", numStations, &dimid_nstation);
-  ierr += nc_close(this->m_ncid);
-  if (ierr != NC_NOERR) {
-    std::cout << "Error: Error closing netCDF file." << std::endl;
-  }
-  return;
-}
-
-void CrmsDatabase::closeCrmsFile() {
-  if (this->m_file.is_open()) this->m_file.close();
-  return;
-}
-
-void CrmsDatabase::readHeader() {
-  std::string line;
-  size_t idx = 0;
-  std::getline(this->m_file, line);
-  line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-  std::vector<std::string> list = splitString(line);
-  for (size_t i = 0; i < list.size(); ++i) {
-    std::string s = list[i];
-    if (s != "Station ID" && s != "Date (mm/dd/yyyy)" &&
-        s != "Time (hh:mm:ss)" && s != "Time Zone" &&
-        s != "Sensor Environment" && s != "Geoid" && s != "Organization Name" &&
-        s != "Comments" && s != "Latitude" && s != "Longitude") {
-      this->m_dataCategories.push_back(s);
-      this->m_categoryMap[idx] = i;
-      idx++;
-    } else if (s == "Geoid") {
-      this->m_geoidIndex = i;
-    }
-  }
-  return;
-}
-
-CrmsDataContainer *CrmsDatabase::splitToCrmsDataContainer(
-    const std::string &line) {
-  CrmsDataContainer *d = new CrmsDataContainer(this->m_categoryMap.size());
-
-  std::vector<std::string> split = splitString(line);
-  d->setId(split[0]);
-
-  CDate date = CDate(split[1], split[2]);
-
-  int offset = 0;
-  if (split[3] == "CST") {
-    offset = 21600;
-  } else if (split[3] == "CDT") {
-    offset = 18000;
-  }
-  date.add(offset);
-  d->setDatetime(date.toSeconds());
-
-  for (size_t i = 0; i < this->m_categoryMap.size(); ++i) {
-    size_t idx = this->m_categoryMap[i];
-    if (split[idx] == "") {
-      d->setValue(i, this->fillValue());
-    } else {
-      try {
-        float v = boost::lexical_cast<float>(split[idx]);
-        // float v = std::stof(split[idx]);
-        d->setValue(i, v);
-      } catch (...) {
-        d->setValue(i, this->fillValue());
-      }
-    }
-  }
-  d->setValid(true);
-  return d;
-}
-
-bool CrmsDatabase::getNextStation(std::vector<CrmsDataContainer *> &data,
-                                  bool &finished) {
-  std::string prevname;
-  size_t n = 0;
-
-  data.reserve(this->m_maxLength);
-
-  for (;;) {
-    std::string line;
-    std::getline(this->m_file, line);
-    finished = this->m_file.eof();
-    std::streampos p = this->m_file.tellg();
-
-    if (line.size() < 10) break;
-
-    CrmsDataContainer *d = this->splitToCrmsDataContainer(line);
-
-    if (n == 0) {
-      prevname = d->id();
-    } else if (prevname != d->id()) {
-      this->m_file.seekg(p);
-      delete d;
-      break;
-    }
-
-    n++;
-    if (d->valid()) data.push_back(d);
-    if (finished) break;
-  }
-  return data.size() > 0;
-}
-
-bool CrmsDatabase::fileExists(const std::string &filename) {
-  std::ifstream ifile(filename.c_str());
-  return static_cast<bool>(ifile);
-}
-
-void CrmsDatabase::initializeOutputFile(std::vector<std::string> &stationNames,
-                                        std::vector<size_t> &length,
-                                        std::vector<int> &varid_data,
-                                        std::vector<int> &varid_time) {
-  int ierr = nc_create(this->m_outputFile.c_str(), NC_NETCDF4, &this->m_ncid);
-  int dimid_categories, dimid_stringsize, varid_cat;
-  ierr += nc_def_dim(this->m_ncid, "numParam", this->m_categoryMap.size(),
-                     &dimid_categories);
-  ierr += nc_def_dim(this->m_ncid, "stringsize", 200, &dimid_stringsize);
-  int dims[2];
-  dims[0] = dimid_categories;
-  dims[1] = dimid_stringsize;
-  ierr += nc_def_var(this->m_ncid, "sensors", NC_CHAR, 2, dims, &varid_cat);
-
-  CDate refDate;
-  refDate.fromSeconds(0);
-  std::string refstring = "seconds since " + refDate.toString() + " UTC";
-
-  for (size_t i = 0; i < stationNames.size(); ++i) {
-    std::string station_dim_string =
-        boost::str(boost::format("stationLength_%06i") % (i + 1));
-    std::string station_time_var_string =
-        boost::str(boost::format("time_station_%06i") % (i + 1));
-    std::string station_data_var_string =
-        boost::str(boost::format("data_station_%06i") % (i + 1));
-
-    int dimid_len, varid_t, varid_d;
-    ierr += nc_def_dim(this->m_ncid, station_dim_string.c_str(), length[i],
-                       &dimid_len);
-    int dims[2];
-    dims[0] = dimid_categories;
-    dims[1] = dimid_len;
-
-    ierr += nc_def_var(this->m_ncid, station_time_var_string.c_str(), NC_INT64,
-                       1, &dimid_len, &varid_t);
-    ierr += nc_def_var(this->m_ncid, station_data_var_string.c_str(), NC_FLOAT,
-                       2, dims, &varid_d);
-
-    ierr += nc_def_var_deflate(this->m_ncid, varid_t, 1, 1, 2);
-    ierr += nc_def_var_deflate(this->m_ncid, varid_d, 1, 1, 2);
-
-    ierr += nc_def_var_chunking(this->m_ncid, varid_t, NC_CONTIGUOUS, nullptr);
-    ierr += nc_def_var_chunking(this->m_ncid, varid_d, NC_CONTIGUOUS, nullptr);
-
-    ierr += nc_put_att_text(this->m_ncid, varid_d, "station_name",
-                            stationNames[i].length(), stationNames[i].c_str());
-    ierr += nc_put_att_text(this->m_ncid, varid_t, "station_name",
-                            stationNames[i].length(), stationNames[i].c_str());
-    ierr += nc_put_att_text(this->m_ncid, varid_t, "reference",
-                            refstring.length(), refstring.c_str());
-
-    float fill = this->fillValue();
-    ierr += nc_def_var_fill(this->m_ncid, varid_d, 0, &fill);
-    varid_data.push_back(varid_d);
-    varid_time.push_back(varid_t);
-  }
-
-  ierr += nc_enddef(this->m_ncid);
-
-  for (size_t i = 0; i < this->m_dataCategories.size(); ++i) {
-    std::string s = this->m_dataCategories[i];
-    const char *name = s.c_str();
-    const size_t start[2] = {i, 0};
-    const size_t count[2] = {1, s.length()};
-    ierr += nc_put_vara_text(this->m_ncid, varid_cat, start, count, name);
-  }
-
-  if (ierr != NC_NOERR) {
-    std::cout << "Error initializing netCDF output file." << std::endl;
-  }
-
-  return;
-}
-
-bool CrmsDatabase::showProgressBar() const { return this->m_showProgressBar; }
-
-void CrmsDatabase::setShowProgressBar(bool showProgressBar) {
-  this->m_showProgressBar = showProgressBar;
-}
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "crmsdatabase.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include "boost/algorithm/string/split.hpp"
+#include "boost/algorithm/string/trim.hpp"
+#include "boost/format.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/spirit/include/qi.hpp"
+#include "cdate.h"
+#include "netcdf.h"
+
+std::vector<std::string> splitString(const std::string &s) {
+  std::vector<std::string> elems;
+  boost::algorithm::split(elems, s, boost::is_any_of(","),
+                          boost::token_compress_off);
+  return elems;
+}
+
+//...Returns the start of the line following pos
+static const char *nextLine(const char *pos, const char *end) {
+  const char *eol =
+      static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+  return eol == nullptr ? end : eol + 1;
+}
+
+//...Returns the end of the line beginning at pos without its terminator
+static const char *lineEnd(const char *pos, const char *next) {
+  const char *e = next;
+  if (e > pos && e[-1] == '\n') --e;
+  if (e > pos && e[-1] == '\r') --e;
+  return e;
+}
+
+//...True when every line between begin and end is too short to be a row
+static bool onlyShortLines(const char *begin, const char *end) {
+  const char *pos = begin;
+  while (pos < end) {
+    const char *next = nextLine(pos, end);
+    if (lineEnd(pos, next) - pos >= 10) return false;
+    pos = next;
+  }
+  return true;
+}
+
+static const char *fieldEnd(const char *pos, const char *end) {
+  const char *f = static_cast<const char *>(std::memchr(pos, ',', end - pos));
+  return f == nullptr ? end : f;
+}
+
+//...Days since 1970-01-01 for a proleptic Gregorian date
+static long long daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+//...Proleptic Gregorian date for a count of days since 1970-01-01
+static void civilFromDays(long long z, int &y, int &m, int &d) {
+  z += 719468;
+  const long long era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+//...Days from 1970-01-01 to the CDate reference, 1899/12/31
+static long long referenceDays() {
+  static const long long days = daysFromCivil(1899, 12, 31);
+  return days;
+}
+
+static long long floorDiv(long long a, long long b) {
+  return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+//...Overview bucket holding a time in seconds since the CDate reference.
+//   Daily buckets count days since the reference and monthly buckets count
+//   months since year zero.
+static long long bucketIndex(long long t, int level) {
+  long long days = floorDiv(t, 86400);
+  if (level == CrmsDatabase::Daily) return days;
+  int y, m, d;
+  civilFromDays(days + referenceDays(), y, m, d);
+  return static_cast<long long>(y) * 12 + m - 1;
+}
+
+static long long bucketStart(long long index, int level) {
+  if (level == CrmsDatabase::Daily) return index * 86400;
+  long long y = floorDiv(index, 12);
+  int m = static_cast<int>(index - y * 12) + 1;
+  return (daysFromCivil(static_cast<int>(y), m, 1) - referenceDays()) * 86400;
+}
+
+static size_t bucketCount(long long minimum, long long maximum, int level) {
+  long long first = bucketIndex(minimum, level);
+  long long last = bucketIndex(maximum, level);
+  return static_cast<size_t>(std::max(first, last) - first + 1);
+}
+
+static std::string stationVariableName(const char *prefix, size_t index) {
+  return boost::str(boost::format("%s_%06i") % prefix % (index + 1));
+}
+
+//...Packs strings into the rows of a [n, width] character variable
+static std::vector<char> packStrings(const std::vector<std::string> &strings,
+                                     size_t width) {
+  std::vector<char> text(strings.size() * width, '\0');
+  for (size_t i = 0; i < strings.size(); ++i) {
+    std::copy_n(strings[i].begin(), std::min(width, strings[i].size()),
+                text.begin() + i * width);
+  }
+  return text;
+}
+
+static const char *overviewName[CrmsDatabase::NumOverviewLevels] = {"daily",
+                                                                   "monthly"};
+
+CrmsDatabase::CrmsDatabase(const std::string &datafile,
+                           const std::string &outputFile)
+    : m_databaseFile(datafile),
+      m_outputFile(outputFile),
+      m_numThreads(std::max(1u, std::thread::hardware_concurrency())),
+      m_deflateLevel(2),
+      m_chunkSize(4096),
+      m_showProgressBar(true),
+      m_previousPercentComplete(0),
+      m_progressbar(nullptr),
+      m_fileBegin(nullptr),
+      m_fileLength(0) {}
+
+double CrmsDatabase::getPercentComplete(const char *position) {
+  size_t fileposition = static_cast<size_t>(position - this->m_fileBegin);
+  double percent =
+      static_cast<double>(static_cast<long double>(fileposition) /
+                          static_cast<long double>(this->m_fileLength)) *
+      100.0;
+  if (this->m_showProgressBar) {
+    unsigned long dt = static_cast<unsigned long>(std::floor(percent)) -
+                       this->m_previousPercentComplete;
+    if (dt > 100 - this->m_previousPercentComplete) {
+      dt = 100 - this->m_previousPercentComplete;
+    }
+    if (dt > 0) {
+      *(this->m_progressbar) += dt;
+      this->m_previousPercentComplete += dt;
+    }
+  }
+  return percent;
+}
+
+const char *CrmsDatabase::mapInputFile(
+    boost::interprocess::mapped_region &region) {
+  using namespace boost::interprocess;
+  file_mapping mapping(this->m_databaseFile.c_str(), read_only);
+  mapped_region(mapping, read_only).swap(region);
+  const char *begin = static_cast<const char *>(region.get_address());
+  const char *end = begin + region.get_size();
+  this->m_fileBegin = begin;
+  this->m_fileLength = region.get_size();
+
+  const char *dataBegin = nextLine(begin, end);
+  this->readHeader(begin, lineEnd(begin, dataBegin));
+  return dataBegin;
+}
+
+void CrmsDatabase::parse() {
+  if (!this->fileExists(this->m_databaseFile)) {
+    std::cerr << "File does not exist." << std::endl;
+    return;
+  }
+
+  boost::interprocess::mapped_region region;
+  const char *dataBegin = this->mapInputFile(region);
+  const char *end = this->m_fileBegin + this->m_fileLength;
+
+  std::cout << "Indexing CRMS file..." << std::endl;
+
+  std::vector<StationBlock> stations;
+  this->indexStations(dataBegin, end, stations);
+
+  std::vector<StationVariables> vars;
+  this->initializeOutputFile(stations, vars);
+
+  std::cout << "Processing CRMS file..." << std::endl;
+
+  const size_t overviewOffset[NumOverviewLevels] = {0, 0};
+  this->processStations(stations, [&](size_t i, const StationBuffer &data) {
+    this->putNextStation(data, 0, 0, vars[i]);
+    this->putOverview(data, overviewOffset, vars[i]);
+  });
+
+  this->closeOutputFile();
+
+  return;
+}
+
+void CrmsDatabase::update() {
+  if (!this->fileExists(this->m_databaseFile) ||
+      !this->fileExists(this->m_outputFile)) {
+    std::cerr << "File does not exist." << std::endl;
+    return;
+  }
+
+  boost::interprocess::mapped_region region;
+  const char *dataBegin = this->mapInputFile(region);
+  const char *end = this->m_fileBegin + this->m_fileLength;
+
+  std::cout << "Indexing CRMS file..." << std::endl;
+
+  std::vector<StationBlock> stations;
+  this->indexStations(dataBegin, end, stations);
+
+  int ierr = nc_open(this->m_outputFile.c_str(), NC_WRITE, &this->m_ncid);
+  if (ierr != NC_NOERR) {
+    std::cerr << "Error opening the CRMS database." << std::endl;
+    return;
+  }
+
+  int dimid_param, dimid_nstation, dimid_stringsize;
+  int varid_sensors, varid_min, varid_max, varid_names;
+  size_t np, nstation, stringsize;
+  ierr += nc_inq_dimid(this->m_ncid, "numParam", &dimid_param);
+  ierr += nc_inq_dimid(this->m_ncid, "nstation", &dimid_nstation);
+  ierr += nc_inq_dimid(this->m_ncid, "stringsize", &dimid_stringsize);
+  ierr += nc_inq_dimlen(this->m_ncid, dimid_param, &np);
+  ierr += nc_inq_dimlen(this->m_ncid, dimid_nstation, &nstation);
+  ierr += nc_inq_dimlen(this->m_ncid, dimid_stringsize, &stringsize);
+  ierr += nc_inq_varid(this->m_ncid, "sensors", &varid_sensors);
+  if (ierr != NC_NOERR) {
+    std::cerr << "Error reading the CRMS database." << std::endl;
+    nc_close(this->m_ncid);
+    return;
+  }
+
+  //...Databases written before the station records could grow have fixed
+  //   length dimensions and no station table, time bounds or overviews
+  int dimid_statistic;
+  if (nc_inq_varid(this->m_ncid, "station_name", &varid_names) != NC_NOERR ||
+      nc_inq_varid(this->m_ncid, "time_minimum", &varid_min) != NC_NOERR ||
+      nc_inq_varid(this->m_ncid, "time_maximum", &varid_max) != NC_NOERR ||
+      nc_inq_dimid(this->m_ncid, "statistic", &dimid_statistic) != NC_NOERR) {
+    std::cerr << "Error: The CRMS database does not support appending. "
+                 "Rebuild it from the full CRMS file once before updating."
+              << std::endl;
+    nc_close(this->m_ncid);
+    return;
+  }
+
+  if (!this->matchDatabaseSensors(varid_sensors, np, stringsize)) {
+    nc_close(this->m_ncid);
+    return;
+  }
+
+  std::vector<long long> minimum(nstation), maximum(nstation);
+  if (nstation > 0) {
+    ierr += nc_get_var_longlong(this->m_ncid, varid_min, minimum.data());
+    ierr += nc_get_var_longlong(this->m_ncid, varid_max, maximum.data());
+  }
+
+  int nunlimited;
+  ierr += nc_inq_unlimdims(this->m_ncid, &nunlimited, nullptr);
+  std::vector<int> unlimited(static_cast<size_t>(nunlimited));
+  ierr += nc_inq_unlimdims(this->m_ncid, &nunlimited, unlimited.data());
+
+  std::vector<char> names(nstation * stringsize);
+  if (nstation > 0) {
+    ierr += nc_get_var_text(this->m_ncid, varid_names, names.data());
+  }
+  std::unordered_map<std::string, size_t> stationIndex;
+  for (size_t i = 0; i < nstation; ++i) {
+    const char *p = names.data() + i * stringsize;
+    stationIndex[std::string(p, strnlen(p, stringsize))] = i;
+  }
+
+  if (ierr != NC_NOERR) {
+    std::cerr << "Error reading the CRMS database." << std::endl;
+    nc_close(this->m_ncid);
+    return;
+  }
+
+  //...Everything that changes in the file header is defined in one pass:
+  //   new bounds for stations that receive records and the dimensions and
+  //   variables for stations that are not in the database yet
+  std::vector<StationBlock> pending;
+  std::vector<long long> first, after;
+  std::vector<size_t> offset;
+  std::vector<StationVariables> vars;
+  std::vector<std::string> newNames;
+  size_t nAdded = 0;
+
+  ierr = nc_redef(this->m_ncid);
+  for (auto &s : stations) {
+    auto it = stationIndex.find(s.name);
+    StationVariables v;
+    if (it == stationIndex.end()) {
+      size_t i = nstation + nAdded;
+      ierr += this->defineStation(i, s, dimid_param, dimid_statistic, v);
+      stationIndex[s.name] = i;
+      newNames.push_back(s.name);
+      minimum.push_back(s.minimum);
+      maximum.push_back(s.maximum);
+      first.push_back(s.minimum);
+      after.push_back(std::numeric_limits<long long>::min());
+      offset.push_back(0);
+      nAdded++;
+    } else {
+      size_t i = it->second;
+      if (s.maximum <= maximum[i]) continue;
+
+      std::string dim = stationVariableName("stationLength", i);
+      int dimid;
+      size_t len;
+      ierr += nc_inq_dimid(this->m_ncid, dim.c_str(), &dimid);
+      ierr += nc_inq_dimlen(this->m_ncid, dimid, &len);
+      ierr += this->inquireStation(i, v);
+      if (std::find(unlimited.begin(), unlimited.end(), dimid) ==
+          unlimited.end()) {
+        std::cerr << "Warning: Station " << s.name
+                  << " uses contiguous storage and cannot be extended."
+                  << std::endl;
+        continue;
+      }
+
+      first.push_back(minimum[i]);
+      after.push_back(maximum[i]);
+      offset.push_back(len);
+      maximum[i] = s.maximum;
+
+      CDate dateMax;
+      dateMax.fromSeconds(s.maximum);
+      std::string maxString = dateMax.toString();
+      ierr += nc_put_att_text(this->m_ncid, v.time, "maximum",
+                              maxString.length(), maxString.c_str());
+    }
+    pending.push_back(s);
+    vars.push_back(v);
+  }
+  ierr += nc_enddef(this->m_ncid);
+
+  if (nAdded > 0) {
+    size_t start[1] = {nstation};
+    size_t count[1] = {nAdded};
+    ierr += nc_put_vara_longlong(this->m_ncid, varid_min, start, count,
+                                 minimum.data() + nstation);
+
+    std::vector<char> text = packStrings(newNames, stringsize);
+    size_t tstart[2] = {nstation, 0};
+    size_t tcount[2] = {nAdded, stringsize};
+    ierr += nc_put_vara_text(this->m_ncid, varid_names, tstart, tcount,
+                             text.data());
+  }
+  if (!maximum.empty()) {
+    size_t start[1] = {0};
+    size_t count[1] = {maximum.size()};
+    ierr += nc_put_vara_longlong(this->m_ncid, varid_max, start, count,
+                                 maximum.data());
+  }
+
+  if (ierr != NC_NOERR) {
+    std::cerr << "Error updating the CRMS database header." << std::endl;
+    nc_close(this->m_ncid);
+    return;
+  }
+
+  std::cout << "Processing CRMS file..." << std::endl;
+
+  size_t nRecords = 0;
+  this->processStations(pending, [&](size_t i, const StationBuffer &data) {
+    const size_t n = data.time.size();
+    if (after[i] == std::numeric_limits<long long>::min()) {
+      const size_t overviewOffset[NumOverviewLevels] = {0, 0};
+      this->putNextStation(data, 0, 0, vars[i]);
+      this->putOverview(data, overviewOffset, vars[i]);
+      nRecords += n;
+      return;
+    }
+
+    //...Rows are in time order, so the new records are a suffix
+    size_t row = 0;
+    while (row < n && data.time[row] <= after[i]) {
+      row++;
+    }
+    this->putNextStation(data, row, offset[i], vars[i]);
+    nRecords += n - row;
+
+    //...The overview buckets are rebuilt from the start of the month that
+    //   held the previous last record, so the stored records from there on
+    //   are read back and joined with the new ones
+    long long from = std::max(
+        first[i], bucketStart(bucketIndex(after[i], Monthly), Monthly));
+    StationBuffer merged;
+    if (this->readStationRecords(vars[i], offset[i], from, merged) !=
+        NC_NOERR) {
+      std::cerr << "Error reading station " << pending[i].name
+                << " from the CRMS database." << std::endl;
+      return;
+    }
+
+    const size_t np = this->m_dataCategories.size();
+    const size_t nOld = merged.time.size();
+    const size_t nMerged = nOld + n - row;
+    std::vector<float> values(np * nMerged);
+    for (size_t j = 0; j < np; ++j) {
+      std::copy(merged.values.begin() + j * nOld,
+                merged.values.begin() + (j + 1) * nOld,
+                values.begin() + j * nMerged);
+      std::copy(data.values.begin() + j * n + row,
+                data.values.begin() + (j + 1) * n,
+                values.begin() + j * nMerged + nOld);
+    }
+    merged.values.swap(values);
+    merged.time.insert(merged.time.end(), data.time.begin() + row,
+                       data.time.end());
+
+    this->computeOverview(merged, from, pending[i].maximum);
+    size_t overviewOffset[NumOverviewLevels];
+    for (int level = 0; level < NumOverviewLevels; ++level) {
+      overviewOffset[level] = static_cast<size_t>(
+          bucketIndex(from, level) - bucketIndex(first[i], level));
+    }
+    this->putOverview(merged, overviewOffset, vars[i]);
+  });
+
+  this->closeOutputFile();
+
+  std::cout << "Appended " << nRecords << " records to "
+            << pending.size() - nAdded << " stations and added " << nAdded
+            << " new stations." << std::endl;
+
+  return;
+}
+
+//...Worker threads parse stations while this thread, the only one that
+//   touches the netCDF file, passes them to the writer in file order. Workers
+//   stay at most a fixed number of stations ahead of the writer so memory
+//   use does not depend on the size of the input.
+void CrmsDatabase::processStations(
+    const std::vector<StationBlock> &stations,
+    const std::function<void(size_t, const StationBuffer &)> &write) {
+  this->m_previousPercentComplete = 0;
+  if (this->m_showProgressBar) {
+    this->m_progressbar.reset(new boost::progress_display(100));
+  }
+
+  const size_t nStations = stations.size();
+  const size_t window = 4 * this->m_numThreads;
+  std::vector<std::unique_ptr<StationBuffer>> buffers(nStations);
+  std::mutex mutex;
+  std::condition_variable parsedCondition, writtenCondition;
+  size_t nextParse = 0;
+  size_t nextWrite = 0;
+
+  auto worker = [&]() {
+    for (;;) {
+      size_t i;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        writtenCondition.wait(lock, [&] {
+          return nextParse >= nStations || nextParse < nextWrite + window;
+        });
+        if (nextParse >= nStations) return;
+        i = nextParse++;
+      }
+      std::unique_ptr<StationBuffer> buffer(new StationBuffer());
+      this->parseStation(stations[i], *buffer);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffers[i] = std::move(buffer);
+      }
+      parsedCondition.notify_one();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < this->m_numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+
+  for (size_t i = 0; i < nStations; ++i) {
+    std::unique_ptr<StationBuffer> buffer;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      parsedCondition.wait(lock, [&] { return buffers[i] != nullptr; });
+      buffer = std::move(buffers[i]);
+    }
+    write(i, *buffer);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      nextWrite = i + 1;
+    }
+    writtenCondition.notify_all();
+    this->getPercentComplete(stations[i].end);
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  if (this->m_showProgressBar) {
+    this->getPercentComplete(this->m_fileBegin + this->m_fileLength);
+  }
+  return;
+}
+
+//...Splits the file into one range per thread, indexes each range in
+//   parallel and then joins station runs that straddle the range boundaries
+void CrmsDatabase::indexStations(const char *begin, const char *end,
+                                 std::vector<StationBlock> &stations) {
+  size_t nRange = this->m_numThreads;
+  size_t rangeSize = static_cast<size_t>(end - begin) / nRange + 1;
+
+  std::vector<const char *> bounds;
+  bounds.push_back(begin);
+  for (size_t i = 1; i < nRange; ++i) {
+    const char *p = begin + std::min(i * rangeSize,
+                                     static_cast<size_t>(end - begin));
+    p = p > bounds.back() ? nextLine(p - 1, end) : bounds.back();
+    bounds.push_back(p);
+  }
+  bounds.push_back(end);
+
+  std::vector<std::vector<StationBlock>> ranges(nRange);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < nRange; ++i) {
+    threads.emplace_back([&, i]() {
+      this->indexStationRange(bounds[i], bounds[i + 1], ranges[i]);
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (auto &r : ranges) {
+    for (auto &s : r) {
+      //...Short lines at the start of a range are not given to any
+      //   station, so a run continues across them into the next range
+      if (!stations.empty() && stations.back().name == s.name &&
+          onlyShortLines(stations.back().end, s.begin)) {
+        stations.back().end = s.end;
+        stations.back().length += s.length;
+      } else {
+        stations.push_back(s);
+      }
+    }
+  }
+
+  //...The time bounds are written as attributes when the file is defined,
+  //   so they are found here from the first and last rows of each station
+  threads.clear();
+  for (size_t i = 0; i < nRange; ++i) {
+    threads.emplace_back([&, i]() {
+      for (size_t j = i; j < stations.size(); j += nRange) {
+        this->findTimeBounds(stations[j]);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  return;
+}
+
+void CrmsDatabase::indexStationRange(const char *begin, const char *end,
+                                     std::vector<StationBlock> &stations) {
+  const char *pos = begin;
+  while (pos < end) {
+    const char *next = nextLine(pos, end);
+    const char *eol = lineEnd(pos, next);
+    if (eol - pos >= 10) {
+      const char *f = fieldEnd(pos, eol);
+      size_t len = static_cast<size_t>(f - pos);
+      if (stations.empty() || stations.back().name.size() != len ||
+          std::memcmp(stations.back().name.data(), pos, len) != 0) {
+        StationBlock s;
+        s.name = std::string(pos, len);
+        s.begin = pos;
+        s.end = next;
+        s.length = 0;
+        stations.push_back(s);
+      }
+      stations.back().end = next;
+      stations.back().length++;
+    } else if (!stations.empty()) {
+      stations.back().end = next;
+    }
+    pos = next;
+  }
+  return;
+}
+
+//...Uses the same rules as parseStation: a first row without a readable
+//   date starts at zero and later unreadable rows repeat the previous time,
+//   so the maximum is the last row in the block that can be read.
+void CrmsDatabase::findTimeBounds(StationBlock &station) {
+  station.minimum = 0;
+  station.maximum = 0;
+
+  const char *pos = station.begin;
+  while (pos < station.end) {
+    const char *next = nextLine(pos, station.end);
+    const char *eol = lineEnd(pos, next);
+    if (eol - pos >= 10) {
+      this->parseTime(pos, eol, station.minimum);
+      station.maximum = station.minimum;
+      break;
+    }
+    pos = next;
+  }
+
+  const char *last = station.end;
+  while (last > pos) {
+    const char *begin = last - 1;
+    while (begin > pos && begin[-1] != '\n') --begin;
+    const char *eol = lineEnd(begin, last);
+    if (eol - begin >= 10 && this->parseTime(begin, eol, station.maximum)) {
+      break;
+    }
+    last = begin;
+  }
+  return;
+}
+
+void CrmsDatabase::parseStation(const StationBlock &station,
+                                StationBuffer &buffer) {
+  const size_t n = station.length;
+  const size_t np = this->m_dataCategories.size();
+  buffer.time.resize(n);
+  buffer.values.assign(n * np, this->fillValue());
+
+  size_t row = 0;
+  const char *pos = station.begin;
+  while (pos < station.end && row < n) {
+    const char *next = nextLine(pos, station.end);
+    const char *eol = lineEnd(pos, next);
+    if (eol - pos >= 10) {
+      long long t;
+      if (!this->parseRow(pos, eol, t, &buffer.values[row], n)) {
+        //...Keep the time axis monotonic if a date cannot be read
+        t = row > 0 ? buffer.time[row - 1] : 0;
+      }
+      buffer.time[row] = t;
+      row++;
+    }
+    pos = next;
+  }
+
+  this->computeOverview(buffer, station.minimum, station.maximum);
+  return;
+}
+
+//...Builds the overview levels for the buckets from the one holding minimum
+//   to the one holding maximum. The output is laid out as
+//   [statistic, numParam, bucket] with empty buckets left at the fill value.
+void CrmsDatabase::computeOverview(StationBuffer &data, long long minimum,
+                                   long long maximum) {
+  const size_t n = data.time.size();
+  const size_t np = this->m_dataCategories.size();
+  const float fill = this->fillValue();
+  std::vector<long long> bucket(n);
+
+  for (int level = 0; level < NumOverviewLevels; ++level) {
+    const long long first = bucketIndex(minimum, level);
+    const size_t nb = bucketCount(minimum, maximum, level);
+
+    std::vector<long long> &time = data.overviewTime[level];
+    time.resize(nb);
+    for (size_t b = 0; b < nb; ++b) {
+      time[b] = bucketStart(first + static_cast<long long>(b), level);
+    }
+
+    for (size_t r = 0; r < n; ++r) {
+      bucket[r] = bucketIndex(data.time[r], level) - first;
+    }
+
+    std::vector<float> &overview = data.overview[level];
+    overview.assign(3 * np * nb, fill);
+    std::vector<double> sum(nb);
+    std::vector<size_t> count(nb);
+
+    for (size_t p = 0; p < np; ++p) {
+      float *vmin = &overview[p * nb];
+      float *vmax = &overview[(np + p) * nb];
+      float *vmean = &overview[(2 * np + p) * nb];
+      const float *v = &data.values[p * n];
+      std::fill(sum.begin(), sum.end(), 0.0);
+      std::fill(count.begin(), count.end(), 0);
+
+      for (size_t r = 0; r < n; ++r) {
+        const long long b = bucket[r];
+        if (b < 0 || b >= static_cast<long long>(nb) || v[r] == fill) {
+          continue;
+        }
+        if (count[b] == 0) {
+          vmin[b] = v[r];
+          vmax[b] = v[r];
+        } else {
+          vmin[b] = std::min(vmin[b], v[r]);
+          vmax[b] = std::max(vmax[b], v[r]);
+        }
+        sum[b] += v[r];
+        count[b]++;
+      }
+
+      for (size_t b = 0; b < nb; ++b) {
+        if (count[b] > 0) {
+          vmean[b] = static_cast<float>(sum[b] / static_cast<double>(count[b]));
+        }
+      }
+    }
+  }
+  return;
+}
+
+//...Parses one row in place. Data values are written with the given stride
+//   so that each parameter lands in its own contiguous row of the buffer.
+//   Empty or malformed cells keep the fill value.
+bool CrmsDatabase::parseRow(const char *begin, const char *end,
+                            long long &time, float *values, size_t stride) {
+  namespace qi = boost::spirit::qi;
+  const char *pos = begin;
+  for (size_t column = 0;; ++column) {
+    const char *f = fieldEnd(pos, end);
+    const char *p = pos;
+    if (column > 3 && column < this->m_columnCategory.size() &&
+        this->m_columnCategory[column] >= 0) {
+      float v;
+      if (p != f && qi::parse(p, f, qi::float_, v) && p == f) {
+        values[this->m_columnCategory[column] * stride] = v;
+      }
+    }
+    if (f == end) break;
+    pos = f + 1;
+  }
+  return this->parseTime(begin, end, time);
+}
+
+//...Reads the date, time and time zone columns of a row
+bool CrmsDatabase::parseTime(const char *begin, const char *end,
+                             long long &time) {
+  namespace qi = boost::spirit::qi;
+  int month = 0, day = 0, year = 0, hour = 0, minute = 0, second = 0;
+  long long offset = 0;
+  bool dateOk = false, timeOk = false;
+
+  const char *pos = begin;
+  for (size_t column = 0; column < 4; ++column) {
+    const char *f = fieldEnd(pos, end);
+    const char *p = pos;
+    if (column == 1) {
+      dateOk = qi::parse(p, f, qi::int_ >> '/' >> qi::int_ >> '/' >> qi::int_,
+                         month, day, year);
+    } else if (column == 2) {
+      timeOk = qi::parse(p, f, qi::int_ >> ':' >> qi::int_ >> ':' >> qi::int_,
+                         hour, minute, second);
+    } else if (column == 3) {
+      if (f - pos == 3 && std::memcmp(pos, "CST", 3) == 0) {
+        offset = 21600;
+      } else if (f - pos == 3 && std::memcmp(pos, "CDT", 3) == 0) {
+        offset = 18000;
+      }
+    }
+    if (f == end) break;
+    pos = f + 1;
+  }
+
+  if (!dateOk || !timeOk) return false;
+
+  //...Times are stored relative to the CDate reference, 1899/12/31, to
+  //   match the reference attribute written for each station
+  time = (daysFromCivil(year, month, day) - referenceDays()) * 86400 +
+         hour * 3600 + minute * 60 + second + offset;
+  return true;
+}
+
+//...Writes the rows of a parsed station from firstRow onwards, starting at
+//   the given record of the station variables
+void CrmsDatabase::putNextStation(const StationBuffer &data, size_t firstRow,
+                                  size_t offset,
+                                  const StationVariables &vars) {
+  const size_t n = data.time.size();
+  const size_t np = this->m_dataCategories.size();
+  if (firstRow >= n) return;
+  const size_t nt = n - firstRow;
+
+  size_t tstart[1] = {offset};
+  size_t tcount[1] = {nt};
+  size_t start[2] = {0, offset};
+  size_t count[2] = {np, nt};
+
+  int ierr = nc_put_vara_longlong(this->m_ncid, vars.time, tstart, tcount,
+                                  &data.time[firstRow]);
+  if (firstRow == 0) {
+    ierr += nc_put_vara_float(this->m_ncid, vars.data, start, count,
+                              data.values.data());
+  } else {
+    std::vector<float> values(np * nt);
+    for (size_t i = 0; i < np; ++i) {
+      std::copy(data.values.begin() + i * n + firstRow,
+                data.values.begin() + (i + 1) * n, values.begin() + i * nt);
+    }
+    ierr += nc_put_vara_float(this->m_ncid, vars.data, start, count,
+                              values.data());
+  }
+
+  if (ierr != NC_NOERR) {
+    std::cout << "Error placing variable into netCDF file." << std::endl;
+  }
+
+  return;
+}
+
+//...Writes the overview levels of a station starting at the given bucket
+//   of each level
+void CrmsDatabase::putOverview(const StationBuffer &data, const size_t *offset,
+                               const StationVariables &vars) {
+  const size_t np = this->m_dataCategories.size();
+  int ierr = NC_NOERR;
+  for (int level = 0; level < NumOverviewLevels; ++level) {
+    const size_t nb = data.overviewTime[level].size();
+    if (nb == 0) continue;
+    size_t tstart[1] = {offset[level]};
+    size_t tcount[1] = {nb};
+    size_t start[3] = {0, 0, offset[level]};
+    size_t count[3] = {3, np, nb};
+    ierr += nc_put_vara_longlong(this->m_ncid, vars.overviewTime[level],
+                                 tstart, tcount,
+                                 data.overviewTime[level].data());
+    ierr += nc_put_vara_float(this->m_ncid, vars.overview[level], start, count,
+                              data.overview[level].data());
+  }
+
+  if (ierr != NC_NOERR) {
+    std::cout << "Error placing overview into netCDF file." << std::endl;
+  }
+
+  return;
+}
+
+//...Reads back the stored records of a station from the first one at or
+//   after the given time
+int CrmsDatabase::readStationRecords(const StationVariables &vars,
+                                     size_t length, long long from,
+                                     StationBuffer &data) {
+  size_t lo = 0, hi = length;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    long long t;
+    int ierr = nc_get_var1_longlong(this->m_ncid, vars.time, &mid, &t);
+    if (ierr != NC_NOERR) return ierr;
+    if (t < from) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  const size_t np = this->m_dataCategories.size();
+  const size_t n = length - lo;
+  data.time.resize(n);
+  data.values.resize(np * n);
+  if (n == 0) return NC_NOERR;
+
+  size_t tstart[1] = {lo};
+  size_t tcount[1] = {n};
+  size_t start[2] = {0, lo};
+  size_t count[2] = {np, n};
+  int ierr = nc_get_vara_longlong(this->m_ncid, vars.time, tstart, tcount,
+                                  data.time.data());
+  ierr += nc_get_vara_float(this->m_ncid, vars.data, start, count,
+                            data.values.data());
+  return ierr;
+}
+
+void CrmsDatabase::closeOutputFile() {
+  int ierr = nc_close(this->m_ncid);
+  if (ierr != NC_NOERR) {
+    std::cout << "Error: Error closing netCDF file." << std::endl;
+  }
+  return;
+}
+
+void CrmsDatabase::readHeader(const char *begin, const char *end) {
+  std::string line(begin, end);
+  size_t idx = 0;
+  std::vector<std::string> list = splitString(line);
+  this->m_columnCategory.assign(list.size(), -1);
+  for (size_t i = 0; i < list.size(); ++i) {
+    std::string s = list[i];
+    if (s != "Station ID" && s != "Date (mm/dd/yyyy)" &&
+        s != "Time (hh:mm:ss)" && s != "Time Zone" &&
+        s != "Sensor Environment" && s != "Geoid" && s != "Organization Name" &&
+        s != "Comments" && s != "Latitude" && s != "Longitude") {
+      this->m_dataCategories.push_back(s);
+      this->m_columnCategory[i] = static_cast<int>(idx);
+      idx++;
+    } else if (s == "Geoid") {
+      this->m_geoidIndex = i;
+    }
+  }
+  return;
+}
+
+bool CrmsDatabase::fileExists(const std::string &filename) {
+  std::ifstream ifile(filename.c_str());
+  return static_cast<bool>(ifile);
+}
+
+void CrmsDatabase::initializeOutputFile(
+    const std::vector<StationBlock> &stations,
+    std::vector<StationVariables> &vars) {
+  int ierr = nc_create(this->m_outputFile.c_str(), NC_NETCDF4, &this->m_ncid);
+  int dimid_categories, dimid_stringsize, dimid_nstation, dimid_statistic;
+  int varid_cat, varid_names;
+  int varid_min, varid_max;
+  ierr += nc_def_dim(this->m_ncid, "numParam", this->m_dataCategories.size(),
+                     &dimid_categories);
+  ierr += nc_def_dim(this->m_ncid, "nstation", NC_UNLIMITED, &dimid_nstation);
+  ierr += nc_def_dim(this->m_ncid, "stringsize", 200, &dimid_stringsize);
+  ierr += nc_def_dim(this->m_ncid, "statistic", 3, &dimid_statistic);
+  int dims[2];
+  dims[0] = dimid_categories;
+  dims[1] = dimid_stringsize;
+  ierr += nc_def_var(this->m_ncid, "sensors", NC_CHAR, 2, dims, &varid_cat);
+
+  //...Station names in index order so that readers can build the name to
+  //   index table with a single read
+  dims[0] = dimid_nstation;
+  ierr += nc_def_var(this->m_ncid, "station_name", NC_CHAR, 2, dims,
+                     &varid_names);
+
+  //...Time bounds of each station, used to find new records in update mode
+  ierr += nc_def_var(this->m_ncid, "time_minimum", NC_INT64, 1,
+                     &dimid_nstation, &varid_min);
+  ierr += nc_def_var(this->m_ncid, "time_maximum", NC_INT64, 1,
+                     &dimid_nstation, &varid_max);
+
+  std::vector<long long> minimum, maximum;
+  std::vector<std::string> names;
+  minimum.reserve(stations.size());
+  maximum.reserve(stations.size());
+  names.reserve(stations.size());
+
+  for (size_t i = 0; i < stations.size(); ++i) {
+    StationVariables v;
+    ierr += this->defineStation(i, stations[i], dimid_categories,
+                                dimid_statistic, v);
+    vars.push_back(v);
+    minimum.push_back(stations[i].minimum);
+    maximum.push_back(stations[i].maximum);
+    names.push_back(stations[i].name);
+  }
+
+  ierr += nc_enddef(this->m_ncid);
+
+  if (!this->m_dataCategories.empty()) {
+    std::vector<char> text = packStrings(this->m_dataCategories, 200);
+    const size_t start[2] = {0, 0};
+    const size_t count[2] = {this->m_dataCategories.size(), 200};
+    ierr += nc_put_vara_text(this->m_ncid, varid_cat, start, count,
+                             text.data());
+  }
+
+  if (!stations.empty()) {
+    const size_t start[1] = {0};
+    const size_t count[1] = {stations.size()};
+    ierr += nc_put_vara_longlong(this->m_ncid, varid_min, start, count,
+                                 minimum.data());
+    ierr += nc_put_vara_longlong(this->m_ncid, varid_max, start, count,
+                                 maximum.data());
+
+    std::vector<char> text = packStrings(names, 200);
+    const size_t tstart[2] = {0, 0};
+    const size_t tcount[2] = {stations.size(), 200};
+    ierr += nc_put_vara_text(this->m_ncid, varid_names, tstart, tcount,
+                             text.data());
+  }
+
+  if (ierr != NC_NOERR) {
+    std::cout << "Error initializing netCDF output file." << std::endl;
+  }
+
+  return;
+}
+
+//...Defines the dimensions, variables and attributes for one station. With
+//   chunked storage the record dimensions are unlimited so that update mode
+//   can append to them later.
+int CrmsDatabase::defineStation(size_t index, const StationBlock &station,
+                                int dimid_param, int dimid_statistic,
+                                StationVariables &vars) {
+  std::string station_dim_string = stationVariableName("stationLength", index);
+  std::string station_time_var_string =
+      stationVariableName("time_station", index);
+  std::string station_data_var_string =
+      stationVariableName("data_station", index);
+
+  CDate refDate;
+  refDate.fromSeconds(0);
+  std::string refstring = "seconds since " + refDate.toString() + " UTC";
+
+  int dimid_len;
+  size_t len = this->m_chunkSize > 0 ? NC_UNLIMITED : station.length;
+  int ierr = nc_def_dim(this->m_ncid, station_dim_string.c_str(), len,
+                        &dimid_len);
+  int dims[2];
+  dims[0] = dimid_param;
+  dims[1] = dimid_len;
+
+  ierr += nc_def_var(this->m_ncid, station_time_var_string.c_str(), NC_INT64,
+                     1, &dimid_len, &vars.time);
+  ierr += nc_def_var(this->m_ncid, station_data_var_string.c_str(), NC_FLOAT,
+                     2, dims, &vars.data);
+
+  const size_t np = this->m_dataCategories.size();
+  ierr += this->defineStorage(vars.time, {station.length});
+  ierr += this->defineStorage(vars.data, {np, station.length});
+
+  ierr += nc_put_att_text(this->m_ncid, vars.data, "station_name",
+                          station.name.length(), station.name.c_str());
+  ierr += nc_put_att_text(this->m_ncid, vars.time, "station_name",
+                          station.name.length(), station.name.c_str());
+  ierr += nc_put_att_text(this->m_ncid, vars.time, "reference",
+                          refstring.length(), refstring.c_str());
+
+  CDate dateMin, dateMax;
+  dateMin.fromSeconds(station.minimum);
+  dateMax.fromSeconds(station.maximum);
+  std::string minString = dateMin.toString();
+  std::string maxString = dateMax.toString();
+  ierr += nc_put_att_text(this->m_ncid, vars.time, "minimum",
+                          minString.length(), minString.c_str());
+  ierr += nc_put_att_text(this->m_ncid, vars.time, "maximum",
+                          maxString.length(), maxString.c_str());
+
+  float fill = this->fillValue();
+  ierr += nc_def_var_fill(this->m_ncid, vars.data, 0, &fill);
+
+  //...Overview levels, each with its own time axis of bucket start times
+  const std::string statistics = "minimum maximum mean";
+  for (int level = 0; level < NumOverviewLevels; ++level) {
+    const std::string name = overviewName[level];
+    std::string dim = stationVariableName((name + "Length").c_str(), index);
+    std::string tvar =
+        stationVariableName((name + "_time_station").c_str(), index);
+    std::string dvar = stationVariableName((name + "_station").c_str(), index);
+
+    size_t nb = bucketCount(station.minimum, station.maximum, level);
+    int dimid_bucket;
+    ierr += nc_def_dim(this->m_ncid, dim.c_str(),
+                       this->m_chunkSize > 0 ? NC_UNLIMITED : nb,
+                       &dimid_bucket);
+    int odims[3];
+    odims[0] = dimid_statistic;
+    odims[1] = dimid_param;
+    odims[2] = dimid_bucket;
+
+    ierr += nc_def_var(this->m_ncid, tvar.c_str(), NC_INT64, 1, &dimid_bucket,
+                       &vars.overviewTime[level]);
+    ierr += nc_def_var(this->m_ncid, dvar.c_str(), NC_FLOAT, 3, odims,
+                       &vars.overview[level]);
+    ierr += this->defineStorage(vars.overviewTime[level], {nb});
+    ierr += this->defineStorage(vars.overview[level], {3, np, nb});
+
+    ierr += nc_put_att_text(this->m_ncid, vars.overviewTime[level],
+                            "reference", refstring.length(),
+                            refstring.c_str());
+    ierr += nc_put_att_text(this->m_ncid, vars.overview[level], "station_name",
+                            station.name.length(), station.name.c_str());
+    ierr += nc_put_att_text(this->m_ncid, vars.overview[level], "statistics",
+                            statistics.length(), statistics.c_str());
+    ierr += nc_def_var_fill(this->m_ncid, vars.overview[level], 0, &fill);
+  }
+
+  return ierr;
+}
+
+//...Applies the chunking and compression settings to a variable. The last
+//   entry of chunk is the current length of its record dimension.
+//   Compression needs chunked storage, so a chunk size of zero gives
+//   contiguous, uncompressed variables.
+int CrmsDatabase::defineStorage(int varid, std::vector<size_t> chunk) {
+  int ierr;
+  if (this->m_chunkSize > 0) {
+    chunk.back() = std::max(static_cast<size_t>(1),
+                            std::min(this->m_chunkSize, chunk.back()));
+    ierr = nc_def_var_chunking(this->m_ncid, varid, NC_CHUNKED, chunk.data());
+    if (this->m_deflateLevel > 0) {
+      ierr += nc_def_var_deflate(this->m_ncid, varid, 1, 1,
+                                 this->m_deflateLevel);
+    }
+  } else {
+    ierr = nc_def_var_chunking(this->m_ncid, varid, NC_CONTIGUOUS, nullptr);
+  }
+  return ierr;
+}
+
+int CrmsDatabase::inquireStation(size_t index, StationVariables &vars) {
+  int ierr = nc_inq_varid(this->m_ncid,
+                          stationVariableName("time_station", index).c_str(),
+                          &vars.time);
+  ierr += nc_inq_varid(this->m_ncid,
+                       stationVariableName("data_station", index).c_str(),
+                       &vars.data);
+  for (int level = 0; level < NumOverviewLevels; ++level) {
+    const std::string name = overviewName[level];
+    std::string tvar =
+        stationVariableName((name + "_time_station").c_str(), index);
+    std::string dvar = stationVariableName((name + "_station").c_str(), index);
+    ierr += nc_inq_varid(this->m_ncid, tvar.c_str(),
+                         &vars.overviewTime[level]);
+    ierr += nc_inq_varid(this->m_ncid, dvar.c_str(), &vars.overview[level]);
+  }
+  return ierr;
+}
+
+//...Points the data columns of the input file at the parameter rows of an
+//   existing database. Columns the database does not have are skipped.
+bool CrmsDatabase::matchDatabaseSensors(int varid_sensors, size_t numParam,
+                                        size_t stringsize) {
+  std::vector<char> text(numParam * stringsize);
+  if (numParam > 0 &&
+      nc_get_var_text(this->m_ncid, varid_sensors, text.data()) != NC_NOERR) {
+    std::cerr << "Error reading the CRMS database sensors." << std::endl;
+    return false;
+  }
+
+  std::unordered_map<std::string, int> sensorIndex;
+  std::vector<std::string> sensors;
+  for (size_t i = 0; i < numParam; ++i) {
+    const char *p = text.data() + i * stringsize;
+    sensors.push_back(std::string(p, strnlen(p, stringsize)));
+    sensorIndex[sensors.back()] = static_cast<int>(i);
+  }
+
+  for (auto &c : this->m_columnCategory) {
+    if (c < 0) continue;
+    const std::string &name = this->m_dataCategories[c];
+    auto it = sensorIndex.find(name);
+    if (it == sensorIndex.end()) {
+      std::cerr << "Warning: Sensor \"" << name
+                << "\" is not in the database and will be skipped."
+                << std::endl;
+      c = -1;
+    } else {
+      c = it->second;
+    }
+  }
+
+  this->m_dataCategories = sensors;
+  return true;
+}
+
+bool CrmsDatabase::showProgressBar() const { return this->m_showProgressBar; }
+
+size_t CrmsDatabase::numThreads() const { return this->m_numThreads; }
+
+void CrmsDatabase::setNumThreads(size_t numThreads) {
+  this->m_numThreads = std::max(static_cast<size_t>(1), numThreads);
+}
+
+int CrmsDatabase::deflateLevel() const { return this->m_deflateLevel; }
+
+void CrmsDatabase::setDeflateLevel(int deflateLevel) {
+  this->m_deflateLevel = std::min(9, std::max(0, deflateLevel));
+}
+
+size_t CrmsDatabase::chunkSize() const { return this->m_chunkSize; }
+
+void CrmsDatabase::setChunkSize(size_t chunkSize) {
+  this->m_chunkSize = chunkSize;
+}
+
+void CrmsDatabase::setShowProgressBar(bool showProgressBar) {
+  this->m_showProgressBar = showProgressBar;
+}
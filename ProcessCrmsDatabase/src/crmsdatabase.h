@@ -1,77 +1,140 @@
-/*-------------------------------GPL-------------------------------------//
-//
-// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
-// Copyright (C) 2018  Zach Cobell
-//
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program.  If not, see <http://www.gnu.org/licenses/>.
-//
-//-----------------------------------------------------------------------*/
-#ifndef CRMSDATABASE_H
-#define CRMSDATABASE_H
-
-#include <fstream>
-#include <memory>
-#include <string>
-#include <unordered_map>
-#include <vector>
-#include "boost/progress.hpp"
-#include "crmsdatacontainer.h"
-
-class CrmsDatabase {
- public:
-  explicit CrmsDatabase(const std::string &datafile,
-                        const std::string &outputFile);
-
-  bool showProgressBar() const;
-  void setShowProgressBar(bool showProgressBar);
-
-  static constexpr float fillValue() { return -9999.0f; }
-
-  void parse();
-
- private:
-  double getPercentComplete();
-  void readHeader();
-  void openCrmsFile();
-  void prereadCrmsFile(std::vector<std::string> &stationNames,
-                       std::vector<size_t> &stationLengths);
-  void closeCrmsFile();
-  CrmsDataContainer *splitToCrmsDataContainer(const std::string &line);
-  bool getNextStation(std::vector<CrmsDataContainer *> &data, bool &finished);
-  void putNextStation(std::vector<CrmsDataContainer *> &data, int varid_data,
-                      int varid_time);
-  void initializeOutputFile(std::vector<std::string> &stationNames,
-                            std::vector<size_t> &length,
-                            std::vector<int> &varid_data,
-                            std::vector<int> &varid_time);
-  void closeOutputFile(size_t numStations);
-  bool fileExists(const std::string &filename);
-  void deleteCrmsObjects(const std::vector<CrmsDataContainer *> &data);
-
-  std::string m_databaseFile;
-  std::string m_outputFile;
-  std::ifstream m_file;
-  size_t m_geoidIndex;
-  int m_ncid;
-  size_t m_maxLength;
-  bool m_showProgressBar;
-  unsigned long m_previousPercentComplete;
-  std::unique_ptr<boost::progress_display> m_progressbar;
-  std::vector<std::string> m_dataCategories;
-  std::vector<std::string> m_stationNames;
-  std::unordered_map<size_t, size_t> m_categoryMap;
-  size_t m_fileLength;
-};
-
-#endif  // CRMSDATABASE_H
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2018  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef CRMSDATABASE_H
+#define CRMSDATABASE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/progress.hpp"
+
+class CrmsDatabase {
+ public:
+  explicit CrmsDatabase(const std::string &datafile,
+                        const std::string &outputFile);
+
+  bool showProgressBar() const;
+  void setShowProgressBar(bool showProgressBar);
+
+  size_t numThreads() const;
+  void setNumThreads(size_t numThreads);
+
+  int deflateLevel() const;
+  void setDeflateLevel(int deflateLevel);
+
+  size_t chunkSize() const;
+  void setChunkSize(size_t chunkSize);
+
+  static constexpr float fillValue() { return -9999.0f; }
+
+  //...Downsampled levels written next to the full record of each station.
+  //   Each holds the minimum, maximum and mean of every parameter per bucket.
+  enum OverviewLevel { Daily, Monthly, NumOverviewLevels };
+
+  void parse();
+
+  //...Appends the records in the input file that are newer than those
+  //   already in an existing database and adds any stations it does not
+  //   yet contain. The output file is modified in place.
+  void update();
+
+ private:
+  //...Contiguous run of rows in the mapped file belonging to one station
+  struct StationBlock {
+    std::string name;
+    const char *begin;
+    const char *end;
+    size_t length;
+    long long minimum;
+    long long maximum;
+  };
+
+  //...Parsed values for one station. Values are stored parameter-major so
+  //   the buffer can be written directly as [numParam, stationLength].
+  struct StationBuffer {
+    std::vector<long long> time;
+    std::vector<float> values;
+    std::vector<long long> overviewTime[NumOverviewLevels];
+    std::vector<float> overview[NumOverviewLevels];
+  };
+
+  //...netCDF ids of the variables belonging to one station
+  struct StationVariables {
+    int time;
+    int data;
+    int overviewTime[NumOverviewLevels];
+    int overview[NumOverviewLevels];
+  };
+
+  double getPercentComplete(const char *position);
+  const char *mapInputFile(boost::interprocess::mapped_region &region);
+  void readHeader(const char *begin, const char *end);
+  void indexStations(const char *begin, const char *end,
+                     std::vector<StationBlock> &stations);
+  void indexStationRange(const char *begin, const char *end,
+                         std::vector<StationBlock> &stations);
+  void findTimeBounds(StationBlock &station);
+  void parseStation(const StationBlock &station, StationBuffer &buffer);
+  bool parseTime(const char *begin, const char *end, long long &time);
+  void computeOverview(StationBuffer &data, long long minimum,
+                       long long maximum);
+  bool parseRow(const char *begin, const char *end, long long &time,
+                float *values, size_t stride);
+  void processStations(
+      const std::vector<StationBlock> &stations,
+      const std::function<void(size_t, const StationBuffer &)> &write);
+  void putNextStation(const StationBuffer &data, size_t firstRow,
+                      size_t offset, const StationVariables &vars);
+  void putOverview(const StationBuffer &data, const size_t *offset,
+                   const StationVariables &vars);
+  int readStationRecords(const StationVariables &vars, size_t length,
+                         long long from, StationBuffer &data);
+  void initializeOutputFile(const std::vector<StationBlock> &stations,
+                            std::vector<StationVariables> &vars);
+  int defineStation(size_t index, const StationBlock &station,
+                    int dimid_param, int dimid_statistic,
+                    StationVariables &vars);
+  int defineStorage(int varid, std::vector<size_t> chunk);
+  int inquireStation(size_t index, StationVariables &vars);
+  bool matchDatabaseSensors(int varid_sensors, size_t numParam,
+                            size_t stringsize);
+  void closeOutputFile();
+  bool fileExists(const std::string &filename);
+
+  std::string m_databaseFile;
+  std::string m_outputFile;
+  size_t m_geoidIndex;
+  int m_ncid;
+  size_t m_numThreads;
+  int m_deflateLevel;
+  size_t m_chunkSize;
+  bool m_showProgressBar;
+  unsigned long m_previousPercentComplete;
+  std::unique_ptr<boost::progress_display> m_progressbar;
+  std::vector<std::string> m_dataCategories;
+  std::vector<int> m_columnCategory;
+  const char *m_fileBegin;
+  size_t m_fileLength;
+};
+
+#endif  // CRMSDATABASE_H
@@ -17,21 +17,44 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 //-----------------------------------------------------------------------*/
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include "crmsdatabase.h"
 
 int main(int argc, char *argv[]) {
-  if (argc != 3) {
-    std::cerr << "Usage: ./processCrmsDatabase [input] [output]" << std::endl;
+  bool update = argc > 1 && std::string(argv[1]) == "--update";
+  int narg = update ? argc - 1 : argc;
+  char **args = update ? argv + 1 : argv;
+
+  if (narg != 3 && narg != 5) {
+    std::cerr << "Usage: ./processCrmsDatabase <--update> [input] [output] "
+                 "<deflate level> <chunk size>"
+              << std::endl;
+    std::cerr << "  --update:      append the input file to an existing "
+                 "output database"
+              << std::endl;
+    std::cerr << "  deflate level: 0-9, default 2" << std::endl;
+    std::cerr << "  chunk size:    records per chunk, 0 for contiguous "
+                 "storage, default 4096"
+              << std::endl;
     return 1;
   }
 
-  std::string input = argv[1];
-  std::string output = argv[2];
+  std::string input = args[1];
+  std::string output = args[2];
 
   CrmsDatabase crms(input,output);
-  crms.parse();
+  if (narg == 5) {
+    crms.setDeflateLevel(std::atoi(args[3]));
+    crms.setChunkSize(std::strtoul(args[4], nullptr, 10));
+  }
+
+  if (update) {
+    crms.update();
+  } else {
+    crms.parse();
+  }
 
   return 0;
 }
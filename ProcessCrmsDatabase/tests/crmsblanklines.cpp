@@ -0,0 +1,90 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "crmsdatabase.h"
+#include "netcdf.h"
+
+//...A block of blank lines inside one station's record must not split the
+//   station when a thread's range starts inside the block
+
+static void writeRows(std::ofstream &f, const std::string &station,
+                      int first, int nrows) {
+  char line[128];
+  for (int i = first; i < first + nrows; ++i) {
+    std::snprintf(line, sizeof(line),
+                  "%s,01/%02d/2000,%02d:00:00,CST,Water,1.5,G12A,2.0\n",
+                  station.c_str(), 1 + i / 24, i % 24);
+    f << line;
+  }
+}
+
+static bool checkOutput(const std::string &filename, size_t threads) {
+  int ncid, dimid;
+  size_t nstation, length;
+  if (nc_open(filename.c_str(), NC_NOWRITE, &ncid) != NC_NOERR) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return false;
+  }
+  nc_inq_dimid(ncid, "nstation", &dimid);
+  nc_inq_dimlen(ncid, dimid, &nstation);
+  nc_inq_dimid(ncid, "stationLength_000001", &dimid);
+  nc_inq_dimlen(ncid, dimid, &length);
+  nc_close(ncid);
+
+  if (nstation != 2 || length != 600) {
+    std::cerr << threads << " threads: " << nstation << " stations, "
+              << length << " rows in the first station" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  const std::string input = "crms_blanklines.csv";
+  const std::string output = "crms_blanklines.nc";
+
+  std::ofstream f(input, std::ios::binary);
+  f << "Station ID,Date (mm/dd/yyyy),Time (hh:mm:ss),Time Zone,"
+       "Sensor Environment,Adjusted Salinity (ppt),Geoid,"
+       "Adjusted Water Level (ft)\n";
+  writeRows(f, "CRMS0001-H01", 0, 300);
+  f << std::string(20000, '\n');
+  writeRows(f, "CRMS0001-H01", 300, 300);
+  writeRows(f, "CRMS0002-H01", 0, 100);
+  f.close();
+
+  bool pass = true;
+  for (size_t threads = 1; threads <= 8; ++threads) {
+    std::remove(output.c_str());
+    CrmsDatabase crms(input, output);
+    crms.setShowProgressBar(false);
+    crms.setNumThreads(threads);
+    crms.parse();
+    pass = checkOutput(output, threads) && pass;
+  }
+
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "chunkdownloader.h"
+#include <QEventLoop>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <algorithm>
+
+ChunkDownloader::ChunkDownloader(QNetworkAccessManager *manager,
+                                 QObject *parent)
+    : QObject(parent),
+      m_manager(manager),
+      m_maxConcurrent(4),
+      m_maxConcurrentPerHost(0),
+      m_maxRetries(3),
+      m_retryDelay(1000),
+      m_maxRedirects(5),
+      m_transferTimeout(60000),
+      m_inFlight(0),
+      m_complete(0),
+      m_bytesReceived(0),
+      m_running(false) {
+  if (this->m_manager == nullptr)
+    this->m_manager = new QNetworkAccessManager(this);
+}
+
+int ChunkDownloader::maxConcurrent() const { return this->m_maxConcurrent; }
+
+void ChunkDownloader::setMaxConcurrent(int maxConcurrent) {
+  this->m_maxConcurrent = std::max(1, maxConcurrent);
+}
+
+int ChunkDownloader::maxConcurrentPerHost() const {
+  return this->m_maxConcurrentPerHost;
+}
+
+//...A value of zero (the default) leaves only the global limit in place
+void ChunkDownloader::setMaxConcurrentPerHost(int maxConcurrentPerHost) {
+  this->m_maxConcurrentPerHost = std::max(0, maxConcurrentPerHost);
+}
+
+int ChunkDownloader::maxRetries() const { return this->m_maxRetries; }
+
+void ChunkDownloader::setMaxRetries(int maxRetries) {
+  this->m_maxRetries = std::max(0, maxRetries);
+}
+
+int ChunkDownloader::retryDelay() const { return this->m_retryDelay; }
+
+void ChunkDownloader::setRetryDelay(int msec) {
+  this->m_retryDelay = std::max(0, msec);
+}
+
+int ChunkDownloader::maxRedirects() const { return this->m_maxRedirects; }
+
+void ChunkDownloader::setMaxRedirects(int maxRedirects) {
+  this->m_maxRedirects = std::max(0, maxRedirects);
+}
+
+int ChunkDownloader::transferTimeout() const {
+  return this->m_transferTimeout;
+}
+
+//...Milliseconds a request may go without receiving any data. Zero waits
+//   forever
+void ChunkDownloader::setTransferTimeout(int msec) {
+  this->m_transferTimeout = std::max(0, msec);
+}
+
+bool ChunkDownloader::isRunning() const { return this->m_running; }
+
+QVector<QByteArray> ChunkDownloader::results() const {
+  return this->m_results;
+}
+
+//...Hands the response for a finished request to the caller and releases
+//   the copy held here, so long batches do not accumulate every response
+QByteArray ChunkDownloader::takeResult(int index) {
+  QByteArray r;
+  if (index >= 0 && index < this->m_results.size())
+    std::swap(r, this->m_results[index]);
+  return r;
+}
+
+qint64 ChunkDownloader::bytesReceived() const {
+  return this->m_bytesReceived;
+}
+
+bool ChunkDownloader::succeeded(int index) const {
+  return this->m_succeeded.value(index, false);
+}
+
+int ChunkDownloader::numFailed() const {
+  return this->m_succeeded.count(false);
+}
+
+QString ChunkDownloader::errorString() const { return this->m_errorString; }
+
+//...Begins downloading without blocking. finished() is emitted once every
+//   request has either succeeded or exhausted its retries.
+void ChunkDownloader::start(const QVector<QUrl> &urls) {
+  this->m_urls = urls;
+  this->m_results = QVector<QByteArray>(urls.size());
+  this->m_attempts = QVector<int>(urls.size(), 0);
+  this->m_redirects = QVector<int>(urls.size(), 0);
+  this->m_succeeded = QVector<bool>(urls.size(), false);
+  this->m_active.clear();
+  this->m_timedOut.clear();
+  this->m_hostInFlight.clear();
+  this->m_pending.resize(urls.size());
+  for (int i = 0; i < urls.size(); ++i) this->m_pending[i] = i;
+  this->m_inFlight = 0;
+  this->m_complete = 0;
+  this->m_bytesReceived = 0;
+  this->m_errorString = QString();
+  this->m_running = true;
+
+  if (urls.isEmpty()) {
+    this->m_running = false;
+    emit finished();
+    return;
+  }
+
+  this->startNext();
+}
+
+//...Runs the pipeline to completion inside a local event loop and returns
+//   the responses in request order. Returns the number of failed requests.
+int ChunkDownloader::download(const QVector<QUrl> &urls,
+                              QVector<QByteArray> &results) {
+  QEventLoop loop;
+  connect(this, SIGNAL(finished()), &loop, SLOT(quit()));
+  this->start(urls);
+  if (this->m_running) loop.exec();
+  results = this->m_results;
+  return this->numFailed();
+}
+
+//...Starts pending requests in order, passing over any whose host is
+//   already at its limit so other servers keep busy in the meantime
+void ChunkDownloader::startNext() {
+  int i = 0;
+  while (this->m_inFlight < this->m_maxConcurrent &&
+         i < this->m_pending.size()) {
+    int index = this->m_pending[i];
+    QString host = this->m_urls[index].host();
+    if (this->m_maxConcurrentPerHost > 0 &&
+        this->m_hostInFlight.value(host, 0) >= this->m_maxConcurrentPerHost) {
+      ++i;
+      continue;
+    }
+    this->m_pending.remove(i);
+    this->m_hostInFlight[host]++;
+    this->m_inFlight++;
+    this->m_attempts[index]++;
+    this->startRequest(index, this->m_urls[index]);
+  }
+}
+
+void ChunkDownloader::startRequest(int index, const QUrl &url) {
+  QNetworkReply *reply = this->m_manager->get(QNetworkRequest(url));
+  this->m_active[reply] = index;
+  connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+
+  //...A stalled connection is aborted so it does not hold its slot. The
+  //   timer restarts whenever data arrives
+  if (this->m_transferTimeout > 0) {
+    QTimer *timer = new QTimer(reply);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, [this, reply]() {
+      if (!this->m_active.contains(reply)) return;
+      this->m_timedOut.insert(reply);
+      reply->abort();
+    });
+    connect(reply, &QNetworkReply::downloadProgress, timer,
+            [timer](qint64, qint64) { timer->start(); });
+    timer->start(this->m_transferTimeout);
+  }
+}
+
+bool ChunkDownloader::isTransientError(QNetworkReply *reply) {
+  switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::UnknownServerError:
+      return true;
+    default:
+      break;
+  }
+  int status =
+      reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  return status == 429 || status >= 500;
+}
+
+void ChunkDownloader::replyFinished() {
+  QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+  if (reply == nullptr || !this->m_active.contains(reply)) return;
+  int index = this->m_active.take(reply);
+  bool timedOut = this->m_timedOut.remove(reply);
+  reply->deleteLater();
+
+  //...Follow redirects in place so the response stays in the same slot.
+  //   Redirects are counted apart from retries so a cycle still ends
+  QVariant redirect =
+      reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+  if (reply->error() == QNetworkReply::NoError && !redirect.isNull()) {
+    if (this->m_redirects[index] >= this->m_maxRedirects) {
+      this->m_errorString = QStringLiteral("ERROR: Too many redirects for ") +
+                            this->m_urls[index].toString();
+      this->completeChunk(index, false);
+      return;
+    }
+    this->m_redirects[index]++;
+    this->startRequest(index, reply->url().resolved(redirect.toUrl()));
+    return;
+  }
+
+  if (reply->error() == QNetworkReply::NoError) {
+    this->m_results[index] = reply->readAll();
+    this->m_bytesReceived += this->m_results[index].size();
+    this->completeChunk(index, true);
+    return;
+  }
+
+  if ((timedOut || isTransientError(reply)) &&
+      this->m_attempts[index] <= this->m_maxRetries) {
+    QUrl url = this->m_urls[index];
+    int delay = this->m_retryDelay * this->m_attempts[index];
+    QTimer::singleShot(delay, this, [this, index, url]() {
+      this->m_attempts[index]++;
+      this->m_redirects[index] = 0;
+      this->startRequest(index, url);
+    });
+    return;
+  }
+
+  if (timedOut) {
+    this->m_errorString = QStringLiteral("ERROR: Timed out downloading ") +
+                          this->m_urls[index].toString();
+  } else {
+    this->m_errorString = QStringLiteral("ERROR: ") + reply->errorString();
+  }
+  this->completeChunk(index, false);
+}
+
+void ChunkDownloader::completeChunk(int index, bool ok) {
+  this->m_succeeded[index] = ok;
+  this->m_inFlight--;
+  this->m_hostInFlight[this->m_urls[index].host()]--;
+  this->m_complete++;
+  emit chunkFinished(index);
+  emit progress(this->m_complete, this->m_urls.size());
+
+  if (this->m_complete == this->m_urls.size()) {
+    this->m_running = false;
+    emit finished();
+  } else {
+    this->startNext();
+  }
+}
@@ -0,0 +1,118 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef CHUNKDOWNLOADER_H
+#define CHUNKDOWNLOADER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+#include <QVector>
+#include "metocean_global.h"
+
+//...Downloads a list of URLs keeping up to maxConcurrent() requests in
+//   flight. Responses are stored by request index so callers receive them
+//   in the order the URLs were given, regardless of completion order.
+//   Transient failures (timeouts, dropped connections, HTTP 429 and 5xx)
+//   are retried up to maxRetries() times. An optional per host limit keeps
+//   a large batch from saturating any single server. Redirects are followed
+//   up to maxRedirects() times per request, and a request that receives
+//   nothing for transferTimeout() milliseconds is dropped and retried.
+class ChunkDownloader : public QObject {
+  Q_OBJECT
+ public:
+  explicit ChunkDownloader(QNetworkAccessManager *manager = nullptr,
+                           QObject *parent = nullptr);
+
+  int maxConcurrent() const;
+  void setMaxConcurrent(int maxConcurrent);
+
+  int maxConcurrentPerHost() const;
+  void setMaxConcurrentPerHost(int maxConcurrentPerHost);
+
+  int maxRetries() const;
+  void setMaxRetries(int maxRetries);
+
+  int retryDelay() const;
+  void setRetryDelay(int msec);
+
+  int maxRedirects() const;
+  void setMaxRedirects(int maxRedirects);
+
+  int transferTimeout() const;
+  void setTransferTimeout(int msec);
+
+  void start(const QVector<QUrl> &urls);
+
+  int download(const QVector<QUrl> &urls, QVector<QByteArray> &results);
+
+  bool isRunning() const;
+
+  QVector<QByteArray> results() const;
+  QByteArray takeResult(int index);
+  bool succeeded(int index) const;
+  qint64 bytesReceived() const;
+  int numFailed() const;
+
+  QString errorString() const;
+
+ signals:
+  void progress(int complete, int total);
+  void chunkFinished(int index);
+  void finished();
+
+ private slots:
+  void replyFinished();
+
+ private:
+  void startNext();
+  void startRequest(int index, const QUrl &url);
+  void completeChunk(int index, bool ok);
+  static bool isTransientError(QNetworkReply *reply);
+
+  QNetworkAccessManager *m_manager;
+  int m_maxConcurrent;
+  int m_maxConcurrentPerHost;
+  int m_maxRetries;
+  int m_retryDelay;
+  int m_maxRedirects;
+  int m_transferTimeout;
+
+  QVector<QUrl> m_urls;
+  QVector<QByteArray> m_results;
+  QVector<int> m_attempts;
+  QVector<int> m_redirects;
+  QVector<bool> m_succeeded;
+  QHash<QNetworkReply *, int> m_active;
+  QSet<QNetworkReply *> m_timedOut;
+  QHash<QString, int> m_hostInFlight;
+  QVector<int> m_pending;
+  int m_inFlight;
+  int m_complete;
+  qint64 m_bytesReceived;
+  bool m_running;
+
+  QString m_errorString;
+};
+
+#endif  // CHUNKDOWNLOADER_H
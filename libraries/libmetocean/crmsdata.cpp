@@ -23,8 +23,195 @@
 #include <QMap>
 #include <QString>
 #include <QStringList>
+#include <algorithm>
+#include <vector>
 #include "netcdf.h"
 
+namespace {
+//...Times are stored in seconds since the reference of the writer
+const QDateTime &crmsReference() {
+  static const QDateTime reference(QDate(1899, 12, 31), QTime(0, 0, 0),
+                                   Qt::UTC);
+  return reference;
+}
+
+//...Read-only handle to the CRMS database kept open across queries. It is
+//   reopened if a different file is requested or the file on disk has been
+//   replaced since it was opened.
+struct CrmsHandle {
+  QString filename;
+  QDateTime modified;
+  int ncid = -1;
+  ~CrmsHandle() {
+    if (ncid >= 0) nc_close(ncid);
+  }
+};
+
+CrmsHandle &crmsHandle() {
+  static CrmsHandle h;
+  return h;
+}
+
+int crmsOpen(const QString &filename, int &ncid) {
+  CrmsHandle &h = crmsHandle();
+  QDateTime modified = QFileInfo(filename).lastModified();
+  if (h.ncid >= 0 && (h.filename != filename || h.modified != modified)) {
+    nc_close(h.ncid);
+    h.ncid = -1;
+  }
+  if (h.ncid < 0) {
+    int ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &h.ncid);
+    if (ierr != NC_NOERR) {
+      h.ncid = -1;
+      return ierr;
+    }
+    h.filename = filename;
+    h.modified = modified;
+  }
+  ncid = h.ncid;
+  return NC_NOERR;
+}
+
+//...Binary search over a station's time variable, which is written in
+//   ascending order. Returns the first index whose time is >= value, or
+//   > value when upper is set, reading one element per step.
+int crmsTimeBound(int ncid, int varid, size_t n, long long value, bool upper,
+                  size_t &index) {
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    long long t;
+    int ierr = nc_get_var1_longlong(ncid, varid, &mid, &t);
+    if (ierr != NC_NOERR) return ierr;
+    if (upper ? t <= value : t < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  index = lo;
+  return NC_NOERR;
+}
+//...Station table of a CRMS database: sensor names, station names and the
+//   time bounds of each station. It is read once per file and reused until
+//   the file on disk changes.
+struct CrmsIndex {
+  QString filename;
+  QDateTime modified;
+  bool valid = false;
+  QVector<QString> header;
+  QVector<QString> names;
+  QVector<QDateTime> startDate;
+  QVector<QDateTime> endDate;
+  QMap<QString, size_t> mapping;
+};
+
+QString crmsText(const char *text, size_t length) {
+  return QString::fromUtf8(text, static_cast<int>(qstrnlen(text, length)));
+}
+
+int crmsReadIndex(int ncid, CrmsIndex &index) {
+  int dimid_param, dimid_nstation, dimid_stringsize, varid_sensors;
+  size_t np, n, stringsize;
+  int ierr = nc_inq_dimid(ncid, "numParam", &dimid_param);
+  ierr += nc_inq_dimid(ncid, "nstation", &dimid_nstation);
+  ierr += nc_inq_dimid(ncid, "stringsize", &dimid_stringsize);
+  ierr += nc_inq_dimlen(ncid, dimid_param, &np);
+  ierr += nc_inq_dimlen(ncid, dimid_nstation, &n);
+  ierr += nc_inq_dimlen(ncid, dimid_stringsize, &stringsize);
+  ierr += nc_inq_varid(ncid, "sensors", &varid_sensors);
+  if (ierr != NC_NOERR) return ierr;
+
+  std::vector<char> text(np * stringsize);
+  if (np > 0) ierr += nc_get_var_text(ncid, varid_sensors, text.data());
+  for (size_t i = 0; i < np; ++i) {
+    QString h = crmsText(text.data() + i * stringsize, stringsize);
+    h = h.remove("\xEF\xBF\xBD");
+    index.header.push_back(h);
+  }
+
+  index.names.reserve(static_cast<int>(n));
+  index.startDate.reserve(static_cast<int>(n));
+  index.endDate.reserve(static_cast<int>(n));
+
+  int varid_names, varid_min, varid_max;
+  if (nc_inq_varid(ncid, "station_name", &varid_names) == NC_NOERR &&
+      nc_inq_varid(ncid, "time_minimum", &varid_min) == NC_NOERR &&
+      nc_inq_varid(ncid, "time_maximum", &varid_max) == NC_NOERR) {
+    std::vector<char> names(n * stringsize);
+    std::vector<long long> tmin(n), tmax(n);
+    if (n > 0) {
+      ierr += nc_get_var_text(ncid, varid_names, names.data());
+      ierr += nc_get_var_longlong(ncid, varid_min, tmin.data());
+      ierr += nc_get_var_longlong(ncid, varid_max, tmax.data());
+    }
+
+    const QDateTime &reference = crmsReference();
+    for (size_t i = 0; i < n; ++i) {
+      index.names.push_back(
+          crmsText(names.data() + i * stringsize, stringsize));
+      index.startDate.push_back(reference.addSecs(tmin[i]));
+      index.endDate.push_back(reference.addSecs(tmax[i]));
+    }
+  } else {
+    //...Databases written before the station table was added only carry
+    //   the names and time bounds as attributes of each station
+    std::vector<char> name(stringsize), tms(stringsize), tme(stringsize);
+    for (size_t i = 0; i < n; ++i) {
+      int varid_data, varid_time;
+      QString stationDataString, stationTimeString;
+      stationDataString.sprintf("data_station_%6.6llu", i + 1);
+      stationTimeString.sprintf("time_station_%6.6llu", i + 1);
+      ierr += nc_inq_varid(ncid, stationDataString.toStdString().c_str(),
+                           &varid_data);
+      ierr += nc_inq_varid(ncid, stationTimeString.toStdString().c_str(),
+                           &varid_time);
+
+      std::fill(name.begin(), name.end(), '\0');
+      std::fill(tms.begin(), tms.end(), '\0');
+      std::fill(tme.begin(), tme.end(), '\0');
+      ierr += nc_get_att_text(ncid, varid_data, "station_name", name.data());
+      ierr += nc_get_att_text(ncid, varid_time, "minimum", tms.data());
+      ierr += nc_get_att_text(ncid, varid_time, "maximum", tme.data());
+
+      QDateTime dateBegin = QDateTime::fromString(
+          crmsText(tms.data(), stringsize), "yyyy/MM/dd hh:mm:ss");
+      dateBegin.setTimeSpec(Qt::UTC);
+      QDateTime dateEnd = QDateTime::fromString(
+          crmsText(tme.data(), stringsize), "yyyy/MM/dd hh:mm:ss");
+      dateEnd.setTimeSpec(Qt::UTC);
+
+      index.names.push_back(crmsText(name.data(), stringsize));
+      index.startDate.push_back(dateBegin);
+      index.endDate.push_back(dateEnd);
+    }
+  }
+
+  for (int i = 0; i < index.names.size(); ++i) {
+    index.mapping[index.names[i]] = static_cast<size_t>(i);
+  }
+  return ierr;
+}
+
+const CrmsIndex *crmsIndex(const QString &filename) {
+  static CrmsIndex index;
+  QDateTime modified = QFileInfo(filename).lastModified();
+  if (index.valid && index.filename == filename &&
+      index.modified == modified) {
+    return &index;
+  }
+
+  index = CrmsIndex();
+  int ncid;
+  if (crmsOpen(filename, ncid) != NC_NOERR) return nullptr;
+  if (crmsReadIndex(ncid, index) != NC_NOERR) return nullptr;
+  index.filename = filename;
+  index.modified = modified;
+  index.valid = true;
+  return &index;
+}
+}  // namespace
+
 CrmsData::CrmsData(Station &station, QDateTime startDate, QDateTime endDate,
                    const QVector<QString> &header,
                    const QMap<QString, size_t> &mapping,
@@ -32,15 +219,31 @@ CrmsData::CrmsData(Station &station, QDateTime startDate, QDateTime endDate,
     : m_mapping(mapping),
       m_header(header),
       m_filename(filename),
+      m_resolution(0),
       WaterData(station, startDate, endDate, parent) {}
 
+int CrmsData::resolution() const { return this->m_resolution; }
+
+//...Number of horizontal pixels the data will be drawn across. When set,
+//   long windows are read from the overview levels of the database instead
+//   of the full record. Zero always reads the full record.
+void CrmsData::setResolution(int resolution) {
+  this->m_resolution = resolution;
+}
+
 int CrmsData::retrieveData(Hmdf *data, Datum::VDatum datum) {
   Q_UNUSED(datum)
   int ncid;
-  int ierr = nc_open(this->m_filename.toStdString().c_str(), NC_NOWRITE, &ncid);
+  int ierr = crmsOpen(this->m_filename, ncid);
+  if (ierr != NC_NOERR) {
+    this->setErrorString("Could not open the CRMS database.");
+    return 1;
+  }
 
-  qint64 minTime = this->startDate().toSecsSinceEpoch();
-  qint64 maxTime = this->endDate().toSecsSinceEpoch();
+  //...The window is searched in the time reference of the database
+  const long long reference = crmsReference().toSecsSinceEpoch();
+  long long minTime = this->startDate().toSecsSinceEpoch() - reference;
+  long long maxTime = this->endDate().toSecsSinceEpoch() - reference;
 
   size_t index;
   if (this->m_mapping.contains(this->station().name())) {
@@ -64,98 +267,180 @@ int CrmsData::retrieveData(Hmdf *data, Datum::VDatum datum) {
       nc_inq_varid(ncid, stationDataString.toStdString().c_str(), &varid_data);
   ierr +=
       nc_inq_varid(ncid, stationTimeString.toStdString().c_str(), &varid_time);
+  if (ierr != NC_NOERR) {
+    this->setErrorString("Error reading the CRMS database.");
+    return 1;
+  }
+
+  //...Find the slice of the record inside the requested window
+  size_t first, last;
+  ierr += crmsTimeBound(ncid, varid_time, n, minTime, false, first);
+  ierr += crmsTimeBound(ncid, varid_time, n, maxTime, true, last);
+  if (ierr != NC_NOERR) {
+    this->setErrorString("Error reading the CRMS database.");
+    return 1;
+  }
+  if (last <= first) return 0;
+  size_t nt = last - first;
+
+  if (this->m_resolution > 0 && nt > static_cast<size_t>(this->m_resolution)) {
+    bool found = false;
+    ierr = this->retrieveOverview(ncid, index, np, minTime, maxTime, data,
+                                  found);
+    if (ierr != 0 || found) return ierr;
+  }
 
-  long long *t = new long long[n];
-  ierr += nc_get_var_longlong(ncid, varid_time, t);
+  std::vector<long long> t(nt);
+  std::vector<float> v(np * nt);
+  size_t tstart[1] = {first};
+  size_t tcount[1] = {nt};
+  size_t start[2] = {0, first};
+  size_t count[2] = {np, nt};
+  ierr += nc_get_vara_longlong(ncid, varid_time, tstart, tcount, t.data());
+  ierr += nc_get_vara_float(ncid, varid_data, start, count, v.data());
+  if (ierr != NC_NOERR) {
+    this->setErrorString("Error reading the CRMS database.");
+    return 1;
+  }
 
   for (size_t i = 0; i < np; ++i) {
-    float *v = new float[n];
-    size_t start[2] = {i, 0};
-    size_t count[2] = {1, n};
-    ierr += nc_get_vara_float(ncid, varid_data, start, count, v);
-    HmdfStation *s = new HmdfStation(data);
+    const float *vp = v.data() + i * nt;
 
     QVector<double> tsdata;
     QVector<long long> time;
-    tsdata.reserve(n);
-    time.reserve(n);
+    tsdata.reserve(nt);
+    time.reserve(nt);
 
-    for (size_t j = 0; j < n; ++j) {
-      if (v[j] > -9999.0f && t[j] >= minTime && t[j] <= maxTime) {
-        time.push_back(t[j] * 1000);
-        tsdata.push_back(static_cast<double>(v[j]));
+    for (size_t j = 0; j < nt; ++j) {
+      if (vp[j] > -9999.0f) {
+        time.push_back((t[j] + reference) * 1000);
+        tsdata.push_back(static_cast<double>(vp[j]));
       }
     }
-    delete[] v;
 
-    if (tsdata.length() < 5) continue;
+    this->addParameter(data, i, tsdata, time);
+  }
 
-    s->setName(this->m_header[i]);
-    s->setLongitude(this->station().coordinate().longitude());
-    s->setLatitude(this->station().coordinate().latitude());
-    s->setId(QString::number(i));
-    s->setData(tsdata);
-    s->setDate(time);
-    s->setIsNull(false);
+  return 0;
+}
 
-    data->addStation(s);
-  }
-  delete[] t;
+//...Reads the coarsest overview level that still has at least one bucket
+//   per pixel across the window. Each bucket is drawn as its minimum at the
+//   start of the bucket and its maximum halfway through so that peaks are
+//   kept. found is false if no level is fine enough or the database was
+//   written without overviews.
+int CrmsData::retrieveOverview(int ncid, size_t index, size_t np,
+                               long long minTime, long long maxTime,
+                               Hmdf *data, bool &found) {
+  found = false;
+  const long long reference = crmsReference().toSecsSinceEpoch();
+  for (QString level : {"monthly", "daily"}) {
+    QString suffix = QString("_%1").arg(index + 1, 6, 10, QChar('0'));
+    std::string dimName = (level + "Length" + suffix).toStdString();
+    std::string timeName = (level + "_time_station" + suffix).toStdString();
+    std::string dataName = (level + "_station" + suffix).toStdString();
+
+    int dimid_n, varid_data, varid_time;
+    size_t n;
+    if (nc_inq_dimid(ncid, dimName.c_str(), &dimid_n) != NC_NOERR) return 0;
+    int ierr = nc_inq_dimlen(ncid, dimid_n, &n);
+    ierr += nc_inq_varid(ncid, timeName.c_str(), &varid_time);
+    ierr += nc_inq_varid(ncid, dataName.c_str(), &varid_data);
+
+    //...The first bucket is the one holding the start of the window
+    size_t first, last;
+    ierr += crmsTimeBound(ncid, varid_time, n, minTime, true, first);
+    ierr += crmsTimeBound(ncid, varid_time, n, maxTime, true, last);
+    if (ierr != NC_NOERR) {
+      this->setErrorString("Error reading the CRMS database.");
+      return 1;
+    }
+    if (first > 0) first--;
+    if (last <= first) continue;
+    size_t nb = last - first;
+    if (nb < static_cast<size_t>(this->m_resolution)) continue;
+
+    //...One extra bucket time, when there is one, gives the width of the
+    //   last bucket
+    size_t ntime = std::min(nb + 1, n - first);
+    std::vector<long long> t(ntime);
+    std::vector<float> v(2 * np * nb);
+    size_t tstart[1] = {first};
+    size_t tcount[1] = {ntime};
+    size_t start[3] = {0, 0, first};
+    size_t count[3] = {2, np, nb};
+    ierr += nc_get_vara_longlong(ncid, varid_time, tstart, tcount, t.data());
+    ierr += nc_get_vara_float(ncid, varid_data, start, count, v.data());
+    if (ierr != NC_NOERR) {
+      this->setErrorString("Error reading the CRMS database.");
+      return 1;
+    }
+
+    for (size_t i = 0; i < np; ++i) {
+      const float *vmin = v.data() + i * nb;
+      const float *vmax = v.data() + (np + i) * nb;
+
+      QVector<double> tsdata;
+      QVector<long long> time;
+      tsdata.reserve(2 * nb);
+      time.reserve(2 * nb);
+
+      for (size_t j = 0; j < nb; ++j) {
+        if (vmin[j] <= -9999.0f) continue;
+        long long width = j + 1 < ntime ? t[j + 1] - t[j]
+                                        : (j > 0 ? t[j] - t[j - 1] : 86400);
+        time.push_back((t[j] + reference) * 1000);
+        tsdata.push_back(static_cast<double>(vmin[j]));
+        time.push_back((t[j] + reference + width / 2) * 1000);
+        tsdata.push_back(static_cast<double>(vmax[j]));
+      }
 
+      this->addParameter(data, i, tsdata, time);
+    }
+
+    found = true;
+    return 0;
+  }
   return 0;
 }
 
+void CrmsData::addParameter(Hmdf *data, size_t parameter,
+                            const QVector<double> &value,
+                            const QVector<long long> &time) {
+  if (value.length() < 5) return;
+
+  HmdfStation *s = new HmdfStation(data);
+  s->setName(this->m_header[parameter]);
+  s->setLongitude(this->station().coordinate().longitude());
+  s->setLatitude(this->station().coordinate().latitude());
+  s->setId(QString::number(parameter));
+  s->setData(value);
+  s->setDate(time);
+  s->setIsNull(false);
+
+  data->addStation(s);
+}
+
+void CrmsData::closeDatabase() {
+  CrmsHandle &h = crmsHandle();
+  if (h.ncid >= 0) nc_close(h.ncid);
+  h.ncid = -1;
+  h.filename = QString();
+}
+
 bool CrmsData::generateStationMapping(const QString &filename,
                                       QMap<QString, size_t> &mapping) {
-  int ncid;
-  int dimid_nstation, dimid_stringlen;
-  size_t n, stringlen;
-
-  int ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  ierr += nc_inq_dimid(ncid, "nstation", &dimid_nstation);
-  ierr += nc_inq_dimid(ncid, "stringsize", &dimid_stringlen);
-  ierr += nc_inq_dimlen(ncid, dimid_nstation, &n);
-  ierr += nc_inq_dimlen(ncid, dimid_stringlen, &stringlen);
-  for (size_t i = 0; i < n; ++i) {
-    int varid_station;
-    QString stationDataString;
-    stationDataString.sprintf("data_station_%6.6llu", i + 1);
-    ierr += nc_inq_varid(ncid, stationDataString.toStdString().c_str(),
-                         &varid_station);
-    char *nm = new char[stringlen];
-    memset(nm, '\0', stringlen);
-    ierr += nc_get_att_text(ncid, varid_station, "station_name", nm);
-    QString name(nm);
-    mapping[name] = i;
-    delete[] nm;
-  }
-  return ierr == 0;
+  const CrmsIndex *index = crmsIndex(filename);
+  if (index == nullptr) return false;
+  mapping = index->mapping;
+  return true;
 }
 
 bool CrmsData::readHeader(const QString &filename, QVector<QString> &header) {
-  int ncid;
-  int dimid_numParam, dimid_stringlen;
-  int varid_sensors;
-  size_t np, stringlen;
-  int ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  nc_inq_dimid(ncid, "numParam", &dimid_numParam);
-  nc_inq_dimlen(ncid, dimid_numParam, &np);
-  nc_inq_dimid(ncid, "stringsize", &dimid_stringlen);
-  nc_inq_dimlen(ncid, dimid_stringlen, &stringlen);
-  nc_inq_varid(ncid, "sensors", &varid_sensors);
-
-  for (size_t i = 0; i < np; ++i) {
-    char *n = new char[stringlen];
-    memset(n, '\0', stringlen);
-    size_t start[2] = {i, 0};
-    size_t count[2] = {1, stringlen};
-    ierr += nc_get_vara_text(ncid, varid_sensors, start, count, n);
-    QString h = QString(n);
-    h = h.remove("\xEF\xBF\xBD");
-    header.push_back(h);
-    delete[] n;
-  }
-  return ierr == 0;
+  const CrmsIndex *index = crmsIndex(filename);
+  if (index == nullptr) return false;
+  header = index->header;
+  return true;
 }
 
 bool CrmsData::readStationList(const QString &filename,
@@ -181,36 +466,18 @@ bool CrmsData::readStationList(const QString &filename,
   }
   crmsCsv.close();
 
-  int ncid, dimid_nstation, dimid_stringsize;
-  size_t nstations, stringsize;
-  int ierr = nc_open(filename.toStdString().c_str(), NC_NOWRITE, &ncid);
-  ierr += nc_inq_dimid(ncid, "nstation", &dimid_nstation);
-  ierr += nc_inq_dimlen(ncid, dimid_nstation, &nstations);
-  ierr += nc_inq_dimid(ncid, "stringsize", &dimid_stringsize);
-  ierr += nc_inq_dimlen(ncid, dimid_stringsize, &stringsize);
+  const CrmsIndex *index = crmsIndex(filename);
+  if (index == nullptr) return false;
 
+  int nstations = index->names.size();
   longitude.reserve(nstations);
   latitude.reserve(nstations);
   startDate.reserve(nstations);
   endDate.reserve(nstations);
   stationNames.reserve(nstations);
 
-  for (size_t i = 0; i < nstations; ++i) {
-    int varid_data, varid_time;
-    char *nm = new char[stringsize];
-    memset(nm, '\0', stringsize);
-
-    QString stationDataString, stationTimeString;
-    stationDataString.sprintf("data_station_%6.6llu", i + 1);
-    stationTimeString.sprintf("time_station_%6.6llu", i + 1);
-    ierr += nc_inq_varid(ncid, stationDataString.toStdString().c_str(),
-                         &varid_data);
-    ierr += nc_inq_varid(ncid, stationTimeString.toStdString().c_str(),
-                         &varid_time);
-
-    ierr += nc_get_att_text(ncid, varid_data, "station_name", nm);
-    QString name(nm);
-    delete[] nm;
+  for (int i = 0; i < nstations; ++i) {
+    const QString &name = index->names[i];
 
     QGeoCoordinate p;
     if (nameMap.contains(name)) {
@@ -219,36 +486,14 @@ bool CrmsData::readStationList(const QString &filename,
       continue;
     }
 
-    char *tms = new char[stringsize];
-    char *tme = new char[stringsize];
-
-    memset(tms, '\0', stringsize);
-    memset(tme, '\0', stringsize);
-
-    ierr += nc_get_att_text(ncid, varid_time, "minimum", tms);
-    ierr += nc_get_att_text(ncid, varid_time, "maximum", tme);
-
-    QString dateBeginString(tms);
-    QString dateEndString(tme);
-    delete[] tms;
-    delete[] tme;
-
-    QDateTime dateBegin =
-        QDateTime::fromString(dateBeginString, "yyyy/MM/dd hh:mm:ss");
-    dateBegin.setTimeSpec(Qt::UTC);
-    QDateTime dateEnd =
-        QDateTime::fromString(dateEndString, "yyyy/MM/dd hh:mm:ss");
-    dateEnd.setTimeSpec(Qt::UTC);
-
     latitude.push_back(p.latitude());
     longitude.push_back(p.longitude());
-    startDate.push_back(dateBegin);
-    endDate.push_back(dateEnd);
+    startDate.push_back(index->startDate[i]);
+    endDate.push_back(index->endDate[i]);
     stationNames.push_back(name);
   }
-  ierr += nc_close(ncid);
 
-  return ierr == 0;
+  return true;
 }
 
 bool CrmsData::inquireCrmsStatus(QString filename) {
@@ -44,14 +44,24 @@ class CrmsData : public WaterData {
 
   static bool inquireCrmsStatus(QString filename);
 
+  static void closeDatabase();
+
+  int resolution() const;
+  void setResolution(int resolution);
+
  private:
   int retrieveData(Hmdf *data, Datum::VDatum datum);
+  int retrieveOverview(int ncid, size_t index, size_t np, long long minTime,
+                       long long maxTime, Hmdf *data, bool &found);
+  void addParameter(Hmdf *data, size_t parameter, const QVector<double> &value,
+                    const QVector<long long> &time);
 
   QDateTime m_startTime;
   QDateTime m_endTime;
   QString m_filename;
   QVector<QString> m_header;
   QMap<QString, size_t> m_mapping;
+  int m_resolution;
 };
 
 #endif  // CRMSDATA_H
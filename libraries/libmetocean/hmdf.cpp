@@ -18,10 +18,14 @@
 //
 //-----------------------------------------------------------------------*/
 #include "hmdf.h"
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QHostInfo>
-#include <fstream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include "hmdfasciiparser.h"
 #include "netcdf.h"
 #include "netcdftimeseries.h"
@@ -43,6 +47,7 @@ void Hmdf::init() {
   this->setSuccess(false);
   this->setUnits("");
   this->setNull(true);
+  this->m_readThroughput = 0.0;
   return;
 }
 
@@ -101,72 +106,213 @@ bool Hmdf::null() const { return this->m_null; }
 
 void Hmdf::setNull(bool null) { this->m_null = null; }
 
-int Hmdf::readImeds(QString filename) {
-  std::fstream fid(filename.toStdString().c_str());
-  if (fid.bad()) return -1;
+//...Position of the first character following the line that starts at pos
+static const char *imedsNextLine(const char *pos, const char *end) {
+  const char *eol = static_cast<const char *>(
+      memchr(pos, '\n', static_cast<size_t>(end - pos)));
+  return eol == nullptr ? end : eol + 1;
+}
 
-  //...Read Header
-  std::string templine;
-  std::getline(fid, templine);
-  this->m_header1 =
-      QString::fromStdString(StringUtil::sanitizeString(templine));
-  std::getline(fid, templine);
-  this->m_header2 =
-      QString::fromStdString(StringUtil::sanitizeString(templine));
-  std::getline(fid, templine);
-  this->m_header3 =
-      QString::fromStdString(StringUtil::sanitizeString(templine));
+//...Counts whitespace delimited tokens on a line, stopping once limit
+//   tokens have been seen. Data rows have at least six tokens while station
+//   headers have three.
+static int imedsTokenCount(const char *pos, const char *eol, int limit) {
+  int n = 0;
+  bool inToken = false;
+  for (; pos < eol && n < limit; ++pos) {
+    bool ws = *pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n';
+    if (!ws && !inToken) ++n;
+    inToken = !ws;
+  }
+  return n;
+}
 
-  //...Read Body
-  std::getline(fid, templine);
+static QByteArray imedsNextToken(const char *&pos, const char *eol) {
+  while (pos < eol && (*pos == ' ' || *pos == '\t' || *pos == '\r')) ++pos;
+  const char *tokenStart = pos;
+  while (pos < eol && *pos != ' ' && *pos != '\t' && *pos != '\r') ++pos;
+  return QByteArray::fromRawData(tokenStart,
+                                 static_cast<int>(pos - tokenStart));
+}
 
-  while (!fid.eof()) {
-    HmdfStation *station = new HmdfStation(this);
+static QString imedsHeaderLine(const char *&pos, const char *end) {
+  const char *next = imedsNextLine(pos, end);
+  QString line =
+      QString::fromUtf8(pos, static_cast<int>(next - pos)).trimmed();
+  pos = next;
+  return line;
+}
 
-    templine = StringUtil::sanitizeString(templine);
+//...Location of one station block within the mapped IMEDS file. The offsets
+//   and row count come from the scan pass, the remaining fields are filled
+//   when the block is parsed. Values are written straight into the slice
+//   of the shared arena that starts at date/data.
+struct ImedsBlock {
+  const char *header;
+  const char *end;
+  int nRows;
+  int nParsed;
+  size_t offset;
+  qint64 *date;
+  double *data;
+  QString name;
+  double latitude;
+  double longitude;
+};
+
+//...First pass. Finds the station header lines and counts the data rows
+//   that follow each of them without parsing any values.
+static QVector<ImedsBlock> scanImedsBlocks(const char *pos, const char *end) {
+  QVector<ImedsBlock> blocks;
+  while (pos < end) {
+    const char *next = imedsNextLine(pos, end);
+    int nTokens = imedsTokenCount(pos, next, 6);
+    if (nTokens > 0 && nTokens < 6) {
+      if (!blocks.isEmpty()) blocks.last().end = pos;
+      ImedsBlock b;
+      b.header = pos;
+      b.end = end;
+      b.nRows = 0;
+      b.nParsed = 0;
+      b.offset = 0;
+      b.date = nullptr;
+      b.data = nullptr;
+      b.latitude = 0.0;
+      b.longitude = 0.0;
+      blocks.push_back(b);
+    } else if (nTokens == 6 && !blocks.isEmpty()) {
+      blocks.last().nRows++;
+    }
+    pos = next;
+  }
+  return blocks;
+}
 
-    QStringList templist =
-        QString::fromStdString(templine).split(" ", QString::SkipEmptyParts);
+//...Second pass. Parses a single station block into its arena slice,
+//   which was sized using the row count from the scan. Blocks write to
+//   disjoint slices, so this is safe to run concurrently.
+static void readImedsBlock(ImedsBlock &block) {
+  const char *eol = imedsNextLine(block.header, block.end);
+
+  const char *token = block.header;
+  QByteArray name = imedsNextToken(token, eol);
+  QByteArray lat = imedsNextToken(token, eol);
+  QByteArray lon = imedsNextToken(token, eol);
+  block.name = QString::fromUtf8(name);
+  block.latitude = lat.toDouble();
+  block.longitude = lon.toDouble();
+
+  qint64 *d = block.date;
+  double *v = block.data;
+
+  int n = 0;
+  for (const char *line = eol; line < block.end && n < block.nRows;) {
+    const char *next = imedsNextLine(line, block.end);
+    long long t;
+    if (HmdfAsciiParser::parseImedsRecord(line, next, t, v[n])) {
+      d[n] = t;
+      n++;
+    }
+    line = next;
+  }
 
-    station->setName(templist.at(0));
-    station->setLongitude(templist.at(2).toDouble());
-    station->setLatitude(templist.at(1).toDouble());
+  block.nParsed = n;
+  return;
+}
 
-    while (!fid.eof()) {
-      std::getline(fid, templine);
+int Hmdf::readImeds(QString filename, bool parallel) {
+  QElapsedTimer timer;
+  timer.start();
 
-      int year, month, day, hour, minute, second;
-      double value;
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return -1;
 
-      bool status = HmdfAsciiParser::splitStringHmdfFormat(
-          templine, year, month, day, hour, minute, second, value);
+  const qint64 fileSize = file.size();
+  uchar *map = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+  if (map == nullptr) {
+    file.close();
+    return -1;
+  }
 
-      if (status) {
-        QDateTime datetime;
-        datetime.setTimeSpec(Qt::UTC);
-        datetime.setDate(QDate(year, month, day));
-        datetime.setTime(QTime(hour, minute, second));
-        qint64 secs = datetime.toMSecsSinceEpoch();
+  const char *pos = reinterpret_cast<const char *>(map);
+  const char *end = pos + fileSize;
 
-        //...Append to the station data
-        station->setNext(secs, value);
-      } else {
-        break;
-      }
-    }
+  //...Read Header
+  this->m_header1 = imedsHeaderLine(pos, end);
+  this->m_header2 = imedsHeaderLine(pos, end);
+  this->m_header3 = imedsHeaderLine(pos, end);
+
+  //...Read Body
+  QVector<ImedsBlock> blocks = scanImedsBlocks(pos, end);
+
+  size_t nTotal = 0;
+  for (auto &b : blocks) {
+    b.offset = nTotal;
+    nTotal += static_cast<size_t>(b.nRows);
+  }
+
+  QSharedPointer<HmdfArena> arena(new HmdfArena());
+  arena->allocate(nTotal);
+  for (auto &b : blocks) {
+    b.date = arena->date(b.offset);
+    b.data = arena->data(b.offset);
+  }
+
+  if (parallel && blocks.size() > 1) {
+    QtConcurrent::blockingMap(blocks, readImedsBlock);
+  } else {
+    for (auto &b : blocks) readImedsBlock(b);
+  }
 
-    //...Add the station
+  //...Stations are created here on the calling thread, in file order
+  for (auto &b : blocks) {
+    HmdfStation *station = new HmdfStation(this);
+    station->setName(b.name);
+    station->setLatitude(b.latitude);
+    station->setLongitude(b.longitude);
+    station->setStorage(arena, b.offset, static_cast<size_t>(b.nParsed));
     this->addStation(station);
   }
 
+  file.unmap(map);
+  file.close();
+
   this->setNull(false);
 
+  double seconds = static_cast<double>(timer.nsecsElapsed()) / 1.0e9;
+  double megabytes = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+  this->m_readThroughput = seconds > 0.0 ? megabytes / seconds : 0.0;
+
   return 0;
 }
 
-int Hmdf::readNetcdf(QString filename) {
+double Hmdf::readThroughput() const { return this->m_readThroughput; }
+
+//...Moves every station series into a single arena so that the dates and
+//   values for the whole object are held in two contiguous allocations
+void Hmdf::pack() {
+  size_t nTotal = 0;
+  for (auto &s : this->m_station) nTotal += s->numSnaps();
+
+  QSharedPointer<HmdfArena> arena(new HmdfArena());
+  arena->allocate(nTotal);
+
+  size_t offset = 0;
+  for (auto &s : this->m_station) {
+    HmdfSpan<qint64> date = s->dateView();
+    HmdfSpan<double> data = s->dataView();
+    std::copy(date.begin(), date.end(), arena->date(offset));
+    std::copy(data.begin(), data.end(), arena->data(offset));
+    s->setStorage(arena, offset, date.size());
+    offset += date.size();
+  }
+  return;
+}
+
+int Hmdf::readNetcdf(QString filename, bool lazy) {
   NetcdfTimeseries *ncts = new NetcdfTimeseries(this);
   ncts->setFilename(filename);
+  ncts->setLazy(lazy);
   int ierr = ncts->read();
   if (ierr != 0) {
     delete ncts;
@@ -249,42 +395,44 @@ int Hmdf::writeImeds(QString filename) {
   return 0;
 }
 
-void Hmdf::deallocNcArrays(long long *time, double *data, char *name,
-                           char *id) {
-  delete[] time;
-  delete[] data;
-  delete[] name;
-  delete[] id;
-  return;
-}
-
 int Hmdf::writeNetcdf(QString filename) {
   int ncid;
-  int dimid_nstations, dimid_stationNameLength;
-  int varid_stationName, varid_stationx, varid_stationy;
-  int varid_stationId;
+  int dimid_nstations, dimid_stationNameLength, dimid_observations;
+  int varid_stationName, varid_stationx, varid_stationy, varid_stationId;
+  int varid_rowSize, varid_rowStart, varid_time, varid_data;
+
+  //...Every station is stored back to back in one contiguous ragged array
+  //   (CF discrete sampling geometry). rowStart and rowSize index the
+  //   observations belonging to each station
+  size_t nstations = static_cast<size_t>(this->nstations());
+  std::vector<long long> rowSize(nstations), rowStart(nstations);
+  size_t numObservations = 0;
+  for (size_t i = 0; i < nstations; i++) {
+    rowStart[i] = static_cast<long long>(numObservations);
+    rowSize[i] = this->station(i)->numSnaps();
+    numObservations += static_cast<size_t>(rowSize[i]);
+  }
 
-  QVector<int> dimid_stationLength;
-  QVector<int> varid_stationDate, varid_stationData;
+  //...Chunks cover a few typical stations so a single station is read from
+  //   a small number of chunks
+  size_t chunk[1] = {std::max<size_t>(
+      1, std::min<size_t>(numObservations, 16384))};
 
   //...Open file
   NCCHECK(nc_create(filename.toStdString().c_str(), NC_NETCDF4, &ncid));
 
-  //...Dimensions
-  NCCHECK(nc_def_dim(ncid, "numStations", this->nstations(), &dimid_nstations));
+  //...Dimensions. A zero length dimension would be unlimited, so an empty
+  //   file still gets one (unused) observation slot
+  NCCHECK(nc_def_dim(ncid, "numStations", nstations, &dimid_nstations));
   NCCHECK(nc_def_dim(ncid, "stationNameLen", 200, &dimid_stationNameLength));
-  for (int i = 0; i < this->nstations(); i++) {
-    QString dimname;
-    int d;
-    dimname.sprintf("%s%4.4i", "stationLength_", i + 1);
-    NCCHECK(nc_def_dim(ncid, dimname.toStdString().c_str(),
-                       this->station(i)->numSnaps(), &d));
-    dimid_stationLength.push_back(d);
-  }
+  NCCHECK(nc_def_dim(ncid, "numObservations",
+                     std::max<size_t>(numObservations, 1),
+                     &dimid_observations));
 
   //...Variables
   int stationNameDims[2] = {dimid_nstations, dimid_stationNameLength};
   int nstationDims[1] = {dimid_nstations};
+  int observationDims[1] = {dimid_observations};
   int wgs84[1] = {4326};
 
   NCCHECK(nc_def_var(ncid, "stationName", NC_CHAR, 2, stationNameDims,
@@ -295,58 +443,58 @@ int Hmdf::writeNetcdf(QString filename) {
                      &varid_stationx));
   NCCHECK(nc_def_var(ncid, "stationYCoordinate", NC_DOUBLE, 1, nstationDims,
                      &varid_stationy));
+  NCCHECK(nc_def_var(ncid, "rowSize", NC_INT64, 1, nstationDims,
+                     &varid_rowSize));
+  NCCHECK(nc_def_var(ncid, "rowStart", NC_INT64, 1, nstationDims,
+                     &varid_rowStart));
+  NCCHECK(nc_def_var(ncid, "time", NC_INT64, 1, observationDims,
+                     &varid_time));
+  NCCHECK(nc_def_var(ncid, "data", NC_DOUBLE, 1, observationDims,
+                     &varid_data));
+
+  NCCHECK(nc_put_att_text(ncid, varid_stationName, "cf_role", 13,
+                          "timeseries_id"));
 
   NCCHECK(nc_put_att_text(ncid, varid_stationx, "HorizontalProjectionName", 5,
                           "WGS84"));
   NCCHECK(nc_put_att_text(ncid, varid_stationy, "HorizontalProjectionName", 5,
                           "WGS84"));
+  NCCHECK(nc_put_att_text(ncid, varid_stationx, "standard_name", 9,
+                          "longitude"));
+  NCCHECK(nc_put_att_text(ncid, varid_stationy, "standard_name", 8,
+                          "latitude"));
+  NCCHECK(nc_put_att_text(ncid, varid_stationx, "units", 12, "degrees_east"));
+  NCCHECK(nc_put_att_text(ncid, varid_stationy, "units", 13, "degrees_north"));
 
   NCCHECK(nc_put_att_int(ncid, varid_stationx, "HorizontalProjectionEPSG",
                          NC_INT, 1, wgs84));
   NCCHECK(nc_put_att_int(ncid, varid_stationy, "HorizontalProjectionEPSG",
                          NC_INT, 1, wgs84));
 
-  for (int i = 0; i < this->nstations(); i++) {
-    QString stationName, timeVarName, dataVarName;
-    int d[1] = {dimid_stationLength[i]};
-    char epoch[20] = "1970-01-01 00:00:00";
-    char utc[4] = "utc";
-    char timeunit[27] = "second since referenceDate";
-    int v;
-
-    stationName.sprintf("%s%4.4i", "station_", i + 1);
-    timeVarName = "time_" + stationName;
-    dataVarName = "data_" + stationName;
-
-    NCCHECK(nc_def_var(ncid, timeVarName.toStdString().c_str(), NC_INT64, 1, d,
-                       &v));
-    NCCHECK(nc_put_att_text(ncid, v, "StationName",
-                            this->station(i)->name().length(),
-                            this->station(i)->name().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "StationID",
-                            this->station(i)->id().length(),
-                            this->station(i)->id().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "referenceDate", 20, epoch));
-    NCCHECK(nc_put_att_text(ncid, v, "timezone", 3, utc));
-    NCCHECK(nc_put_att_text(ncid, v, "units", 3, timeunit));
-    NCCHECK(nc_def_var_deflate(ncid, v, 1, 1, 2));
-    varid_stationDate.push_back(v);
-
-    NCCHECK(nc_def_var(ncid, dataVarName.toStdString().c_str(), NC_DOUBLE, 1, d,
-                       &v));
-    NCCHECK(nc_put_att_text(ncid, v, "StationName",
-                            this->station(i)->name().length(),
-                            this->station(i)->name().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "StationID",
-                            this->station(i)->id().length(),
-                            this->station(i)->id().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "units", this->units().length(),
-                            this->units().toStdString().c_str()));
-    NCCHECK(nc_put_att_text(ncid, v, "datum", this->datum().length(),
-                            this->datum().toStdString().c_str()));
-    NCCHECK(nc_def_var_deflate(ncid, v, 1, 1, 2));
-    varid_stationData.push_back(v);
-  }
+  NCCHECK(nc_put_att_text(ncid, varid_rowSize, "sample_dimension", 15,
+                          "numObservations"));
+  NCCHECK(nc_put_att_text(ncid, varid_rowStart, "long_name", 30,
+                          "offset of first station sample"));
+
+  char epoch[20] = "1970-01-01 00:00:00";
+  char utc[4] = "utc";
+  char timeunit[34] = "seconds since 1970-01-01 00:00:00";
+  char coordinates[46] = "time stationYCoordinate stationXCoordinate";
+  NCCHECK(nc_put_att_text(ncid, varid_time, "referenceDate", 20, epoch));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "timezone", 3, utc));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "units", 33, timeunit));
+  NCCHECK(nc_put_att_text(ncid, varid_time, "standard_name", 4, "time"));
+  NCCHECK(nc_def_var_chunking(ncid, varid_time, NC_CHUNKED, chunk));
+  NCCHECK(nc_def_var_deflate(ncid, varid_time, 1, 1, 2));
+
+  NCCHECK(nc_put_att_text(ncid, varid_data, "units", this->units().length(),
+                          this->units().toStdString().c_str()));
+  NCCHECK(nc_put_att_text(ncid, varid_data, "datum", this->datum().length(),
+                          this->datum().toStdString().c_str()));
+  NCCHECK(nc_put_att_text(ncid, varid_data, "coordinates",
+                          strlen(coordinates), coordinates));
+  NCCHECK(nc_def_var_chunking(ncid, varid_data, NC_CHUNKED, chunk));
+  NCCHECK(nc_def_var_deflate(ncid, varid_data, 1, 1, 2));
 
   //...Metadata
   QString name = qgetenv("USER");
@@ -356,7 +504,9 @@ int Hmdf::writeNetcdf(QString filename) {
       QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd hh:mm:ss");
   QString source = "MetOceanViewer";
   QString ncVersion = QString(nc_inq_libvers());
-  QString format = "20180123";
+  QString format = NetcdfTimeseries::formatRaggedArray();
+  QString featureType = "timeSeries";
+  QString conventions = "CF-1.6";
 
   NCCHECK(nc_put_att(ncid, NC_GLOBAL, "source", NC_CHAR, source.length(),
                      source.toStdString().c_str()));
@@ -370,81 +520,52 @@ int Hmdf::writeNetcdf(QString filename) {
                      ncVersion.length(), ncVersion.toStdString().c_str()));
   NCCHECK(nc_put_att(ncid, NC_GLOBAL, "fileformat", NC_CHAR, format.length(),
                      format.toStdString().c_str()));
+  NCCHECK(nc_put_att(ncid, NC_GLOBAL, "featureType", NC_CHAR,
+                     featureType.length(), featureType.toStdString().c_str()));
+  NCCHECK(nc_put_att(ncid, NC_GLOBAL, "Conventions", NC_CHAR,
+                     conventions.length(), conventions.toStdString().c_str()));
 
   NCCHECK(nc_enddef(ncid));
 
-  for (size_t i = 0; i < this->nstations(); i++) {
-    size_t index[2] = {i, 0};
-    size_t stindex[1] = {i};
-    size_t count[2] = {1, 200};
-    double lat[1] = {this->station(i)->latitude()};
-    double lon[1] = {this->station(i)->longitude()};
-
-    long long *time = new long long[this->station(i)->numSnaps()];
-    double *data = new double[this->station(i)->numSnaps()];
-    char *name = new char[200];
-    char *id = new char[200];
-
-    memset(name, ' ', 200);
-    memset(id, ' ', 200);
-
-    this->station(i)->name().toStdString().copy(
-        name, this->station(i)->name().length(), 0);
-    this->station(i)->id().toStdString().copy(
-        id, this->station(i)->id().length(), 0);
-
-    for (int j = 0; j < this->station(i)->numSnaps(); j++) {
-      time[j] = this->station(i)->date(j) / 1000;
-      data[j] = this->station(i)->data(j);
-    }
-
-    int status = nc_put_var1_double(ncid, varid_stationx, stindex, lon);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_var1_double(ncid, varid_stationy, stindex, lat);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_var_longlong(ncid, varid_stationDate[i], time);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_var_double(ncid, varid_stationData[i], data);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_vara_text(ncid, varid_stationName, index, count, name);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
-    }
-
-    status = nc_put_vara_text(ncid, varid_stationId, index, count, id);
-    if (status != NC_NOERR) {
-      this->deallocNcArrays(time, data, name, id);
-      nc_close(ncid);
-      return status;
+  //...Gather everything so each variable is written in a single call
+  std::vector<char> names(nstations * 200, ' ');
+  std::vector<char> ids(nstations * 200, ' ');
+  std::vector<double> lon(nstations), lat(nstations);
+  std::vector<long long> time(numObservations);
+  std::vector<double> data(numObservations);
+
+  for (size_t i = 0; i < nstations; i++) {
+    HmdfStation *s = this->station(i);
+    std::string stationName = s->name().toStdString();
+    std::string stationId = s->id().toStdString();
+    stationName.copy(&names[i * 200],
+                     std::min<size_t>(stationName.size(), 200));
+    stationId.copy(&ids[i * 200], std::min<size_t>(stationId.size(), 200));
+    lon[i] = s->longitude();
+    lat[i] = s->latitude();
+
+    long long *t = time.data() + rowStart[i];
+    double *v = data.data() + rowStart[i];
+    for (int j = 0; j < s->numSnaps(); j++) {
+      t[j] = s->date(j) / 1000;
+      v[j] = s->data(j);
     }
+  }
 
-    ;
-    this->deallocNcArrays(time, data, name, id);
+  if (nstations > 0) {
+    NCCHECK(nc_put_var_text(ncid, varid_stationName, names.data()));
+    NCCHECK(nc_put_var_text(ncid, varid_stationId, ids.data()));
+    NCCHECK(nc_put_var_double(ncid, varid_stationx, lon.data()));
+    NCCHECK(nc_put_var_double(ncid, varid_stationy, lat.data()));
+    NCCHECK(nc_put_var_longlong(ncid, varid_rowSize, rowSize.data()));
+    NCCHECK(nc_put_var_longlong(ncid, varid_rowStart, rowStart.data()));
+  }
+  if (numObservations > 0) {
+    NCCHECK(nc_put_var_longlong(ncid, varid_time, time.data()));
+    NCCHECK(nc_put_var_double(ncid, varid_data, data.data()));
   }
 
-  nc_close(ncid);
+  NCCHECK(nc_close(ncid));
 
   return 0;
 }
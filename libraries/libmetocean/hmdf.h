@@ -49,8 +49,12 @@ class Hmdf : public QObject {
   int writeCsv(QString filename);
   int writeNetcdf(QString filename);
 
-  int readImeds(QString filename);
-  int readNetcdf(QString filename);
+  int readImeds(QString filename, bool parallel = false);
+  int readNetcdf(QString filename, bool lazy = false);
+
+  double readThroughput() const;
+
+  void pack();
 
   size_t nstations() const;
   // void setNstations(size_t nstations);
@@ -88,10 +92,10 @@ class Hmdf : public QObject {
 
  private:
   void init();
-  void deallocNcArrays(long long *time, double *data, char *name, char *id);
 
   //...Variables
   bool m_success, m_null;
+  double m_readThroughput;
 
   Timezone m_tz;
   QString m_header1;
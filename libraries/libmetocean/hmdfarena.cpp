@@ -1,7 +1,7 @@
 /*-------------------------------GPL-------------------------------------//
 //
 // MetOcean Viewer - A simple interface for viewing hydrodynamic model data
-// Copyright (C) 2018  Zach Cobell
+// Copyright (C) 2019  Zach Cobell
 //
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -17,37 +17,34 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 //-----------------------------------------------------------------------*/
-#ifndef CRMSDATACONTAINER_H
-#define CRMSDATACONTAINER_H
+#include "hmdfarena.h"
 
-#include <string>
+HmdfArena::HmdfArena() {}
 
-class CrmsDataContainer {
- public:
-  CrmsDataContainer(size_t size);
-  ~CrmsDataContainer();
-  CrmsDataContainer(const CrmsDataContainer &c);
+void HmdfArena::reserve(size_t n) {
+  this->m_date.reserve(n);
+  this->m_data.reserve(n);
+}
 
-  std::string id() const;
-  void setId(const std::string &id);
+//...Appends n slots and returns the offset of the first one. Views and
+//   pointers obtained before this call may be invalidated.
+size_t HmdfArena::allocate(size_t n) {
+  size_t offset = this->m_date.size();
+  this->m_date.resize(offset + n);
+  this->m_data.resize(offset + n);
+  return offset;
+}
 
-  bool valid() const;
-  void setValid(bool valid);
+size_t HmdfArena::size() const { return this->m_date.size(); }
 
-  long long datetime() const;
-  void setDatetime(long long datetime);
+qint64 *HmdfArena::date(size_t offset) { return this->m_date.data() + offset; }
 
-  float value(size_t index) const;
-  void setValue(size_t index, float value);
+const qint64 *HmdfArena::date(size_t offset) const {
+  return this->m_date.data() + offset;
+}
 
-  size_t size() const;
+double *HmdfArena::data(size_t offset) { return this->m_data.data() + offset; }
 
-private:
-  std::string m_id;
-  bool m_valid;
-  size_t m_size;
-  long long m_datetime;
-  float *m_values;
-};
-
-#endif  // CRMSDATACONTAINER_H
+const double *HmdfArena::data(size_t offset) const {
+  return this->m_data.data() + offset;
+}
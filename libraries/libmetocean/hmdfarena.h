@@ -0,0 +1,74 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFARENA_H
+#define HMDFARENA_H
+
+#include <QtGlobal>
+#include <vector>
+#include "metocean_global.h"
+
+//...Read-only view over a contiguous run of values. The view does not own
+//   the memory it points at and is invalidated if the underlying storage is
+//   reallocated.
+template <typename T>
+class HmdfSpan {
+ public:
+  HmdfSpan() : m_data(nullptr), m_size(0) {}
+  HmdfSpan(const T *data, size_t size) : m_data(data), m_size(size) {}
+
+  const T *data() const { return this->m_data; }
+  size_t size() const { return this->m_size; }
+  bool empty() const { return this->m_size == 0; }
+
+  const T *begin() const { return this->m_data; }
+  const T *end() const { return this->m_data + this->m_size; }
+
+  const T &operator[](size_t index) const { return this->m_data[index]; }
+
+ private:
+  const T *m_data;
+  size_t m_size;
+};
+
+//...Columnar storage shared by the stations of an Hmdf object. Dates and
+//   values for every station are held in two contiguous arrays and each
+//   station refers to its own [offset, offset + length) slice.
+class HmdfArena {
+ public:
+  HmdfArena();
+
+  void reserve(size_t n);
+
+  size_t allocate(size_t n);
+
+  size_t size() const;
+
+  qint64 *date(size_t offset);
+  const qint64 *date(size_t offset) const;
+
+  double *data(size_t offset);
+  const double *data(size_t offset) const;
+
+ private:
+  std::vector<qint64> m_date;
+  std::vector<double> m_data;
+};
+
+#endif  // HMDFARENA_H
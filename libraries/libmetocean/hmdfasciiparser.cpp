@@ -21,6 +21,7 @@
 #include "boost/config/warning_disable.hpp"
 #include "boost/fusion/include/adapt_struct.hpp"
 #include "boost/fusion/include/io.hpp"
+#include "boost/optional.hpp"
 #include "boost/spirit/include/phoenix_core.hpp"
 #include "boost/spirit/include/phoenix_object.hpp"
 #include "boost/spirit/include/phoenix_operator.hpp"
@@ -35,98 +36,104 @@ namespace parse {
 namespace qi = boost::spirit::qi;
 namespace ascii = boost::spirit::ascii;
 
-struct hmdfAsciiwSec {
+//...The seconds column is optional in IMEDS files. Both forms are read
+//   with a single grammar: five integers followed by one or two reals. When
+//   two reals are present, the first is the seconds column.
+struct hmdfAscii {
   int yr;
   int mo;
   int da;
   int hr;
   int min;
-  int sec;
-  double val;
-};
-
-struct hmdfAsciiwoSec {
-  int yr;
-  int mo;
-  int da;
-  int hr;
-  int min;
-  double val;
+  double v1;
+  boost::optional<double> v2;
 };
 }  // namespace parse
 
-BOOST_FUSION_ADAPT_STRUCT(
-    parse::hmdfAsciiwSec,
-    (int, yr)(int, mo)(int, da)(int, hr)(int, min)(int, sec)(double, val))
+BOOST_FUSION_ADAPT_STRUCT(parse::hmdfAscii,
+                          (int, yr)(int, mo)(int, da)(int, hr)(int, min)(
+                              double, v1)(boost::optional<double>, v2))
 
-BOOST_FUSION_ADAPT_STRUCT(parse::hmdfAsciiwoSec,
-                          (int, yr)(int, mo)(int, da)(int, hr)(int, min)(double,
-                                                                         val))
 namespace parse {
 template <typename Iterator>
-struct hmdfAsciiwSec_parser
-    : qi::grammar<Iterator, hmdfAsciiwSec(), ascii::space_type> {
-  hmdfAsciiwSec_parser() : hmdfAsciiwSec_parser::base_type(start) {
-    using qi::double_;
-    using qi::int_;
-    start %= int_ >> int_ >> int_ >> int_ >> int_ >> int_ >> double_;
-  }
-  qi::rule<Iterator, hmdfAsciiwSec(), ascii::space_type> start;
-};
-
-template <typename Iterator>
-struct hmdfAsciiwoSec_parser
-    : qi::grammar<Iterator, hmdfAsciiwoSec(), ascii::space_type> {
-  hmdfAsciiwoSec_parser() : hmdfAsciiwoSec_parser::base_type(start) {
+struct hmdfAscii_parser
+    : qi::grammar<Iterator, hmdfAscii(), ascii::space_type> {
+  hmdfAscii_parser() : hmdfAscii_parser::base_type(start) {
     using qi::double_;
     using qi::int_;
-    start %= int_ >> int_ >> int_ >> int_ >> int_ >> double_;
+    start %= int_ >> int_ >> int_ >> int_ >> int_ >> double_ >> -double_;
   }
-  qi::rule<Iterator, hmdfAsciiwoSec(), ascii::space_type> start;
+  qi::rule<Iterator, hmdfAscii(), ascii::space_type> start;
 };
 }  // namespace parse
 
-typedef std::string::const_iterator iterator_type;
-typedef parse::hmdfAsciiwSec_parser<iterator_type> hmdfwsec_parser;
-typedef parse::hmdfAsciiwoSec_parser<iterator_type> hmdfwosec_parser;
+typedef const char *iterator_type;
+typedef parse::hmdfAscii_parser<iterator_type> hmdf_parser;
+
+//...The grammar is built once and shared. Parsing does not modify the
+//   grammar, so it is safe to use from multiple threads.
+static const hmdf_parser &hmdfGrammar() {
+  static const hmdf_parser p;
+  return p;
+}
 
 //--END BOOST SPIRIT PARSER--//
 
-bool HmdfAsciiParser::splitStringHmdfFormat(std::string &data, int &yr, int &month,
-                                            int &day, int &hr, int &min,
-                                            int &sec, double &value) {
-  using namespace parse;
-  hmdfwsec_parser p1;
-  hmdfwosec_parser p2;
-  hmdfAsciiwSec r1;
-  hmdfAsciiwoSec r2;
-
-  std::string::const_iterator iter = data.begin();
-  std::string::const_iterator end = data.end();
-
-  bool r = phrase_parse(iter, end, p1, space, r1);
-  if (r) {
-    yr = r1.yr;
-    month = r1.mo;
-    day = r1.da;
-    hr = r1.hr;
-    min = r1.min;
-    sec = r1.sec;
-    value = r1.val;
-    return true;
+bool HmdfAsciiParser::splitStringHmdfFormat(std::string &data, int &yr,
+                                            int &month, int &day, int &hr,
+                                            int &min, int &sec,
+                                            double &value) {
+  parse::hmdfAscii r;
+  iterator_type iter = data.data();
+  iterator_type end = data.data() + data.size();
+
+  if (!phrase_parse(iter, end, hmdfGrammar(), space, r)) return false;
+
+  yr = r.yr;
+  month = r.mo;
+  day = r.da;
+  hr = r.hr;
+  min = r.min;
+  if (r.v2) {
+    sec = static_cast<int>(r.v1);
+    value = *r.v2;
   } else {
-    bool r = phrase_parse(iter, end, p2, space, r2);
-    if (r) {
-      yr = r2.yr;
-      month = r2.mo;
-      day = r2.da;
-      hr = r2.hr;
-      min = r2.min;
-      sec = 0;
-      value = r2.val;
-      return true;
-    } else {
-      return false;
-    }
+    sec = 0;
+    value = r.v1;
   }
+  return true;
+}
+
+bool HmdfAsciiParser::parseImedsRecord(const char *begin, const char *end,
+                                       long long &msecsSinceEpoch,
+                                       double &value) {
+  parse::hmdfAscii r;
+  if (!phrase_parse(begin, end, hmdfGrammar(), space, r)) return false;
+
+  int sec;
+  if (r.v2) {
+    sec = static_cast<int>(r.v1);
+    value = *r.v2;
+  } else {
+    sec = 0;
+    value = r.v1;
+  }
+  msecsSinceEpoch =
+      HmdfAsciiParser::toMSecsSinceEpoch(r.yr, r.mo, r.da, r.hr, r.min, sec);
+  return true;
+}
+
+//...Days since 1970-01-01 in the proleptic Gregorian calendar using integer
+//   arithmetic only (H. Hinnant, "chrono-Compatible Low-Level Date
+//   Algorithms")
+long long HmdfAsciiParser::toMSecsSinceEpoch(int yr, int month, int day,
+                                             int hr, int min, int sec) {
+  const long long y = month <= 2 ? yr - 1 : yr;
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const long long yoe = y - era * 400;
+  const long long doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+                        day - 1;
+  const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  const long long days = era * 146097 + doe - 719468;
+  return ((days * 24 + hr) * 60 + min) * 60000LL + sec * 1000LL;
 }
@@ -27,6 +27,12 @@ class HmdfAsciiParser {
   static bool splitStringHmdfFormat(std::string &data, int &yr, int &month,
                                     int &day, int &hr, int &min, int &sec,
                                     double &value);
+
+  static bool parseImedsRecord(const char *begin, const char *end,
+                               long long &msecsSinceEpoch, double &value);
+
+  static long long toMSecsSinceEpoch(int yr, int month, int day, int hr,
+                                     int min, int sec);
 };
 
 #endif  // HMDFASCIIPARSER_H
@@ -26,6 +26,18 @@ HmdfStation::HmdfStation(QObject *parent) : QObject(parent) {
   this->m_isNull = true;
   this->m_stationIndex = 0;
   this->m_nullValue = HmdfStation::nullDataValue();
+  this->m_arenaOffset = 0;
+  this->m_arenaLength = 0;
+  this->m_loaderIndex = 0;
+  this->m_loaderLength = 0;
+  this->m_loaded = false;
+  this->m_dateReplaced = false;
+  this->m_dataReplaced = false;
+  this->m_lastAccess = 0;
+}
+
+HmdfStation::~HmdfStation() {
+  if (this->m_loader) this->m_loader->release(this);
 }
 
 void HmdfStation::clear() {
@@ -36,6 +48,10 @@ void HmdfStation::clear() {
   this->m_stationIndex = 0;
   this->m_data.clear();
   this->m_date.clear();
+  this->m_arena.clear();
+  this->m_arenaOffset = 0;
+  this->m_arenaLength = 0;
+  this->setLoader(QSharedPointer<HmdfStationLoader>(), 0, 0);
   return;
 }
 
@@ -47,7 +63,11 @@ QString HmdfStation::id() const { return this->m_id; }
 
 void HmdfStation::setId(const QString &id) { this->m_id = id; }
 
-size_t HmdfStation::numSnaps() const { return this->m_data.size(); }
+size_t HmdfStation::numSnaps() const {
+  if (this->m_loader && !this->m_dataReplaced) return this->m_loaderLength;
+  if (this->m_arena) return this->m_arenaLength;
+  return this->m_data.size();
+}
 
 int HmdfStation::stationIndex() const { return this->m_stationIndex; }
 
@@ -58,7 +78,7 @@ void HmdfStation::setStationIndex(int stationIndex) {
 qint64 HmdfStation::date(int index) const {
   Q_ASSERT(index >= 0 && index < this->numSnaps());
   if (index >= 0 || index < this->numSnaps())
-    return this->m_date[index];
+    return this->dateView()[index];
   else
     return 0;
 }
@@ -66,19 +86,31 @@ qint64 HmdfStation::date(int index) const {
 double HmdfStation::data(int index) const {
   Q_ASSERT(index >= 0 && index < this->numSnaps());
   if (index >= 0 || index < this->numSnaps())
-    return this->m_data[index];
+    return this->dataView()[index];
   else
     return 0;
 }
 
 void HmdfStation::setData(const double &data, int index) {
   Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps()) this->m_data[index] = data;
+  if (index >= 0 || index < this->numSnaps()) {
+    if (this->m_loader) this->detach();
+    if (this->m_arena)
+      this->m_arena->data(this->m_arenaOffset)[index] = data;
+    else
+      this->m_data[index] = data;
+  }
 }
 
 void HmdfStation::setDate(const qint64 &date, int index) {
   Q_ASSERT(index >= 0 && index < this->numSnaps());
-  if (index >= 0 || index < this->numSnaps()) this->m_date[index] = date;
+  if (index >= 0 || index < this->numSnaps()) {
+    if (this->m_loader) this->detach();
+    if (this->m_arena)
+      this->m_arena->date(this->m_arenaOffset)[index] = date;
+    else
+      this->m_date[index] = date;
+  }
 }
 
 bool HmdfStation::isNull() const { return this->m_isNull; }
@@ -86,31 +118,168 @@ bool HmdfStation::isNull() const { return this->m_isNull; }
 void HmdfStation::setIsNull(bool isNull) { this->m_isNull = isNull; }
 
 void HmdfStation::setDate(const QVector<qint64> &date) {
-  this->m_date = date;
+  if (this->m_loader) {
+    this->m_dateReplaced = true;
+    this->m_date = date;
+    this->replaceLoaded();
+  } else {
+    this->detach();
+    this->m_date = date;
+  }
   return;
 }
 
 void HmdfStation::setData(const QVector<double> &data) {
-  this->m_data = data;
+  if (this->m_loader) {
+    this->m_dataReplaced = true;
+    this->m_data = data;
+    this->replaceLoaded();
+  } else {
+    this->detach();
+    this->m_data = data;
+  }
   return;
 }
 
 void HmdfStation::setData(const QVector<float> &data) {
-  this->m_data.resize(data.size());
+  QVector<double> d(data.size());
   for (size_t i = 0; i < data.size(); ++i) {
-    this->m_data[i] = static_cast<double>(data[i]);
+    d[i] = static_cast<double>(data[i]);
   }
+  this->setData(d);
   return;
 }
 
 void HmdfStation::setNext(const qint64 &date, const double &data) {
+  this->detach();
   this->m_date.push_back(date);
   this->m_data.push_back(data);
 }
 
-QVector<qint64> HmdfStation::allDate() const { return this->m_date; }
+QVector<qint64> HmdfStation::allDate() const {
+  this->fetch();
+  if (!this->m_arena) return this->m_date;
+  HmdfSpan<qint64> v = this->dateView();
+  QVector<qint64> date(static_cast<int>(v.size()));
+  std::copy(v.begin(), v.end(), date.begin());
+  return date;
+}
 
-QVector<double> HmdfStation::allData() const { return this->m_data; }
+QVector<double> HmdfStation::allData() const {
+  this->fetch();
+  if (!this->m_arena) return this->m_data;
+  HmdfSpan<double> v = this->dataView();
+  QVector<double> data(static_cast<int>(v.size()));
+  std::copy(v.begin(), v.end(), data.begin());
+  return data;
+}
+
+//...Views over the series without copying. These remain valid until the
+//   station or its arena is modified, or for lazily loaded stations until
+//   the loader releases the series to make room for another station.
+HmdfSpan<qint64> HmdfStation::dateView() const {
+  this->fetch();
+  if (this->m_arena) {
+    const HmdfArena *a = this->m_arena.data();
+    return HmdfSpan<qint64>(a->date(this->m_arenaOffset), this->m_arenaLength);
+  }
+  return HmdfSpan<qint64>(this->m_date.constData(),
+                          static_cast<size_t>(this->m_date.size()));
+}
+
+HmdfSpan<double> HmdfStation::dataView() const {
+  this->fetch();
+  if (this->m_arena) {
+    const HmdfArena *a = this->m_arena.data();
+    return HmdfSpan<double>(a->data(this->m_arenaOffset), this->m_arenaLength);
+  }
+  return HmdfSpan<double>(this->m_data.constData(),
+                          static_cast<size_t>(this->m_data.size()));
+}
+
+void HmdfStation::setStorage(QSharedPointer<HmdfArena> arena, size_t offset,
+                             size_t length) {
+  this->setLoader(QSharedPointer<HmdfStationLoader>(), 0, 0);
+  this->m_date.clear();
+  this->m_data.clear();
+  this->m_arena = arena;
+  this->m_arenaOffset = offset;
+  this->m_arenaLength = length;
+}
+
+bool HmdfStation::isArenaBacked() const { return !this->m_arena.isNull(); }
+
+//...Attaches the station to a loader. Only the length is known until the
+//   series is first accessed. A null loader detaches the station and drops
+//   any series it has loaded.
+void HmdfStation::setLoader(QSharedPointer<HmdfStationLoader> loader,
+                            size_t index, size_t length) {
+  if (this->m_loader) this->m_loader->release(this);
+  this->m_date.clear();
+  this->m_data.clear();
+  this->m_arena.clear();
+  this->m_arenaOffset = 0;
+  this->m_arenaLength = 0;
+  this->m_loader = loader;
+  this->m_loaderIndex = index;
+  this->m_loaderLength = loader ? length : 0;
+  this->m_loaded = false;
+  this->m_dateReplaced = false;
+  this->m_dataReplaced = false;
+}
+
+bool HmdfStation::isLoaded() const { return !this->m_loader || this->m_loaded; }
+
+void HmdfStation::fetch() const {
+  if (!this->m_loader) return;
+  if (this->m_loaded)
+    this->m_loader->touch(this);
+  else
+    this->m_loader->load(this);
+}
+
+//...Called by the loader when the series is evicted
+void HmdfStation::unload() const {
+  if (!this->m_dateReplaced) this->m_date = QVector<qint64>();
+  if (!this->m_dataReplaced) this->m_data = QVector<double>();
+  this->m_loaded = false;
+}
+
+//...Moves an arena backed or lazily loaded series into station owned
+//   vectors so that it can change length or be modified
+void HmdfStation::detach() {
+  if (this->m_loader) {
+    this->fetch();
+    this->dropLoader();
+    return;
+  }
+  if (!this->m_arena) return;
+  this->m_date = this->allDate();
+  this->m_data = this->allData();
+  this->m_arena.clear();
+  this->m_arenaOffset = 0;
+  this->m_arenaLength = 0;
+}
+
+//...Called after one series of a lazily loaded station has been replaced.
+//   Only the other series is still wanted from the loader, so nothing is
+//   read here. The station keeps its series once both are in memory,
+//   otherwise the loader fills in the other one when it is first accessed.
+void HmdfStation::replaceLoaded() {
+  if (this->m_loaded || (this->m_dateReplaced && this->m_dataReplaced))
+    this->dropLoader();
+}
+
+//...Forgets the loader and keeps whatever series the station holds
+void HmdfStation::dropLoader() {
+  this->m_loader->release(this);
+  this->m_loader.clear();
+  this->m_loaderIndex = 0;
+  this->m_loaderLength = 0;
+  this->m_loaded = false;
+  this->m_dateReplaced = false;
+  this->m_dataReplaced = false;
+}
 
 void HmdfStation::setLatitude(const double latitude) {
   this->m_coordinate.setLatitude(latitude);
@@ -132,10 +301,13 @@ QGeoCoordinate *HmdfStation::coordinate() { return &this->m_coordinate; }
 
 void HmdfStation::dataBounds(qint64 &minDate, qint64 &maxDate, double &minValue,
                              double &maxValue) {
-  minDate = *std::min_element(this->m_date.begin(), this->m_date.end());
-  maxDate = *std::max_element(this->m_date.begin(), this->m_date.end());
+  HmdfSpan<qint64> date = this->dateView();
+  HmdfSpan<double> data = this->dataView();
 
-  std::vector<double> sortedData = this->m_data.toStdVector();
+  minDate = *std::min_element(date.begin(), date.end());
+  maxDate = *std::max_element(date.begin(), date.end());
+
+  std::vector<double> sortedData(data.begin(), data.end());
   std::sort(sortedData.begin(), sortedData.end());
 
   if (sortedData.front() != sortedData.back()) {
@@ -176,8 +348,13 @@ int HmdfStation::applyDatumCorrection(Station s, Datum::VDatum datum) {
 
   if (s.isNullOffset(shift)) return 1;
 
-  for (auto &d : this->m_data) {
-    d += shift;
+  //...A corrected series must not be reread from the file
+  if (this->m_loader) this->detach();
+
+  double *data = this->m_arena ? this->m_arena->data(this->m_arenaOffset)
+                               : this->m_data.data();
+  for (size_t i = 0; i < this->numSnaps(); ++i) {
+    data[i] += shift;
   }
 
   return 0;
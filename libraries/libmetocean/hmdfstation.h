@@ -22,9 +22,12 @@
 
 #include <QGeoCoordinate>
 #include <QObject>
+#include <QSharedPointer>
 #include <QString>
 #include <QVector>
 #include "datum.h"
+#include "hmdfarena.h"
+#include "hmdfstationloader.h"
 #include "metocean_global.h"
 #include "station.h"
 
@@ -33,6 +36,7 @@ class HmdfStation : public QObject {
 
  public:
   explicit HmdfStation(QObject *parent = nullptr);
+  ~HmdfStation();
 
   void clear();
 
@@ -81,6 +85,17 @@ class HmdfStation : public QObject {
   QVector<qint64> allDate() const;
   QVector<double> allData() const;
 
+  HmdfSpan<qint64> dateView() const;
+  HmdfSpan<double> dataView() const;
+
+  void setStorage(QSharedPointer<HmdfArena> arena, size_t offset,
+                  size_t length);
+  bool isArenaBacked() const;
+
+  void setLoader(QSharedPointer<HmdfStationLoader> loader, size_t index,
+                 size_t length);
+  bool isLoaded() const;
+
   void dataBounds(qint64 &minDate, qint64 &maxDate, double &minValue,
                   double &maxValue);
 
@@ -90,6 +105,14 @@ class HmdfStation : public QObject {
   int applyDatumCorrection(Station s, Datum::VDatum datum);
 
  private:
+  friend class HmdfStationLoader;
+
+  void detach();
+  void replaceLoaded();
+  void dropLoader();
+  void fetch() const;
+  void unload() const;
+
   QGeoCoordinate m_coordinate;
 
   QString m_name;
@@ -99,8 +122,28 @@ class HmdfStation : public QObject {
 
   double m_nullValue;
 
-  QVector<qint64> m_date;
-  QVector<double> m_data;
+  //...Mutable so that a lazily loaded series can be read in or released
+  //   by its loader from const accessors
+  mutable QVector<qint64> m_date;
+  mutable QVector<double> m_data;
+
+  //...When set, the series lives in the shared arena instead of
+  //   m_date/m_data
+  QSharedPointer<HmdfArena> m_arena;
+  size_t m_arenaOffset;
+  size_t m_arenaLength;
+
+  //...When set, the series is read from the loader on first access
+  QSharedPointer<HmdfStationLoader> m_loader;
+  size_t m_loaderIndex;
+  size_t m_loaderLength;
+  mutable bool m_loaded;
+
+  //...Series assigned while attached to a loader. These are kept when the
+  //   loader reads or evicts the station.
+  bool m_dateReplaced;
+  bool m_dataReplaced;
+  mutable quint64 m_lastAccess;
 
   bool m_isNull;
 };
@@ -0,0 +1,91 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "hmdfstationloader.h"
+#include <algorithm>
+#include "hmdfstation.h"
+
+HmdfStationLoader::HmdfStationLoader(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1)), m_clock(0) {}
+
+//...Stations hold a reference to their loader, so none can be resident
+//   once it is destroyed
+HmdfStationLoader::~HmdfStationLoader() {}
+
+size_t HmdfStationLoader::capacity() const { return this->m_capacity; }
+
+void HmdfStationLoader::setCapacity(size_t capacity) {
+  this->m_capacity = std::max<size_t>(capacity, 1);
+  this->evict(this->m_capacity);
+}
+
+size_t HmdfStationLoader::resident() const {
+  return static_cast<size_t>(this->m_resident.size());
+}
+
+void HmdfStationLoader::load(const HmdfStation *station) {
+  this->evict(this->m_capacity - 1);
+
+  //...A series the station has replaced is read into scratch space so that
+  //   it is not overwritten
+  const int length = static_cast<int>(station->m_loaderLength);
+  QVector<qint64> scratchDate;
+  QVector<double> scratchData;
+  QVector<qint64> &date =
+      station->m_dateReplaced ? scratchDate : station->m_date;
+  QVector<double> &data =
+      station->m_dataReplaced ? scratchData : station->m_data;
+  date.resize(length);
+  data.resize(length);
+
+  int ierr = this->readStation(station->m_loaderIndex,
+                               station->m_loaderLength, date.data(),
+                               data.data());
+  if (ierr != 0) {
+    std::fill(date.begin(), date.end(), HmdfStation::nullDateValue());
+    std::fill(data.begin(), data.end(), HmdfStation::nullDataValue());
+  }
+
+  station->m_loaded = true;
+  station->m_lastAccess = ++this->m_clock;
+  this->m_resident.push_back(station);
+}
+
+void HmdfStationLoader::touch(const HmdfStation *station) {
+  station->m_lastAccess = ++this->m_clock;
+}
+
+//...Forgets a station without dropping its series. Used when the station
+//   takes ownership of the data or is destroyed.
+void HmdfStationLoader::release(const HmdfStation *station) {
+  this->m_resident.removeOne(station);
+}
+
+//...Releases the least recently used stations until at most keep remain
+void HmdfStationLoader::evict(size_t keep) {
+  while (static_cast<size_t>(this->m_resident.size()) > keep) {
+    auto oldest = std::min_element(
+        this->m_resident.begin(), this->m_resident.end(),
+        [](const HmdfStation *a, const HmdfStation *b) {
+          return a->m_lastAccess < b->m_lastAccess;
+        });
+    (*oldest)->unload();
+    this->m_resident.erase(oldest);
+  }
+}
@@ -0,0 +1,66 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef HMDFSTATIONLOADER_H
+#define HMDFSTATIONLOADER_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "metocean_global.h"
+
+class HmdfStation;
+
+//...Source of station series that are read on first access. The stations
+//   attached to a loader only know their length until their series is
+//   requested. Loaded series are held by the station, and once more than
+//   capacity() stations are resident the least recently used one is
+//   released again. A loader's file stays open for the lifetime of the
+//   loader, which lasts as long as any of its stations. Stations sharing a
+//   loader are expected to be used from one thread at a time.
+class HmdfStationLoader {
+ public:
+  explicit HmdfStationLoader(size_t capacity = 32);
+  virtual ~HmdfStationLoader();
+
+  size_t capacity() const;
+  void setCapacity(size_t capacity);
+
+  size_t resident() const;
+
+ protected:
+  //...Fills length dates and values for the station at index. The buffers
+  //   are sized by the caller. A non-zero return leaves the station as
+  //   null values.
+  virtual int readStation(size_t index, size_t length, qint64 *date,
+                          double *data) = 0;
+
+ private:
+  friend class HmdfStation;
+
+  void load(const HmdfStation *station);
+  void touch(const HmdfStation *station);
+  void release(const HmdfStation *station);
+  void evict(size_t keep);
+
+  size_t m_capacity;
+  quint64 m_clock;
+  QVector<const HmdfStation *> m_resident;
+};
+
+#endif  // HMDFSTATIONLOADER_H
@@ -18,7 +18,7 @@
 #
 #-----------------------------------------------------------------------#
 
-QT       += network positioning
+QT       += network positioning concurrent
 
 TARGET = metocean
 TEMPLATE = lib
@@ -43,17 +43,23 @@ INCLUDEPATH += $$PWD/../../thirdparty/boost_1_67_0
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += hmdfasciiparser.cpp  \
+           chunkdownloader.cpp \
            crmsdata.cpp \
            hmdf.cpp  \
+           hmdfarena.cpp  \
            hmdfstation.cpp  \
+           hmdfstationloader.cpp  \
            netcdftimeseries.cpp  \
            noaacoops.cpp  \
            stringutil.cpp  \
+           timeaxis.cpp  \
            timezone.cpp  \
            timezonestruct.cpp  \
            waterdata.cpp \
            station.cpp \ 
            usgswaterdata.cpp \
+           waterdatabatch.cpp \
+           waterdatacache.cpp \
            xtidedata.cpp \
            tideprediction.cpp \
            ndbcdata.cpp \
@@ -64,19 +70,25 @@ SOURCES += hmdfasciiparser.cpp  \
            hwmdata.cpp
 
 HEADERS += hmdfasciiparser.h  \
+           chunkdownloader.h \
            crmsdata.h \
            datum.h \
            hmdf.h  \
+           hmdfarena.h  \
            hmdfstation.h  \
+           hmdfstationloader.h  \
            netcdftimeseries.h  \
            noaacoops.h  \
            stringutil.h  \
+           timeaxis.h  \
            timezone.h  \
            timezonestruct.h  \
            tzdata.h  \
            waterdata.h \
            station.h \ 
            usgswaterdata.h \
+           waterdatabatch.h \
+           waterdatacache.h \
            xtidedata.h \
            tideprediction.h \
            ndbcdata.h \
@@ -73,15 +73,9 @@ QMap<QString, QString> NdbcData::buildDataNameMap() {
 
 int NdbcData::retrieveData(Hmdf *data, Datum::VDatum datum) {
   Q_UNUSED(datum)
-  int yearStart = startDate().date().year();
-  int yearEnd = endDate().date().year();
-
   QVector<QStringList> ndbcResponse;
 
-  for (int i = yearStart; i <= yearEnd; i++) {
-    QUrl url = QUrl("https://www.ndbc.noaa.gov/view_text_file.php?filename=" +
-                    this->station().id() + "h" + QString::number(i) +
-                    ".txt.gz&dir=data/historical/stdmet/");
+  for (auto &url : this->requestUrls()) {
     this->download(url, ndbcResponse);
   }
 
@@ -90,6 +84,41 @@ int NdbcData::retrieveData(Hmdf *data, Datum::VDatum datum) {
   return this->formatNdbcResponse(ndbcResponse, data);
 }
 
+QString NdbcData::cacheKey(Datum::VDatum datum) const {
+  Q_UNUSED(datum)
+  return "ndbc|" + this->station().id() + "|stdmet";
+}
+
+QVector<QUrl> NdbcData::requestUrls() {
+  int yearStart = startDate().date().year();
+  int yearEnd = endDate().date().year();
+
+  QVector<QUrl> urls;
+  for (int i = yearStart; i <= yearEnd; i++) {
+    urls.push_back(
+        QUrl("https://www.ndbc.noaa.gov/view_text_file.php?filename=" +
+             this->station().id() + "h" + QString::number(i) +
+             ".txt.gz&dir=data/historical/stdmet/"));
+  }
+  return urls;
+}
+
+int NdbcData::processResponses(const QVector<QByteArray> &responses,
+                               Hmdf *data) {
+  QVector<QStringList> ndbcResponse;
+  for (auto &r : responses) {
+    QStringList d = QString(r).split("\n");
+    if (d.length() > 4) ndbcResponse.push_back(d);
+  }
+
+  if (ndbcResponse.length() == 0) {
+    this->setErrorString("No valid station data found.");
+    return 1;
+  }
+
+  return this->formatNdbcResponse(ndbcResponse, data);
+}
+
 int NdbcData::download(QUrl url, QVector<QStringList> &dldata) {
   // Send the request
   QNetworkAccessManager *manager = new QNetworkAccessManager(this);
@@ -33,8 +33,13 @@ class NdbcData : public WaterData {
   static QStringList dataNames();
   static QMap<QString,QString> dataMap();
 
+  QVector<QUrl> requestUrls() override;
+  int processResponses(const QVector<QByteArray> &responses,
+                       Hmdf *data) override;
+
  private:
   int retrieveData(Hmdf *data, Datum::VDatum datum = Datum::VDatum::NullDatum);
+  QString cacheKey(Datum::VDatum datum) const override;
   static QMap<QString,QString> buildDataNameMap();
   int download(QUrl url, QVector<QStringList> &dldata);
   int readNdbcResponse(QNetworkReply *reply, QVector<QStringList> &data);
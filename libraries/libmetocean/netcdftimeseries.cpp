@@ -19,6 +19,9 @@
 //-----------------------------------------------------------------------*/
 #include "netcdftimeseries.h"
 #include "netcdf.h"
+#include "timeaxis.h"
+#include <cstring>
+#include <vector>
 
 #define NCCHECK(ierr)     \
   if (ierr != NC_NOERR) { \
@@ -26,6 +29,14 @@
     return ierr;          \
   }
 
+//...Used by the readers that are handed an open file and leave closing it
+//   to the caller
+#define NCRETURN(call)                        \
+  {                                           \
+    int status = call;                        \
+    if (status != NC_NOERR) return status;    \
+  }
+
 NetcdfTimeseries::NetcdfTimeseries(QObject *parent) : QObject(parent) {
   this->m_filename = QString();
   this->m_epsg = 4326;
@@ -33,6 +44,8 @@ NetcdfTimeseries::NetcdfTimeseries(QObject *parent) : QObject(parent) {
   this->m_verticalDatum = "unknown";
   this->m_horizontalProjection = "WGS84";
   this->m_numStations = 0;
+  this->m_lazy = false;
+  this->m_raggedArray = false;
 }
 
 QString NetcdfTimeseries::filename() const { return this->m_filename; }
@@ -45,19 +58,19 @@ int NetcdfTimeseries::epsg() const { return this->m_epsg; }
 
 void NetcdfTimeseries::setEpsg(int epsg) { this->m_epsg = epsg; }
 
+bool NetcdfTimeseries::lazy() const { return this->m_lazy; }
+
+void NetcdfTimeseries::setLazy(bool lazy) { this->m_lazy = lazy; }
+
 int NetcdfTimeseries::read() {
   if (this->m_filename == QString()) return 1;
 
-  QDateTime refTime;
-  refTime.setTimeSpec(Qt::UTC);
-  QString station_dim_string, station_time_var_string, station_data_var_string,
-      stationNameString;
-  size_t stationNameLength, length;
+  QString stationNameString;
+  size_t stationNameLength;
   int ierr, ncid;
-  int dimid_nstations, dimidStationLength, dimid_stationNameLen;
-  int varid_time, varid_data, varid_xcoor, varid_ycoor, varid_stationName;
+  int dimid_nstations, dimid_stationNameLen;
+  int varid_xcoor, varid_ycoor, varid_stationName;
   int epsg;
-  char timeChar[80];
 
   NCCHECK(nc_open(this->m_filename.toStdString().c_str(), NC_NOWRITE, &ncid));
   NCCHECK(nc_inq_dimid(ncid, "numStations", &dimid_nstations));
@@ -113,67 +126,209 @@ int NetcdfTimeseries::read() {
   this->m_time.resize(this->m_numStations);
   this->m_data.resize(this->m_numStations);
 
+  //...Files written before the format revision was recorded are read as
+  //   the first revision
+  QString format = formatStationVariables();
+  size_t formatLength;
+  if (nc_inq_attlen(ncid, NC_GLOBAL, "fileformat", &formatLength) ==
+      NC_NOERR) {
+    QByteArray formatText(static_cast<int>(formatLength), '\0');
+    NCCHECK(nc_get_att_text(ncid, NC_GLOBAL, "fileformat", formatText.data()));
+    format = QString(formatText).trimmed();
+  }
+
+  this->m_raggedArray = format == formatRaggedArray();
+  if (this->m_raggedArray) {
+    ierr = this->readRaggedArray(ncid);
+  } else {
+    ierr = this->readStationVariables(ncid);
+  }
+  if (ierr != NC_NOERR) {
+    nc_close(ncid);
+    return ierr;
+  }
+
+  NCCHECK(nc_close(ncid));
+
+  return 0;
+}
+
+//...Reference date of a time variable in milliseconds since the epoch
+static int readReferenceDate(int ncid, int varid, qint64 &refMSecs) {
+  char timeChar[80];
+  memset(timeChar, '\0', 80);
+  NCRETURN(nc_get_att_text(ncid, varid, "referenceDate", timeChar));
+  refMSecs = TimeAxis::referenceMSecs(QString(timeChar));
+  return NC_NOERR;
+}
+
+//...Reads station index from a file with one variable pair per station
+static int readStationVariable(int ncid, size_t index, size_t length,
+                               qint64 *time, double *data) {
+  QString station_time_var_string, station_data_var_string;
+  int varid_time, varid_data;
+
+  int station = static_cast<int>(index) + 1;
+  station_time_var_string.sprintf("time_station_%4.4d", station);
+  station_data_var_string.sprintf("data_station_%4.4d", station);
+
+  NCRETURN(nc_inq_varid(ncid, station_time_var_string.toStdString().c_str(),
+                        &varid_time));
+  NCRETURN(nc_inq_varid(ncid, station_data_var_string.toStdString().c_str(),
+                        &varid_data));
+
+  qint64 refMSecs;
+  NCRETURN(readReferenceDate(ncid, varid_time, refMSecs));
+
+  if (length == 0) return NC_NOERR;
+
+  //...Seconds are read straight into the output and converted in place
+  NCRETURN(nc_get_var_double(ncid, varid_data, data));
+  NCRETURN(nc_get_var_longlong(ncid, varid_time, time));
+  TimeAxis::toMSecsSinceEpoch(refMSecs, 1000, time, length, time);
+
+  return NC_NOERR;
+}
+
+//...Reads length observations starting at offset from the ragged array
+static int readRaggedStation(int ncid, size_t offset, size_t length,
+                             qint64 *time, double *data) {
+  int varid_time, varid_data;
+
+  NCRETURN(nc_inq_varid(ncid, "time", &varid_time));
+  NCRETURN(nc_inq_varid(ncid, "data", &varid_data));
+
+  qint64 refMSecs;
+  NCRETURN(readReferenceDate(ncid, varid_time, refMSecs));
+
+  if (length == 0) return NC_NOERR;
+
+  size_t start[1] = {offset};
+  size_t count[1] = {length};
+  NCRETURN(nc_get_vara_double(ncid, varid_data, start, count, data));
+  NCRETURN(nc_get_vara_longlong(ncid, varid_time, start, count, time));
+  TimeAxis::toMSecsSinceEpoch(refMSecs, 1000, time, length, time);
+
+  return NC_NOERR;
+}
+
+namespace {
+//...Reads stations on demand for the lazy mode
+class NetcdfTimeseriesLoader : public HmdfStationLoader {
+ public:
+  NetcdfTimeseriesLoader(const QString &filename, bool raggedArray,
+                         const QVector<size_t> &offset)
+      : m_filename(filename),
+        m_raggedArray(raggedArray),
+        m_offset(offset),
+        m_ncid(-1) {}
+
+  ~NetcdfTimeseriesLoader() override {
+    if (this->m_ncid >= 0) nc_close(this->m_ncid);
+  }
+
+ protected:
+  int readStation(size_t index, size_t length, qint64 *date,
+                  double *data) override {
+    if (this->m_ncid < 0) {
+      int ncid;
+      NCRETURN(nc_open(this->m_filename.toStdString().c_str(), NC_NOWRITE,
+                       &ncid));
+      this->m_ncid = ncid;
+    }
+    if (this->m_raggedArray)
+      return readRaggedStation(this->m_ncid, this->m_offset[index], length,
+                               date, data);
+    return readStationVariable(this->m_ncid, index, length, date, data);
+  }
+
+ private:
+  QString m_filename;
+  bool m_raggedArray;
+  QVector<size_t> m_offset;
+  int m_ncid;
+};
+}  // namespace
+
+int NetcdfTimeseries::readStationVariables(int ncid) {
+  QString station_dim_string, station_data_var_string;
+  size_t length;
+  int dimidStationLength, varid_data;
+
   for (size_t i = 0; i < this->m_numStations; i++) {
     station_dim_string.sprintf("stationLength_%4.4d", i + 1);
-    station_time_var_string.sprintf("time_station_%4.4d", i + 1);
     station_data_var_string.sprintf("data_station_%4.4d", i + 1);
 
-    NCCHECK(nc_inq_dimid(ncid, station_dim_string.toStdString().c_str(),
-                         &dimidStationLength));
+    NCRETURN(nc_inq_dimid(ncid, station_dim_string.toStdString().c_str(),
+                          &dimidStationLength));
 
-    NCCHECK(nc_inq_dimlen(ncid, dimidStationLength, &length));
+    NCRETURN(nc_inq_dimlen(ncid, dimidStationLength, &length));
     this->m_stationLength.push_back(length);
 
-    NCCHECK(nc_inq_varid(ncid, station_time_var_string.toStdString().c_str(),
-                         &varid_time));
-
-    NCCHECK(nc_inq_varid(ncid, station_data_var_string.toStdString().c_str(),
-                         &varid_data));
-
-    NCCHECK(nc_get_att_text(ncid, varid_time, "referenceDate", timeChar));
-    QString timeString = QString(timeChar).mid(0, 19);
-    refTime = QDateTime::fromString(timeString, "yyyy-MM-dd hh:mm:ss");
-    refTime.setTimeSpec(Qt::UTC);
+    NCRETURN(nc_inq_varid(ncid, station_data_var_string.toStdString().c_str(),
+                          &varid_data));
 
     double fillValue;
-    NCCHECK(nc_inq_var_fill(ncid, varid_data, NULL, &fillValue));
+    NCRETURN(nc_inq_var_fill(ncid, varid_data, NULL, &fillValue));
     if (fillValue == NC_FILL_DOUBLE) fillValue = -99999.0;
     this->m_fillValue.push_back(fillValue);
 
-    qint64 *timeData = new qint64[length];
-    double *varData = new double[length];
-
-    ierr = nc_get_var_double(ncid, varid_data, varData);
-    if (ierr != NC_NOERR) {
-      delete[] timeData;
-      delete[] varData;
-      nc_close(ncid);
-      return ierr;
-    }
-
-    ierr = nc_get_var_longlong(ncid, varid_time, timeData);
-    if (ierr != NC_NOERR) {
-      delete[] timeData;
-      delete[] varData;
-      nc_close(ncid);
-      return ierr;
-    }
+    if (this->m_lazy) continue;
 
     this->m_data[i].resize(length);
     this->m_time[i].resize(length);
+    NCRETURN(readStationVariable(ncid, i, length, this->m_time[i].data(),
+                                 this->m_data[i].data()));
+  }
 
-    for (size_t j = 0; j < length; j++) {
-      this->m_data[i][j] = varData[j];
-      this->m_time[i][j] = refTime.addSecs(timeData[j]).toMSecsSinceEpoch();
-    }
+  return NC_NOERR;
+}
+
+int NetcdfTimeseries::readRaggedArray(int ncid) {
+  int dimid_obs, varid_rowsize, varid_data;
+  size_t nobs;
+
+  NCRETURN(nc_inq_dimid(ncid, "numObservations", &dimid_obs));
+  NCRETURN(nc_inq_dimlen(ncid, dimid_obs, &nobs));
+  NCRETURN(nc_inq_varid(ncid, "rowSize", &varid_rowsize));
+  NCRETURN(nc_inq_varid(ncid, "data", &varid_data));
 
-    delete[] timeData;
-    delete[] varData;
+  double fillValue;
+  NCRETURN(nc_inq_var_fill(ncid, varid_data, NULL, &fillValue));
+  if (fillValue == NC_FILL_DOUBLE) fillValue = -99999.0;
+
+  std::vector<long long> rowSize(this->m_numStations);
+  if (this->m_numStations > 0) {
+    NCRETURN(nc_get_var_longlong(ncid, varid_rowsize, rowSize.data()));
   }
 
-  NCCHECK(nc_close(ncid));
+  size_t offset = 0;
+  for (size_t i = 0; i < this->m_numStations; i++) {
+    size_t length = static_cast<size_t>(rowSize[i]);
+    if (offset + length > nobs) return NC_EINVALCOORDS;
+    this->m_stationOffset.push_back(offset);
+    this->m_stationLength.push_back(length);
+    this->m_fillValue.push_back(fillValue);
+    offset += length;
+  }
 
-  return 0;
+  if (this->m_lazy) return NC_NOERR;
+
+  //...Every observation is read in one call and split into stations
+  //   afterwards
+  QVector<qint64> timeData(static_cast<int>(offset));
+  QVector<double> varData(static_cast<int>(offset));
+  NCRETURN(readRaggedStation(ncid, 0, offset, timeData.data(),
+                             varData.data()));
+
+  for (size_t i = 0; i < this->m_numStations; i++) {
+    int first = static_cast<int>(this->m_stationOffset[i]);
+    int length = static_cast<int>(this->m_stationLength[i]);
+    this->m_time[i] = timeData.mid(first, length);
+    this->m_data[i] = varData.mid(first, length);
+  }
+
+  return NC_NOERR;
 }
 
 int NetcdfTimeseries::toHmdf(Hmdf *hmdf) {
@@ -183,10 +338,20 @@ int NetcdfTimeseries::toHmdf(Hmdf *hmdf) {
   hmdf->setHeader3("none");
   hmdf->setSuccess(false);
 
+  QSharedPointer<HmdfStationLoader> loader;
+  if (this->m_lazy) {
+    loader.reset(new NetcdfTimeseriesLoader(
+        this->m_filename, this->m_raggedArray, this->m_stationOffset));
+  }
+
   for (size_t i = 0; i < this->m_numStations; i++) {
     HmdfStation *station = new HmdfStation(hmdf);
-    station->setDate(this->m_time[i]);
-    station->setData(this->m_data[i]);
+    if (this->m_lazy) {
+      station->setLoader(loader, i, this->m_stationLength[i]);
+    } else {
+      station->setDate(this->m_time[i]);
+      station->setData(this->m_data[i]);
+    }
     station->setLatitude(this->m_ycoor[i]);
     station->setLongitude(this->m_xcoor[i]);
     station->setName(this->m_stationName[i]);
@@ -201,6 +366,10 @@ int NetcdfTimeseries::toHmdf(Hmdf *hmdf) {
   return 0;
 }
 
+QString NetcdfTimeseries::formatStationVariables() { return "20180123"; }
+
+QString NetcdfTimeseries::formatRaggedArray() { return "20261018"; }
+
 int NetcdfTimeseries::getEpsg(QString file) {
   int ncid, varid_xcoor, epsg;
   NCCHECK(nc_open(file.toStdString().c_str(), NC_NOWRITE, &ncid));
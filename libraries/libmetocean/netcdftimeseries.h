@@ -41,20 +41,38 @@ class NetcdfTimeseries : public QObject {
   int epsg() const;
   void setEpsg(int epsg);
 
+  //...In lazy mode read() only reads the station locations, names and
+  //   lengths. Each series is read from the file when first accessed.
+  bool lazy() const;
+  void setLazy(bool lazy);
+
   static int getEpsg(QString file);
 
+  //...Values of the fileformat attribute. The first revision stores one
+  //   dimension and two variables per station. The second stores every
+  //   station in one contiguous ragged array following the CF discrete
+  //   sampling geometry conventions.
+  static QString formatStationVariables();
+  static QString formatRaggedArray();
+
 private:
+  int readStationVariables(int ncid);
+  int readRaggedArray(int ncid);
+
   QString m_filename;
   QString m_units;
   QString m_verticalDatum;
   QString m_horizontalProjection;
   int m_epsg;
   size_t m_numStations;
+  bool m_lazy;
+  bool m_raggedArray;
 
   QVector<double> m_fillValue;
   QVector<double> m_xcoor;
   QVector<double> m_ycoor;
   QVector<size_t> m_stationLength;
+  QVector<size_t> m_stationOffset;
   QVector<QString> m_stationName;
   QVector<QVector<qint64> > m_time;
   QVector<QVector<double> > m_data;
@@ -33,6 +33,7 @@
 #include "boost/config/warning_disable.hpp"
 #include "boost/spirit/include/phoenix.hpp"
 #include "boost/spirit/include/qi.hpp"
+#include "chunkdownloader.h"
 
 NoaaCoOps::NoaaCoOps(const Station &station, const QDateTime startDate,
                      const QDateTime endDate, const QString &product,
@@ -43,24 +44,63 @@ NoaaCoOps::NoaaCoOps(const Station &station, const QDateTime startDate,
       m_units(units),
       m_datum(datum),
       m_useVdatum(useVdatum),
-      m_useJson(true) {
+      m_useJson(true),
+      m_serverUrl(
+          QStringLiteral("http://tidesandcurrents.noaa.gov/api/datagetter")),
+      m_maxConcurrentRequests(4) {
   this->parseProduct();
 }
 
+int NoaaCoOps::maxConcurrentRequests() const {
+  return this->m_maxConcurrentRequests;
+}
+
+void NoaaCoOps::setMaxConcurrentRequests(int maxConcurrentRequests) {
+  this->m_maxConcurrentRequests = maxConcurrentRequests;
+}
+
+QString NoaaCoOps::serverUrl() const { return this->m_serverUrl; }
+
+void NoaaCoOps::setServerUrl(const QString &serverUrl) {
+  this->m_serverUrl = serverUrl;
+}
+
 int NoaaCoOps::parseProduct() {
   this->m_productParsed = this->m_product.split(":");
   return 0;
 }
 
 int NoaaCoOps::retrieveData(Hmdf *data, Datum::VDatum datum) {
+  Q_UNUSED(datum)
+  QVector<QUrl> urls = this->requestUrls();
+  QVector<QByteArray> responses;
+  int ierr = this->downloadDataFromNoaaServer(urls, responses);
+  if (ierr != 0) return ierr;
+  return this->processResponses(responses, data);
+}
+
+QString NoaaCoOps::cacheKey(Datum::VDatum datum) const {
+  Q_UNUSED(datum)
+  return "noaa|" + this->station().id() + "|" + this->m_product + "|" +
+         this->m_datum + "|" + this->m_units + "|" +
+         (this->m_useVdatum ? "vdatum" : "native");
+}
+
+QVector<QUrl> NoaaCoOps::requestUrls() {
   QVector<QDateTime> startDateList, endDateList;
-  std::vector<std::string> rawNoaaData;
+  QVector<QUrl> urls;
   int ierr = this->generateDateRanges(startDateList, endDateList);
-  if (ierr != 0) return ierr;
-  ierr =
-      this->downloadDataFromNoaaServer(startDateList, endDateList, rawNoaaData);
-  if (ierr != 0) return ierr;
-  ierr = this->formatNoaaResponse(rawNoaaData, data);
+  if (ierr != 0) return urls;
+  return this->buildRequestUrls(startDateList, endDateList);
+}
+
+int NoaaCoOps::processResponses(const QVector<QByteArray> &responses,
+                                Hmdf *data) {
+  std::vector<std::string> rawNoaaData;
+  rawNoaaData.reserve(responses.size());
+  for (auto &r : responses) rawNoaaData.push_back(r.toStdString());
+
+  int ierr = this->formatNoaaResponse(rawNoaaData, data);
   if (ierr != 0) return ierr;
   if (this->m_useVdatum) {
     Datum::VDatum d = Datum::datumID(this->m_datum);
@@ -95,10 +135,19 @@ int NoaaCoOps::generateDateRanges(QVector<QDateTime> &startDateList,
   return 0;
 }
 
-int NoaaCoOps::downloadDataFromNoaaServer(
-    QVector<QDateTime> startDateList, QVector<QDateTime> endDateList,
-    std::vector<std::string> &downloadedData) {
-  QNetworkAccessManager *manager = new QNetworkAccessManager(this);
+QVector<QUrl> NoaaCoOps::buildRequestUrls(
+    const QVector<QDateTime> &startDateList,
+    const QVector<QDateTime> &endDateList) {
+  //...Select parser type
+  QString format;
+  if (this->m_useJson) {
+    format = "json";
+  } else {
+    format = "csv";
+  }
+
+  QVector<QUrl> urls;
+  urls.reserve(startDateList.length());
 
   for (int i = 0; i < startDateList.length(); i++) {
     // Make the date string
@@ -107,18 +156,10 @@ int NoaaCoOps::downloadDataFromNoaaServer(
     QString endString =
         endDateList[i].toString(QStringLiteral("yyyyMMdd hh:mm"));
 
-    //...Select parser type
-    QString format;
-    if (this->m_useJson) {
-      format = "json";
-    } else {
-      format = "csv";
-    }
-
     // Build the URL to request data from the NOAA CO-OPS API
     QString requestURL =
-        QStringLiteral("http://tidesandcurrents.noaa.gov/api/datagetter?") +
-        QStringLiteral("product=") + this->m_productParsed[0] +
+        this->m_serverUrl + QStringLiteral("?product=") +
+        this->m_productParsed[0] +
         QStringLiteral("&application=metoceanviewer") +
         QStringLiteral("&begin_date=") + startString +
         QStringLiteral("&end_date=") + endString + QStringLiteral("&station=") +
@@ -134,48 +175,30 @@ int NoaaCoOps::downloadDataFromNoaaServer(
         requestURL = requestURL + QStringLiteral("&datum=") + this->m_datum;
       }
     }
-
-    // Send the request
-    QEventLoop loop;
-    QNetworkReply *reply = manager->get(QNetworkRequest(QUrl(requestURL)));
-    connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
-    connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), &loop,
-            SLOT(quit()));
-    loop.exec();
-
-    //...Check for a redirect from NOAA. This fixes bug #26
-    QVariant redirectionTargetURL =
-        reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-    if (!redirectionTargetURL.isNull()) {
-      QNetworkReply *reply2 =
-          manager->get(QNetworkRequest(redirectionTargetURL.toUrl()));
-      connect(reply2, SIGNAL(finished()), &loop, SLOT(quit()));
-      connect(reply2, SIGNAL(error(QNetworkReply::NetworkError)), &loop,
-              SLOT(quit()));
-      loop.exec();
-      reply->deleteLater();
-      this->readNoaaResponse(reply2, downloadedData);
-    } else
-      this->readNoaaResponse(reply, downloadedData);
+    urls.push_back(QUrl(requestURL));
   }
 
-  return 0;
+  return urls;
 }
 
-int NoaaCoOps::readNoaaResponse(QNetworkReply *reply,
-                                std::vector<std::string> &downloadedData) {
-  // Catch some errors during the download
-  if (reply->error() != 0) {
-    this->setErrorString(QStringLiteral("ERROR: ") + reply->errorString());
-    reply->deleteLater();
-    return 1;
-  }
+int NoaaCoOps::downloadDataFromNoaaServer(const QVector<QUrl> &urls,
+                                          QVector<QByteArray> &downloadedData) {
+  //...Keep several 30 day windows in flight at once. The responses come
+  //   back in request order so the formatting is unchanged.
+  ChunkDownloader downloader;
+  downloader.setMaxConcurrent(this->m_maxConcurrentRequests);
+  connect(&downloader, SIGNAL(progress(int, int)), this,
+          SIGNAL(progress(int, int)));
+
+  QVector<QByteArray> responses;
+  int nFailed = downloader.download(urls, responses);
 
-  // Store the data at the back of the vector
-  downloadedData.push_back(static_cast<std::string>(reply->readAll()));
+  for (int i = 0; i < responses.size(); ++i) {
+    if (downloader.succeeded(i)) downloadedData.push_back(responses[i]);
+  }
 
-  // Delete this response
-  reply->deleteLater();
+  if (nFailed > 0) this->setErrorString(downloader.errorString());
+  if (nFailed == urls.size() && !urls.isEmpty()) return 1;
 
   return 0;
 }
@@ -32,20 +32,30 @@ class NoaaCoOps : public WaterData {
             const QString &product, const QString &datum, const bool useVdatum,const QString &units,
             QObject *parent = nullptr);
 
+  int maxConcurrentRequests() const;
+  void setMaxConcurrentRequests(int maxConcurrentRequests);
+
+  QString serverUrl() const;
+  void setServerUrl(const QString &serverUrl);
+
+  QVector<QUrl> requestUrls() override;
+  int processResponses(const QVector<QByteArray> &responses,
+                       Hmdf *data) override;
+
  private:
   int retrieveData(Hmdf *data, Datum::VDatum datum = Datum::VDatum::NullDatum);
+  QString cacheKey(Datum::VDatum datum) const override;
 
   int parseProduct();
 
   int generateDateRanges(QVector<QDateTime> &startDateList,
                          QVector<QDateTime> &endDateList);
 
-  int downloadDataFromNoaaServer(QVector<QDateTime> startDateList,
-                                 QVector<QDateTime> endDateList,
-                                 std::vector<std::string> &downloadedData);
+  QVector<QUrl> buildRequestUrls(const QVector<QDateTime> &startDateList,
+                                 const QVector<QDateTime> &endDateList);
 
-  int readNoaaResponse(QNetworkReply *reply,
-                       std::vector<std::string> &retrieveData);
+  int downloadDataFromNoaaServer(const QVector<QUrl> &urls,
+                                 QVector<QByteArray> &downloadedData);
 
   int formatNoaaResponse(std::vector<std::string> &downloadedData,
                          Hmdf *outputData);
@@ -59,6 +69,8 @@ class NoaaCoOps : public WaterData {
   QStringList m_productParsed;
   QString m_datum;
   QString m_units;
+  QString m_serverUrl;
+  int m_maxConcurrentRequests;
   bool m_useJson, m_useVdatum;
 };
 
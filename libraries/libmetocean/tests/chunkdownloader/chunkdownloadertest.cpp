@@ -0,0 +1,250 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include <QCoreApplication>
+#include <QHash>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+#include <iostream>
+#include "chunkdownloader.h"
+
+//...Checks ChunkDownloader against a local stand-in server. The server
+//   answers by path:
+//     /data/<i>/<ms>    "chunk <i>" after a delay of ms milliseconds
+//     /flaky/<n>        503 for the first n requests, then "recovered"
+//     /redirect/<n>     302 to /redirect/<n-1>, and "redirected" at zero
+//     /loop             302 to itself
+//     /stall            headers and part of the body, then nothing
+//   It also records how many requests each Host header has open at once.
+
+struct StandInServer {
+  QTcpServer server;
+  QHash<QString, int> hits;
+  QHash<QString, int> inFlight;
+  QHash<QString, int> maxInFlight;
+
+  //...Any so that localhost reaches the server over IPv4 or IPv6
+  bool listen() {
+    if (!this->server.listen(QHostAddress::Any)) return false;
+    QObject::connect(&this->server, &QTcpServer::newConnection,
+                     [this]() { this->accept(); });
+    return true;
+  }
+
+  QUrl url(const QString &host, const QString &path) const {
+    return QUrl(QStringLiteral("http://%1:%2%3")
+                    .arg(host)
+                    .arg(this->server.serverPort())
+                    .arg(path));
+  }
+
+  void accept() {
+    while (this->server.hasPendingConnections()) {
+      QTcpSocket *socket = this->server.nextPendingConnection();
+      QObject::connect(socket, &QTcpSocket::disconnected, socket,
+                       &QTcpSocket::deleteLater);
+      QObject::connect(socket, &QTcpSocket::readyRead,
+                       [this, socket]() { this->read(socket); });
+    }
+  }
+
+  void read(QTcpSocket *socket) {
+    QByteArray request = socket->property("request").toByteArray();
+    request += socket->readAll();
+    socket->setProperty("request", request);
+    if (!request.contains("\r\n\r\n") || socket->property("seen").toBool())
+      return;
+    socket->setProperty("seen", true);
+
+    QList<QByteArray> lines = request.split('\n');
+    QString path = QString::fromLatin1(lines.value(0).split(' ').value(1));
+    QString host;
+    for (auto &l : lines) {
+      if (l.toLower().startsWith("host:"))
+        host = QString::fromLatin1(l.mid(5).trimmed()).section(':', 0, 0);
+    }
+
+    this->hits[path]++;
+    this->inFlight[host]++;
+    this->maxInFlight[host] =
+        std::max(this->maxInFlight[host], this->inFlight[host]);
+
+    QStringList parts = path.split('/', QString::SkipEmptyParts);
+    QString kind = parts.value(0);
+
+    if (kind == "data") {
+      QByteArray body = "chunk " + parts.value(1).toLatin1();
+      QTimer::singleShot(parts.value(2).toInt(), socket,
+                         [this, socket, host, body]() {
+                           this->respond(socket, host, "200 OK", body);
+                         });
+    } else if (kind == "flaky") {
+      if (this->hits[path] <= parts.value(1).toInt())
+        this->respond(socket, host, "503 Service Unavailable", QByteArray());
+      else
+        this->respond(socket, host, "200 OK", "recovered");
+    } else if (kind == "redirect") {
+      int n = parts.value(1).toInt();
+      if (n == 0)
+        this->respond(socket, host, "200 OK", "redirected");
+      else
+        this->respond(socket, host, "302 Found", QByteArray(),
+                      "/redirect/" + QByteArray::number(n - 1));
+    } else if (kind == "loop") {
+      this->respond(socket, host, "302 Found", QByteArray(), "/loop");
+    } else if (kind == "stall") {
+      socket->write(
+          "HTTP/1.1 200 OK\r\nContent-Length: 1000\r\n"
+          "Connection: close\r\n\r\npartial");
+      QObject::connect(socket, &QTcpSocket::disconnected,
+                       [this, host]() { this->inFlight[host]--; });
+    } else {
+      this->respond(socket, host, "404 Not Found", QByteArray());
+    }
+  }
+
+  void respond(QTcpSocket *socket, const QString &host, const char *status,
+               const QByteArray &body,
+               const QByteArray &location = QByteArray()) {
+    QByteArray r = QByteArray("HTTP/1.1 ") + status + "\r\n";
+    if (!location.isEmpty()) r += "Location: " + location + "\r\n";
+    r += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    r += "Connection: close\r\n\r\n" + body;
+    socket->write(r);
+    socket->disconnectFromHost();
+    this->inFlight[host]--;
+  }
+};
+
+static bool check(bool condition, const char *what) {
+  if (!condition) std::cerr << "FAILED: " << what << std::endl;
+  return condition;
+}
+
+//...Later requests answer first, but results stay in request order
+static bool testOrdering(StandInServer &s) {
+  QVector<QUrl> urls;
+  for (int i = 0; i < 8; ++i)
+    urls.push_back(s.url("127.0.0.1", QStringLiteral("/data/%1/%2")
+                                          .arg(i)
+                                          .arg((8 - i) * 25)));
+  ChunkDownloader d;
+  d.setMaxConcurrent(8);
+  QVector<QByteArray> results;
+  bool pass = check(d.download(urls, results) == 0, "ordering: failures");
+  for (int i = 0; i < 8; ++i)
+    pass = check(results.value(i) == "chunk " + QByteArray::number(i),
+                 "ordering: result order") &&
+           pass;
+  return pass;
+}
+
+//...Two names for the same server count as two hosts
+static bool testPerHostLimit(StandInServer &s) {
+  s.maxInFlight.clear();
+  QVector<QUrl> urls;
+  for (int i = 0; i < 12; ++i) {
+    QString host = i % 2 == 0 ? "127.0.0.1" : "localhost";
+    urls.push_back(s.url(host, QStringLiteral("/data/%1/50").arg(i)));
+  }
+  ChunkDownloader d;
+  d.setMaxConcurrent(8);
+  d.setMaxConcurrentPerHost(2);
+  QVector<QByteArray> results;
+  bool pass = check(d.download(urls, results) == 0, "per host: failures");
+  pass = check(s.maxInFlight.value("127.0.0.1") == 2 &&
+                   s.maxInFlight.value("localhost") == 2,
+               "per host: at most two requests open per host") &&
+         pass;
+  return pass;
+}
+
+static bool testRetries(StandInServer &s) {
+  ChunkDownloader d;
+  d.setMaxRetries(3);
+  d.setRetryDelay(10);
+  QVector<QByteArray> results;
+  bool pass =
+      check(d.download({s.url("127.0.0.1", "/flaky/2")}, results) == 0,
+            "retries: transient failures are retried");
+  pass = check(results.value(0) == "recovered", "retries: result") && pass;
+  pass = check(s.hits.value("/flaky/2") == 3, "retries: attempts") && pass;
+
+  pass = check(d.download({s.url("127.0.0.1", "/flaky/5")}, results) == 1,
+               "retries: gives up after maxRetries") &&
+         pass;
+  pass = check(s.hits.value("/flaky/5") == 4, "retries: attempts at limit") &&
+         pass;
+  return pass;
+}
+
+static bool testRedirects(StandInServer &s) {
+  ChunkDownloader d;
+  d.setMaxRedirects(5);
+  QVector<QByteArray> results;
+  bool pass =
+      check(d.download({s.url("127.0.0.1", "/redirect/3")}, results) == 0,
+            "redirects: followed");
+  pass = check(results.value(0) == "redirected", "redirects: result") && pass;
+
+  pass = check(d.download({s.url("127.0.0.1", "/loop")}, results) == 1,
+               "redirects: a cycle fails") &&
+         pass;
+  pass = check(d.errorString().contains("Too many redirects"),
+               "redirects: error string") &&
+         pass;
+  pass = check(s.hits.value("/loop") == 6, "redirects: limit") && pass;
+  return pass;
+}
+
+static bool testTransferTimeout(StandInServer &s) {
+  ChunkDownloader d;
+  d.setMaxRetries(1);
+  d.setRetryDelay(10);
+  d.setTransferTimeout(200);
+  QVector<QByteArray> results;
+  bool pass = check(d.download({s.url("127.0.0.1", "/stall")}, results) == 1,
+                    "timeout: a stalled transfer fails");
+  pass = check(d.errorString().contains("Timed out"),
+               "timeout: error string") &&
+         pass;
+  pass = check(s.hits.value("/stall") == 2, "timeout: retried once") && pass;
+  return pass;
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  StandInServer server;
+  if (!server.listen()) {
+    std::cerr << "Could not start the stand-in server" << std::endl;
+    return 1;
+  }
+
+  bool pass = testOrdering(server);
+  pass = testPerHostLimit(server) && pass;
+  pass = testRetries(server) && pass;
+  pass = testRedirects(server) && pass;
+  pass = testTransferTimeout(server) && pass;
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+#-------------------------------GPL-------------------------------------#
+#
+# MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+# Copyright (C) 2019  Zach Cobell
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-----------------------------------------------------------------------#
+
+#...Runs ChunkDownloader against a local stand-in HTTP server. Not part of
+#   the default build. Build with qmake after libmetocean has been built.
+
+include($$PWD/../../../../global.pri)
+
+QT += core network
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = chunkdownloadertest
+
+INCLUDEPATH += $$PWD/../..
+DEPENDPATH += $$PWD/../..
+
+SOURCES += chunkdownloadertest.cpp
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../release/ -lmetocean
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../debug/ -lmetocean
+else:unix: LIBS += -L$$OUT_PWD/../../ -lmetocean
@@ -0,0 +1,45 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "timeaxis.h"
+#include <QDateTime>
+
+qint64 TimeAxis::referenceMSecs(const QString &date) {
+  QDateTime d = QDateTime::fromString(date.mid(0, 19),
+                                      QStringLiteral("yyyy-MM-dd hh:mm:ss"));
+  d.setTimeSpec(Qt::UTC);
+  return d.toMSecsSinceEpoch();
+}
+
+void TimeAxis::toMSecsSinceEpoch(qint64 refMSecs, qint64 scale,
+                                 const qint64 *in, size_t n, qint64 *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = refMSecs + in[i] * scale;
+  }
+}
+
+void TimeAxis::toMSecsSinceEpoch(qint64 refMSecs, double scale,
+                                 const double *in, size_t n, qint64 *out) {
+  //...Rounds half away from zero like qRound64 but without a branch the
+  //   vectorizer cannot handle
+  for (size_t i = 0; i < n; ++i) {
+    const double ms = in[i] * scale;
+    out[i] = refMSecs + static_cast<qint64>(ms + (ms < 0.0 ? -0.5 : 0.5));
+  }
+}
@@ -0,0 +1,48 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef TIMEAXIS_H
+#define TIMEAXIS_H
+
+#include <QString>
+#include <QtGlobal>
+#include "metocean_global.h"
+
+//...Conversion of time axes stored as offsets from a reference date into
+//   milliseconds since the epoch. The reference date is parsed once and the
+//   buffer is converted as refMSecs + t * scale in a single arithmetic loop
+//   (vectorized where the target has 64-bit integer vector instructions)
+//   instead of building a QDateTime per value.
+class TimeAxis {
+ public:
+  //...Milliseconds since the epoch of a "yyyy-MM-dd hh:mm:ss" date in UTC.
+  //   Trailing text such as a time zone is ignored.
+  static qint64 referenceMSecs(const QString &date);
+
+  //...Integer offsets, e.g. scale = 1000 for seconds. in and out may be the
+  //   same buffer.
+  static void toMSecsSinceEpoch(qint64 refMSecs, qint64 scale,
+                                const qint64 *in, size_t n, qint64 *out);
+
+  //...Floating point offsets, rounded to the nearest millisecond
+  static void toMSecsSinceEpoch(qint64 refMSecs, double scale,
+                                const double *in, size_t n, qint64 *out);
+};
+
+#endif  // TIMEAXIS_H
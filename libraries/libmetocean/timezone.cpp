@@ -19,12 +19,354 @@
 //-----------------------------------------------------------------------*/
 #include "timezone.h"
 #include <QDateTime>
+#include <QHash>
+#include <QVector>
+
+namespace {
+
+//...Static description of a timezone. The table below is constant
+//   initialized, so no code runs to build it. Entries are ordered by
+//   (location, abbreviation) code. Regenerate with format_tzdata.sh.
+struct TimezoneRecord {
+  TZData::Location locationCode;
+  TZData::Abbreviation abbreviationCode;
+  const char *abbreviation;
+  const char *name;
+  const char *location;
+  int offsetSeconds;
+};
+
+using namespace TZData;
+const TimezoneRecord c_timezoneTable[] = {
+    {Africa, CAT, "CAT", "Central Africa Time", "Africa", 7200},
+    {Africa, CVT, "CVT", "Cape Verde Time", "Africa", -3600},
+    {Africa, EAT, "EAT", "Eastern Africa Time", "Africa", 10800},
+    {Africa, MUT, "MUT", "Mauritius Time", "Africa", 14400},
+    {Africa, RET, "RET", "Reunion Time", "Africa", 14400},
+    {Africa, SAST, "SAST", "South Africa Standard Time", "Africa", 7200},
+    {Africa, SCT, "SCT", "Seychelles Time", "Africa", 14400},
+    {Africa, WAST, "WAST", "West Africa Summer Time", "Africa", 7200},
+    {Africa, WAT, "WAT", "West Africa Time", "Africa", 3600},
+    {Africa, WST, "WST", "Western Sahara Summer Time", "Africa", 3600},
+    {Africa, WT, "WT", "Western Sahara Standard Time", "Africa", 0},
+    {Antarctica, ART, "ART", "Argentina Time", "Antarctica", -10800},
+    {Antarctica, CAST, "CAST", "Casey Time", "Antarctica", 28800},
+    {Antarctica, DAVT, "DAVT", "Davis Time", "Antarctica", 25200},
+    {Antarctica, DDUT, "DDUT", "", "Antarctica", 36000},
+    {Antarctica, MAWT, "MAWT", "Mawson Time", "Antarctica", 18000},
+    {Antarctica, ROTT, "ROTT", "Rothera Time", "Antarctica", -10800},
+    {Antarctica, SYOT, "SYOT", "Syowa Time", "Antarctica", 10800},
+    {Antarctica, VOST, "VOST", "Vostok Time", "Antarctica", 21600},
+    {Asia, ADT, "ADT", "Arabia Daylight Time", "Asia", 14400},
+    {Asia, AFT, "AFT", "Afghanistan Time", "Asia", 16200},
+    {Asia, ALMT, "ALMT", "Alma-Ata Time", "Asia", 21600},
+    {Asia, AMST, "AMST", "Armenia Summer Time", "Asia", 18000},
+    {Asia, AMT, "AMT", "Armenia Time", "Asia", 14400},
+    {Asia, ANAST, "ANAST", "Anadyr Summer Time", "Asia", 43200},
+    {Asia, ANAT, "ANAT", "Anadyr Time", "Asia", 43200},
+    {Asia, AQTT, "AQTT", "Aqtobe Time", "Asia", 18000},
+    {Asia, AST, "AST", "Arabia Standard Time", "Asia", 10800},
+    {Asia, AZST, "AZST", "Azerbaijan Summer Time", "Asia", 18000},
+    {Asia, AZT, "AZT", "Azerbaijan Time", "Asia", 14400},
+    {Asia, BNT, "BNT", "Brunei Darussalam Time", "Asia", 28800},
+    {Asia, BST, "BST", "Bangladesh Standard Time", "Asia", 21600},
+    {Asia, BTT, "BTT", "Bhutan Time", "Asia", 21600},
+    {Asia, CHOST, "CHOST", "Choibalsan Summer Time", "Asia", 32400},
+    {Asia, CHOT, "CHOT", "Choibalsan Time", "Asia", 28800},
+    {Asia, CST, "CST", "China Standard Time", "Asia", 28800},
+    {Asia, GET, "GET", "Georgia Standard Time", "Asia", 14400},
+    {Asia, GST, "GST", "Gulf Standard Time", "Asia", 14400},
+    {Asia, HKT, "HKT", "Hong Kong Time", "Asia", 28800},
+    {Asia, HOVST, "HOVST", "Hovd Summer Time", "Asia", 28800},
+    {Asia, HOVT, "HOVT", "Hovd Time", "Asia", 25200},
+    {Asia, ICT, "ICT", "Indochina Time", "Asia", 25200},
+    {Asia, IDT, "IDT", "Israel Daylight Time", "Asia", 10800},
+    {Asia, IRDT, "IRDT", "Iran Daylight Time", "Asia", 16200},
+    {Asia, IRKST, "IRKST", "Irkutsk Summer Time", "Asia", 32400},
+    {Asia, IRKT, "IRKT", "Irkutsk Time", "Asia", 28800},
+    {Asia, IRST, "IRST", "Iran Standard Time", "Asia", 12600},
+    {Asia, IST, "IST", "Israel Standard Time", "Asia", 7200},
+    {Asia, JST, "JST", "Japan Standard Time", "Asia", 32400},
+    {Asia, KGT, "KGT", "Kyrgyzstan Time", "Asia", 21600},
+    {Asia, KRAST, "KRAST", "Krasnoyarsk Summer Time", "Asia", 28800},
+    {Asia, KRAT, "KRAT", "Krasnoyarsk Time", "Asia", 25200},
+    {Asia, KST, "KST", "Korea Standard Time", "Asia", 32400},
+    {Asia, MAGST, "MAGST", "Magadan Summer Time", "Asia", 43200},
+    {Asia, MAGT, "MAGT", "Magadan Time", "Asia", 39600},
+    {Asia, MMT, "MMT", "Myanmar Time", "Asia", 23400},
+    {Asia, MVT, "MVT", "Maldives Time", "Asia", 18000},
+    {Asia, MYT, "MYT", "Malaysia Time", "Asia", 28800},
+    {Asia, NOVST, "NOVST", "Novosibirsk Summer Time", "Asia", 25200},
+    {Asia, NOVT, "NOVT", "Novosibirsk Time", "Asia", 21600},
+    {Asia, NPT, "NPT", "Nepal Time", "Asia", 20700},
+    {Asia, OMSST, "OMSST", "Omsk Summer Time", "Asia", 25200},
+    {Asia, OMST, "OMST", "Omsk Standard Time", "Asia", 21600},
+    {Asia, ORAT, "ORAT", "Oral Time", "Asia", 18000},
+    {Asia, PETST, "PETST", "Kamchatka Summer Time", "Asia", 43200},
+    {Asia, PETT, "PETT", "Kamchatka Time", "Asia", 43200},
+    {Asia, PHT, "PHT", "Philippine Time", "Asia", 28800},
+    {Asia, PKT, "PKT", "Pakistan Standard Time", "Asia", 18000},
+    {Asia, PYT, "PYT", "Pyongyang Time", "Asia", 30600},
+    {Asia, QYZT, "QYZT", "Qyzylorda Time", "Asia", 21600},
+    {Asia, SAKT, "SAKT", "Sakhalin Time", "Asia", 39600},
+    {Asia, SGT, "SGT", "Singapore Time", "Asia", 28800},
+    {Asia, SRET, "SRET", "Srednekolymsk Time", "Asia", 39600},
+    {Asia, TJT, "TJT", "Tajikistan Time", "Asia", 18000},
+    {Asia, TLT, "TLT", "East Timor Time", "Asia", 32400},
+    {Asia, TMT, "TMT", "Turkmenistan Time", "Asia", 18000},
+    {Asia, TRT, "TRT", "Turkey Time", "Asia", 10800},
+    {Asia, ULAST, "ULAST", "Ulaanbaatar Summer Time", "Asia", 32400},
+    {Asia, ULAT, "ULAT", "Ulaanbaatar Time", "Asia", 28800},
+    {Asia, UZT, "UZT", "Uzbekistan Time", "Asia", 18000},
+    {Asia, VLAST, "VLAST", "Vladivostok Summer Time", "Asia", 39600},
+    {Asia, VLAT, "VLAT", "Vladivostok Time", "Asia", 36000},
+    {Asia, WIB, "WIB", "Western Indonesian Time", "Asia", 25200},
+    {Asia, WIT, "WIT", "Eastern Indonesian Time", "Asia", 32400},
+    {Asia, WITA, "WITA", "Central Indonesian Time", "Asia", 28800},
+    {Asia, YAKST, "YAKST", "Yakutsk Summer Time", "Asia", 36000},
+    {Asia, YAKT, "YAKT", "Yakutsk Time", "Asia", 32400},
+    {Asia, YEKST, "YEKST", "Yekaterinburg Summer Time", "Asia", 21600},
+    {Asia, YEKT, "YEKT", "Yekaterinburg Time", "Asia", 18000},
+    {Atlantic, AZOST, "AZOST", "Azores Summer Time", "Atlantic", 0},
+    {Atlantic, AZOT, "AZOT", "Azores Time", "Atlantic", -3600},
+    {Australia, ACDT, "ACDT", "Australian Central Daylight Time", "Australia",
+     37800},
+    {Australia, ACST, "ACST", "Australian Central Standard Time", "Australia",
+     34200},
+    {Australia, ACT, "ACT", "Australian Central Time", "Australia", 34200},
+    {Australia, ACWST, "ACWST", "Australian Central Western Standard Time",
+     "Australia", 31500},
+    {Australia, AEDT, "AEDT", "Australian Eastern Daylight Time", "Australia",
+     39600},
+    {Australia, AEST, "AEST", "Australian Eastern Standard Time", "Australia",
+     36000},
+    {Australia, AET, "AET", "Australian Eastern Time", "Australia", 36000},
+    {Australia, AWDT, "AWDT", "Australian Western Daylight Time", "Australia",
+     32400},
+    {Australia, AWST, "AWST", "Australian Western Standard Time", "Australia",
+     28800},
+    {Australia, CXT, "CXT", "Christmas Island Time", "Australia", 25200},
+    {Australia, LHDT, "LHDT", "Lord Howe Daylight Time", "Australia", 39600},
+    {Australia, LHST, "LHST", "Lord Howe Standard Time", "Australia", 37800},
+    {Australia, NFT, "NFT", "Norfolk Time", "Australia", 39600},
+    {Caribbean, CDT, "CDT", "Cuba Daylight Time", "Caribbean", -14400},
+    {Caribbean, CIDST, "CIDST", "Cayman Islands Daylight Saving Time",
+     "Caribbean", -14400},
+    {Caribbean, CIST, "CIST", "Cayman Islands Standard Time", "Caribbean",
+     -18000},
+    {Caribbean, CST, "CST", "Cuba Standard Time", "Caribbean", -18000},
+    {Europe, BST, "BST", "British Summer Time", "Europe", 3600},
+    {Europe, CEST, "CEST", "Central European Summer Time", "Europe", 7200},
+    {Europe, CET, "CET", "Central European Time", "Europe", 3600},
+    {Europe, EEST, "EEST", "Eastern European Summer Time", "Europe", 10800},
+    {Europe, EET, "EET", "Eastern European Time", "Europe", 7200},
+    {Europe, FET, "FET", "Further-Eastern European Time", "Europe", 10800},
+    {Europe, GMT, "GMT", "Greenwich Mean Time", "Europe", 0},
+    {Europe, IST, "IST", "Irish Standard Time", "Europe", 3600},
+    {Europe, KUYT, "KUYT", "Kuybyshev Time", "Europe", 14400},
+    {Europe, MSD, "MSD", "Moscow Daylight Time", "Europe", 14400},
+    {Europe, MSK, "MSK", "Moscow Standard Time", "Europe", 10800},
+    {Europe, SAMT, "SAMT", "Samara Time", "Europe", 14400},
+    {Europe, WEST, "WEST", "Western European Summer Time", "Europe", 3600},
+    {Europe, WET, "WET", "Western European Time", "Europe", 0},
+    {IndianOcean, CCT, "CCT", "Cocos Islands Time", "Indian Ocean", 23400},
+    {IndianOcean, IOT, "IOT", "Indian Chagos Time", "Indian Ocean", 21600},
+    {IndianOcean, TFT, "TFT", "French Southern and Antarctic Time",
+     "Indian Ocean", 18000},
+    {Military, A, "A", "Alpha Time Zone", "Military", 3600},
+    {Military, B, "B", "Bravo Time Zone", "Military", 7200},
+    {Military, C, "C", "Charlie Time Zone", "Military", 10800},
+    {Military, D, "D", "Delta Time Zone", "Military", 14400},
+    {Military, E, "E", "Echo Time Zone", "Military", 18000},
+    {Military, F, "F", "Foxtrot Time Zone", "Military", 21600},
+    {Military, G, "G", "Golf Time Zone", "Military", 25200},
+    {Military, H, "H", "Hotel Time Zone", "Military", 28800},
+    {Military, I, "I", "India Time Zone", "Military", 32400},
+    {Military, K, "K", "Kilo Time Zone", "Military", 36000},
+    {Military, L, "L", "Lima Time Zone", "Military", 39600},
+    {Military, M, "M", "Mike Time Zone", "Military", 43200},
+    {Military, N, "N", "November Time Zone", "Military", -3600},
+    {Military, O, "O", "Oscar Time Zone", "Military", -7200},
+    {Military, P, "P", "Papa Time Zone", "Military", -10800},
+    {Military, Q, "Q", "Quebec Time Zone", "Military", -14400},
+    {Military, R, "R", "Romeo Time Zone", "Military", -18000},
+    {Military, S, "S", "Sierra Time Zone", "Military", -21600},
+    {Military, T, "T", "Tango Time Zone", "Military", -25200},
+    {Military, U, "U", "Uniform Time Zone", "Military", -28800},
+    {Military, V, "V", "Victor Time Zone", "Military", -32400},
+    {Military, W, "W", "Whiskey Time Zone", "Military", -36000},
+    {Military, X, "X", "X-ray Time Zone", "Military", -39600},
+    {Military, Y, "Y", "Yankee Time Zone", "Military", -43200},
+    {Military, Z, "Z", "Zulu Time Zone", "Military", 0},
+    {NorthAmerica, ADT, "ADT", "Atlantic Daylight Time", "North America",
+     -10800},
+    {NorthAmerica, AKDT, "AKDT", "Alaska Daylight Time", "North America",
+     -28800},
+    {NorthAmerica, AKST, "AKST", "Alaska Standard Time", "North America",
+     -32400},
+    {NorthAmerica, AST, "AST", "Atlantic Standard Time", "North America",
+     -14400},
+    {NorthAmerica, CDT, "CDT", "Central Daylight Time", "North America",
+     -18000},
+    {NorthAmerica, CST, "CST", "Central Standard Time", "North America",
+     -21600},
+    {NorthAmerica, EDT, "EDT", "Eastern Daylight Time", "North America",
+     -14400},
+    {NorthAmerica, EGST, "EGST", "Eastern Greenland Summer Time",
+     "North America", 0},
+    {NorthAmerica, EGT, "EGT", "East Greenland Time", "North America", -3600},
+    {NorthAmerica, EST, "EST", "Eastern Standard Time", "North America",
+     -18000},
+    {NorthAmerica, HADT, "HADT", "Hawaii-Aleutian Daylight Time",
+     "North America", -32400},
+    {NorthAmerica, HAST, "HAST", "Hawaii-Aleutian Standard Time",
+     "North America", -36000},
+    {NorthAmerica, MDT, "MDT", "Mountain Daylight Time", "North America",
+     -21600},
+    {NorthAmerica, MST, "MST", "Mountain Standard Time", "North America",
+     -25200},
+    {NorthAmerica, NDT, "NDT", "Newfoundland Daylight Time", "North America",
+     -9000},
+    {NorthAmerica, NST, "NST", "Newfoundland Standard Time", "North America",
+     -12600},
+    {NorthAmerica, PDT, "PDT", "Pacific Daylight Time", "North America",
+     -25200},
+    {NorthAmerica, PMDT, "PMDT", "Pierre & Miquelon Daylight Time",
+     "North America", -7200},
+    {NorthAmerica, PMST, "PMST", "Pierre & Miquelon Standard Time",
+     "North America", -10800},
+    {NorthAmerica, PST, "PST", "Pacific Standard Time", "North America",
+     -28800},
+    {NorthAmerica, WGST, "WGST", "Western Greenland Summer Time",
+     "North America", -7200},
+    {NorthAmerica, WGT, "WGT", "West Greenland Time", "North America", -10800},
+    {Pacific, AoE, "AoE", "Anywhere on Earth", "Pacific", -43200},
+    {Pacific, BST, "BST", "Bougainville Standard Time", "Pacific", 39600},
+    {Pacific, CHADT, "CHADT", "Chatham Island Daylight Time", "Pacific", 49500},
+    {Pacific, CHAST, "CHAST", "Chatham Island Standard Time", "Pacific", 45900},
+    {Pacific, CHUT, "CHUT", "Chuuk Time", "Pacific", 36000},
+    {Pacific, CKT, "CKT", "Cook Island Time", "Pacific", -36000},
+    {Pacific, ChST, "ChST", "Chamorro Standard Time", "Pacific", 36000},
+    {Pacific, EASST, "EASST", "Easter Island Summer Time", "Pacific", -18000},
+    {Pacific, EAST, "EAST", "Easter Island Standard Time", "Pacific", -21600},
+    {Pacific, FJST, "FJST", "Fiji Summer Time", "Pacific", 46800},
+    {Pacific, FJT, "FJT", "Fiji Time", "Pacific", 43200},
+    {Pacific, GALT, "GALT", "Galapagos Time", "Pacific", -21600},
+    {Pacific, GAMT, "GAMT", "Gambier Time", "Pacific", -32400},
+    {Pacific, GILT, "GILT", "Gilbert Island Time", "Pacific", 43200},
+    {Pacific, KOST, "KOST", "Kosrae Time", "Pacific", 39600},
+    {Pacific, LINT, "LINT", "Line Islands Time", "Pacific", 50400},
+    {Pacific, MART, "MART", "Marquesas Time", "Pacific", -34200},
+    {Pacific, MHT, "MHT", "Marshall Islands Time", "Pacific", 43200},
+    {Pacific, NCT, "NCT", "New Caledonia Time", "Pacific", 39600},
+    {Pacific, NRT, "NRT", "Nauru Time", "Pacific", 43200},
+    {Pacific, NUT, "NUT", "Niue Time", "Pacific", -39600},
+    {Pacific, NZDT, "NZDT", "New Zealand Daylight Time", "Pacific", 46800},
+    {Pacific, NZST, "NZST", "New Zealand Standard Time", "Pacific", 43200},
+    {Pacific, PGT, "PGT", "Papua New Guinea Time", "Pacific", 36000},
+    {Pacific, PHOT, "PHOT", "Phoenix Island Time", "Pacific", 46800},
+    {Pacific, PONT, "PONT", "Pohnpei Standard Time", "Pacific", 39600},
+    {Pacific, PST, "PST", "Pitcairn Standard Time", "Pacific", -28800},
+    {Pacific, PWT, "PWT", "Palau Time", "Pacific", 32400},
+    {Pacific, SBT, "SBT", "Solomon Islands Time", "Pacific", 39600},
+    {Pacific, SST, "SST", "Samoa Standard Time", "Pacific", -39600},
+    {Pacific, TAHT, "TAHT", "Tahiti Time", "Pacific", -36000},
+    {Pacific, TKT, "TKT", "Tokelau Time", "Pacific", 46800},
+    {Pacific, TOST, "TOST", "Tonga Summer Time", "Pacific", 50400},
+    {Pacific, TOT, "TOT", "Tonga Time", "Pacific", 46800},
+    {Pacific, TVT, "TVT", "Tuvalu Time", "Pacific", 43200},
+    {Pacific, VUT, "VUT", "Vanuatu Time", "Pacific", 39600},
+    {Pacific, WAKT, "WAKT", "Wake Time", "Pacific", 43200},
+    {Pacific, WFT, "WFT", "Wallis and Futuna Time", "Pacific", 43200},
+    {Pacific, WST, "WST", "West Samoa Time", "Pacific", 50400},
+    {Pacific, YAPT, "YAPT", "Yap Time", "Pacific", 36000},
+    {SouthAmerica, ACT, "ACT", "Acre Time", "South America", -18000},
+    {SouthAmerica, AMST, "AMST", "Amazon Summer Time", "South America", -10800},
+    {SouthAmerica, AMT, "AMT", "Amazon Time", "South America", -14400},
+    {SouthAmerica, BOT, "BOT", "Bolivia Time", "South America", -14400},
+    {SouthAmerica, BRST, "BRST", "Brasília Summer Time", "South America",
+     -7200},
+    {SouthAmerica, BRT, "BRT", "Brasília Time", "South America", -10800},
+    {SouthAmerica, CLST, "CLST", "Chile Summer Time", "South America", -10800},
+    {SouthAmerica, CLT, "CLT", "Chile Standard Time", "South America", -14400},
+    {SouthAmerica, COT, "COT", "Colombia Time", "South America", -18000},
+    {SouthAmerica, ECT, "ECT", "Ecuador Time", "South America", -18000},
+    {SouthAmerica, FKST, "FKST", "Falkland Islands Summer Time",
+     "South America", -10800},
+    {SouthAmerica, FKT, "FKT", "Falkland Island Time", "South America", -14400},
+    {SouthAmerica, FNT, "FNT", "Fernando de Noronha Time", "South America",
+     -7200},
+    {SouthAmerica, GFT, "GFT", "French Guiana Time", "South America", -10800},
+    {SouthAmerica, GST, "GST", "South Georgia Time", "South America", -7200},
+    {SouthAmerica, GYT, "GYT", "Guyana Time", "South America", -14400},
+    {SouthAmerica, PET, "PET", "Peru Time", "South America", -18000},
+    {SouthAmerica, PYST, "PYST", "Paraguay Summer Time", "South America",
+     -10800},
+    {SouthAmerica, PYT, "PYT", "Paraguay Time", "South America", -14400},
+    {SouthAmerica, SRT, "SRT", "Suriname Time", "South America", -10800},
+    {SouthAmerica, UYST, "UYST", "Uruguay Summer Time", "South America", -7200},
+    {SouthAmerica, UYT, "UYT", "Uruguay Time", "South America", -10800},
+    {SouthAmerica, VET, "VET", "Venezuelan Standard Time", "South America",
+     -14400},
+    {SouthAmerica, WARST, "WARST", "Western Argentine Summer Time",
+     "South America", -10800},
+    {Worldwide, UTC, "UTC", "Coordinated Universal Time", "Worldwide", 0},
+};
+
+//...Process-wide lookup structures built from the table on first use and
+//   never modified afterwards
+class TimezoneIndex {
+ public:
+  TimezoneIndex() {
+    const int n = sizeof(c_timezoneTable) / sizeof(c_timezoneTable[0]);
+    this->m_zones.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      const TimezoneRecord &r = c_timezoneTable[i];
+      this->m_zones.push_back(TimezoneStruct(
+          r.locationCode, r.abbreviationCode,
+          QString::fromUtf8(r.abbreviation), QString::fromUtf8(r.name),
+          QString::fromUtf8(r.location), r.offsetSeconds));
+      this->m_abbreviations[QString::fromUtf8(r.abbreviation).simplified()]
+          .push_back(i);
+      if (r.locationCode == TZData::Worldwide &&
+          r.abbreviationCode == TZData::UTC)
+        this->m_utc = i;
+    }
+  }
+
+  const QVector<TimezoneStruct> &zones() const { return this->m_zones; }
+
+  const TimezoneStruct &utc() const { return this->m_zones[this->m_utc]; }
+
+  //...Returns the first zone in table order with the given abbreviation,
+  //   preferring one in the given location. Returns nullptr if none match.
+  const TimezoneStruct *find(const QString &abbreviation,
+                             TZData::Location location) const {
+    auto it = this->m_abbreviations.constFind(abbreviation);
+    if (it == this->m_abbreviations.constEnd()) return nullptr;
+    for (auto i : it.value()) {
+      if (this->m_zones[i].getLocationCode() == location)
+        return &this->m_zones[i];
+    }
+    return &this->m_zones[it.value().first()];
+  }
+
+ private:
+  QVector<TimezoneStruct> m_zones;
+  QHash<QString, QVector<int>> m_abbreviations;
+  int m_utc = 0;
+};
+
+const TimezoneIndex &timezoneIndex() {
+  static const TimezoneIndex index;
+  return index;
+}
+
+}  // namespace
 
 Timezone::Timezone(QObject *parent) : QObject(parent) {
   this->m_initialized = false;
-  this->build();
-  this->m_zone =
-      this->m_timezones[std::make_pair(TZData::Worldwide, TZData::UTC)];
+  this->m_zone = timezoneIndex().utc();
 }
 
 int Timezone::localMachineOffsetFromUtc() {
@@ -33,30 +375,12 @@ int Timezone::localMachineOffsetFromUtc() {
 }
 
 bool Timezone::fromAbbreviation(QString value, TZData::Location location) {
-  //...First pass checks against the given location code
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    if (i.value().abbreviation().simplified() == value.simplified() &&
-        i.value().getLocationCode() == location) {
-      this->m_zone = this->m_timezones[i.key()];
-      this->m_initialized = true;
-      return true;
-    }
-  }
-
-  //...Second pass ignores location code
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    if (i.value().abbreviation().simplified() == value.simplified()) {
-      this->m_zone = this->m_timezones[i.key()];
-      this->m_initialized = true;
-      return true;
-    }
-  }
-
-  return false;
+  const TimezoneStruct *zone =
+      timezoneIndex().find(value.simplified(), location);
+  if (zone == nullptr) return false;
+  this->m_zone = *zone;
+  this->m_initialized = true;
+  return true;
 }
 
 bool Timezone::initialized() { return this->m_initialized; }
@@ -82,1140 +406,40 @@ QString Timezone::abbreviation() {
 
 QStringList Timezone::getAllTimezoneAbbreviations() {
   QStringList list;
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    list.append(i.value().abbreviation());
+  for (auto &z : timezoneIndex().zones()) {
+    list.append(z.abbreviation());
   }
   return list;
 }
 
 QStringList Timezone::getAllTimezoneNames() {
   QStringList list;
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    list.append(i.value().name());
+  for (auto &z : timezoneIndex().zones()) {
+    list.append(z.name());
   }
   return list;
 }
 
 QStringList Timezone::getTimezoneNames(TZData::Location location) {
   QStringList list;
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    if (i.value().getLocationCode() == location) list.append(i.value().name());
+  for (auto &z : timezoneIndex().zones()) {
+    if (z.getLocationCode() == location) list.append(z.name());
   }
   return list;
 }
 
 QStringList Timezone::getTimezoneAbbreviations(TZData::Location location) {
   QStringList list;
-  for (QMap<std::pair<TZData::Location, TZData::Abbreviation>,
-            TimezoneStruct>::iterator i = this->m_timezones.begin();
-       i != this->m_timezones.end(); ++i) {
-    if (i.value().getLocationCode() == location)
-      list.append(i.value().abbreviation());
+  for (auto &z : timezoneIndex().zones()) {
+    if (z.getLocationCode() == location) list.append(z.abbreviation());
   }
   return list;
 }
 
 int Timezone::offsetFromUtc(QString value, TZData::Location location) {
   if (value.isNull() || value.isEmpty()) return 0;
-  Timezone tempTZ;
-  tempTZ.fromAbbreviation(value, TZData::NorthAmerica);
-  return tempTZ.utcOffset();
-}
-
-void Timezone::build() {
-  using namespace TZData;
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, A),
-                           TimezoneStruct(Military, A, QStringLiteral("A"),
-                                          QStringLiteral("Alpha Time Zone"),
-                                          QStringLiteral("Military"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, ACDT),
-      TimezoneStruct(Australia, ACDT, QStringLiteral("ACDT"),
-                     QStringLiteral("Australian Central Daylight Time"),
-                     QStringLiteral("Australia"), 37800.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, ACST),
-      TimezoneStruct(Australia, ACST, QStringLiteral("ACST"),
-                     QStringLiteral("Australian Central Standard Time"),
-                     QStringLiteral("Australia"), 34200.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, ACT),
-      TimezoneStruct(SouthAmerica, ACT, QStringLiteral("ACT"),
-                     QStringLiteral("Acre Time"),
-                     QStringLiteral("South America"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, ACT),
-      TimezoneStruct(Australia, ACT, QStringLiteral("ACT"),
-                     QStringLiteral("Australian Central Time"),
-                     QStringLiteral("Australia"), 34200.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, ACWST),
-      TimezoneStruct(Australia, ACWST, QStringLiteral("ACWST"),
-                     QStringLiteral("Australian Central Western Standard Time"),
-                     QStringLiteral("Australia"), 31500.00));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, ADT),
-      TimezoneStruct(Asia, ADT, QStringLiteral("ADT"),
-                     QStringLiteral("Arabia Daylight Time"),
-                     QStringLiteral("Asia"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, ADT),
-      TimezoneStruct(NorthAmerica, ADT, QStringLiteral("ADT"),
-                     QStringLiteral("Atlantic Daylight Time"),
-                     QStringLiteral("North America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, AEDT),
-      TimezoneStruct(Australia, AEDT, QStringLiteral("AEDT"),
-                     QStringLiteral("Australian Eastern Daylight Time"),
-                     QStringLiteral("Australia"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, AEST),
-      TimezoneStruct(Australia, AEST, QStringLiteral("AEST"),
-                     QStringLiteral("Australian Eastern Standard Time"),
-                     QStringLiteral("Australia"), 36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, AET),
-      TimezoneStruct(Australia, AET, QStringLiteral("AET"),
-                     QStringLiteral("Australian Eastern Time"),
-                     QStringLiteral("Australia"), 36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, AFT),
-                           TimezoneStruct(Asia, AFT, QStringLiteral("AFT"),
-                                          QStringLiteral("Afghanistan Time"),
-                                          QStringLiteral("Asia"), 16200.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, AKDT),
-      TimezoneStruct(NorthAmerica, AKDT, QStringLiteral("AKDT"),
-                     QStringLiteral("Alaska Daylight Time"),
-                     QStringLiteral("North America"), -28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, AKST),
-      TimezoneStruct(NorthAmerica, AKST, QStringLiteral("AKST"),
-                     QStringLiteral("Alaska Standard Time"),
-                     QStringLiteral("North America"), -32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ALMT),
-                           TimezoneStruct(Asia, ALMT, QStringLiteral("ALMT"),
-                                          QStringLiteral("Alma-Ata Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, AMST),
-      TimezoneStruct(SouthAmerica, AMST, QStringLiteral("AMST"),
-                     QStringLiteral("Amazon Summer Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, AMST),
-                           TimezoneStruct(Asia, AMST, QStringLiteral("AMST"),
-                                          QStringLiteral("Armenia Summer Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, AMT),
-      TimezoneStruct(SouthAmerica, AMT, QStringLiteral("AMT"),
-                     QStringLiteral("Amazon Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, AMT),
-                           TimezoneStruct(Asia, AMT, QStringLiteral("AMT"),
-                                          QStringLiteral("Armenia Time"),
-                                          QStringLiteral("Asia"), 14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ANAST),
-                           TimezoneStruct(Asia, ANAST, QStringLiteral("ANAST"),
-                                          QStringLiteral("Anadyr Summer Time"),
-                                          QStringLiteral("Asia"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ANAT),
-                           TimezoneStruct(Asia, ANAT, QStringLiteral("ANAT"),
-                                          QStringLiteral("Anadyr Time"),
-                                          QStringLiteral("Asia"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, AQTT),
-                           TimezoneStruct(Asia, AQTT, QStringLiteral("AQTT"),
-                                          QStringLiteral("Aqtobe Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, ART),
-      TimezoneStruct(Antarctica, ART, QStringLiteral("ART"),
-                     QStringLiteral("Argentina Time"),
-                     QStringLiteral("Antarctica"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, AST),
-      TimezoneStruct(Asia, AST, QStringLiteral("AST"),
-                     QStringLiteral("Arabia Standard Time"),
-                     QStringLiteral("Asia"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, AST),
-      TimezoneStruct(NorthAmerica, AST, QStringLiteral("AST"),
-                     QStringLiteral("Atlantic Standard Time"),
-                     QStringLiteral("North America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, AWDT),
-      TimezoneStruct(Australia, AWDT, QStringLiteral("AWDT"),
-                     QStringLiteral("Australian Western Daylight Time"),
-                     QStringLiteral("Australia"), 32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, AWST),
-      TimezoneStruct(Australia, AWST, QStringLiteral("AWST"),
-                     QStringLiteral("Australian Western Standard Time"),
-                     QStringLiteral("Australia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Atlantic, AZOST),
-      TimezoneStruct(Atlantic, AZOST, QStringLiteral("AZOST"),
-                     QStringLiteral("Azores Summer Time"),
-                     QStringLiteral("Atlantic"), 0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Atlantic, AZOT),
-      TimezoneStruct(Atlantic, AZOT, QStringLiteral("AZOT"),
-                     QStringLiteral("Azores Time"), QStringLiteral("Atlantic"),
-                     -3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, AZST),
-      TimezoneStruct(Asia, AZST, QStringLiteral("AZST"),
-                     QStringLiteral("Azerbaijan Summer Time"),
-                     QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, AZT),
-                           TimezoneStruct(Asia, AZT, QStringLiteral("AZT"),
-                                          QStringLiteral("Azerbaijan Time"),
-                                          QStringLiteral("Asia"), 14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, AoE),
-                           TimezoneStruct(Pacific, AoE, QStringLiteral("AoE"),
-                                          QStringLiteral("Anywhere on Earth"),
-                                          QStringLiteral("Pacific"), -43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, B),
-                           TimezoneStruct(Military, B, QStringLiteral("B"),
-                                          QStringLiteral("Bravo Time Zone"),
-                                          QStringLiteral("Military"), 7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, BNT),
-      TimezoneStruct(Asia, BNT, QStringLiteral("BNT"),
-                     QStringLiteral("Brunei Darussalam Time"),
-                     QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, BOT),
-      TimezoneStruct(SouthAmerica, BOT, QStringLiteral("BOT"),
-                     QStringLiteral("Bolivia Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, BRST),
-      TimezoneStruct(SouthAmerica, BRST, QStringLiteral("BRST"),
-                     QStringLiteral("Brasília Summer Time"),
-                     QStringLiteral("South America"), -7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, BRT),
-      TimezoneStruct(SouthAmerica, BRT, QStringLiteral("BRT"),
-                     QStringLiteral("Brasília Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, BST),
-      TimezoneStruct(Asia, BST, QStringLiteral("BST"),
-                     QStringLiteral("Bangladesh Standard Time"),
-                     QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, BST),
-      TimezoneStruct(Pacific, BST, QStringLiteral("BST"),
-                     QStringLiteral("Bougainville Standard Time"),
-                     QStringLiteral("Pacific"), 39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Europe, BST),
-                           TimezoneStruct(Europe, BST, QStringLiteral("BST"),
-                                          QStringLiteral("British Summer Time"),
-                                          QStringLiteral("Europe"), 3600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, BTT),
-                           TimezoneStruct(Asia, BTT, QStringLiteral("BTT"),
-                                          QStringLiteral("Bhutan Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, C),
-                           TimezoneStruct(Military, C, QStringLiteral("C"),
-                                          QStringLiteral("Charlie Time Zone"),
-                                          QStringLiteral("Military"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, CAST),
-      TimezoneStruct(Antarctica, CAST, QStringLiteral("CAST"),
-                     QStringLiteral("Casey Time"), QStringLiteral("Antarctica"),
-                     28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, CAT),
-                           TimezoneStruct(Africa, CAT, QStringLiteral("CAT"),
-                                          QStringLiteral("Central Africa Time"),
-                                          QStringLiteral("Africa"), 7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(IndianOcean, CCT),
-      TimezoneStruct(IndianOcean, CCT, QStringLiteral("CCT"),
-                     QStringLiteral("Cocos Islands Time"),
-                     QStringLiteral("Indian Ocean"), 23400.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, CDT),
-      TimezoneStruct(NorthAmerica, CDT, QStringLiteral("CDT"),
-                     QStringLiteral("Central Daylight Time"),
-                     QStringLiteral("North America"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Caribbean, CDT),
-      TimezoneStruct(Caribbean, CDT, QStringLiteral("CDT"),
-                     QStringLiteral("Cuba Daylight Time"),
-                     QStringLiteral("Caribbean"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, CEST),
-      TimezoneStruct(Europe, CEST, QStringLiteral("CEST"),
-                     QStringLiteral("Central European Summer Time"),
-                     QStringLiteral("Europe"), 7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, CET),
-      TimezoneStruct(Europe, CET, QStringLiteral("CET"),
-                     QStringLiteral("Central European Time"),
-                     QStringLiteral("Europe"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, CHADT),
-      TimezoneStruct(Pacific, CHADT, QStringLiteral("CHADT"),
-                     QStringLiteral("Chatham Island Daylight Time"),
-                     QStringLiteral("Pacific"), 49500.00));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, CHAST),
-      TimezoneStruct(Pacific, CHAST, QStringLiteral("CHAST"),
-                     QStringLiteral("Chatham Island Standard Time"),
-                     QStringLiteral("Pacific"), 45900.00));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, CHOST),
-      TimezoneStruct(Asia, CHOST, QStringLiteral("CHOST"),
-                     QStringLiteral("Choibalsan Summer Time"),
-                     QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, CHOT),
-                           TimezoneStruct(Asia, CHOT, QStringLiteral("CHOT"),
-                                          QStringLiteral("Choibalsan Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, CHUT),
-      TimezoneStruct(Pacific, CHUT, QStringLiteral("CHUT"),
-                     QStringLiteral("Chuuk Time"), QStringLiteral("Pacific"),
-                     36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Caribbean, CIDST),
-      TimezoneStruct(Caribbean, CIDST, QStringLiteral("CIDST"),
-                     QStringLiteral("Cayman Islands Daylight Saving Time"),
-                     QStringLiteral("Caribbean"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Caribbean, CIST),
-      TimezoneStruct(Caribbean, CIST, QStringLiteral("CIST"),
-                     QStringLiteral("Cayman Islands Standard Time"),
-                     QStringLiteral("Caribbean"), -18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, CKT),
-                           TimezoneStruct(Pacific, CKT, QStringLiteral("CKT"),
-                                          QStringLiteral("Cook Island Time"),
-                                          QStringLiteral("Pacific"), -36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, CLST),
-      TimezoneStruct(SouthAmerica, CLST, QStringLiteral("CLST"),
-                     QStringLiteral("Chile Summer Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, CLT),
-      TimezoneStruct(SouthAmerica, CLT, QStringLiteral("CLT"),
-                     QStringLiteral("Chile Standard Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, COT),
-      TimezoneStruct(SouthAmerica, COT, QStringLiteral("COT"),
-                     QStringLiteral("Colombia Time"),
-                     QStringLiteral("South America"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, CST),
-      TimezoneStruct(NorthAmerica, CST, QStringLiteral("CST"),
-                     QStringLiteral("Central Standard Time"),
-                     QStringLiteral("North America"), -21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, CST),
-                           TimezoneStruct(Asia, CST, QStringLiteral("CST"),
-                                          QStringLiteral("China Standard Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Caribbean, CST),
-      TimezoneStruct(Caribbean, CST, QStringLiteral("CST"),
-                     QStringLiteral("Cuba Standard Time"),
-                     QStringLiteral("Caribbean"), -18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, CVT),
-                           TimezoneStruct(Africa, CVT, QStringLiteral("CVT"),
-                                          QStringLiteral("Cape Verde Time"),
-                                          QStringLiteral("Africa"), -3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, CXT),
-      TimezoneStruct(Australia, CXT, QStringLiteral("CXT"),
-                     QStringLiteral("Christmas Island Time"),
-                     QStringLiteral("Australia"), 25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, ChST),
-      TimezoneStruct(Pacific, ChST, QStringLiteral("ChST"),
-                     QStringLiteral("Chamorro Standard Time"),
-                     QStringLiteral("Pacific"), 36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, D),
-                           TimezoneStruct(Military, D, QStringLiteral("D"),
-                                          QStringLiteral("Delta Time Zone"),
-                                          QStringLiteral("Military"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, DAVT),
-      TimezoneStruct(Antarctica, DAVT, QStringLiteral("DAVT"),
-                     QStringLiteral("Davis Time"), QStringLiteral("Antarctica"),
-                     25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, DDUT),
-      TimezoneStruct(Antarctica, DDUT, QStringLiteral("DDUT"),
-                     QStringLiteral(""), QStringLiteral("Antarctica"), 36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, E),
-                           TimezoneStruct(Military, E, QStringLiteral("E"),
-                                          QStringLiteral("Echo Time Zone"),
-                                          QStringLiteral("Military"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, EASST),
-      TimezoneStruct(Pacific, EASST, QStringLiteral("EASST"),
-                     QStringLiteral("Easter Island Summer Time"),
-                     QStringLiteral("Pacific"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, EAST),
-      TimezoneStruct(Pacific, EAST, QStringLiteral("EAST"),
-                     QStringLiteral("Easter Island Standard Time"),
-                     QStringLiteral("Pacific"), -21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, EAT),
-                           TimezoneStruct(Africa, EAT, QStringLiteral("EAT"),
-                                          QStringLiteral("Eastern Africa Time"),
-                                          QStringLiteral("Africa"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, ECT),
-      TimezoneStruct(SouthAmerica, ECT, QStringLiteral("ECT"),
-                     QStringLiteral("Ecuador Time"),
-                     QStringLiteral("South America"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, EDT),
-      TimezoneStruct(NorthAmerica, EDT, QStringLiteral("EDT"),
-                     QStringLiteral("Eastern Daylight Time"),
-                     QStringLiteral("North America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, EEST),
-      TimezoneStruct(Europe, EEST, QStringLiteral("EEST"),
-                     QStringLiteral("Eastern European Summer Time"),
-                     QStringLiteral("Europe"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, EET),
-      TimezoneStruct(Europe, EET, QStringLiteral("EET"),
-                     QStringLiteral("Eastern European Time"),
-                     QStringLiteral("Europe"), 7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, EGST),
-      TimezoneStruct(NorthAmerica, EGST, QStringLiteral("EGST"),
-                     QStringLiteral("Eastern Greenland Summer Time"),
-                     QStringLiteral("North America"), 0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, EGT),
-      TimezoneStruct(NorthAmerica, EGT, QStringLiteral("EGT"),
-                     QStringLiteral("East Greenland Time"),
-                     QStringLiteral("North America"), -3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, EST),
-      TimezoneStruct(NorthAmerica, EST, QStringLiteral("EST"),
-                     QStringLiteral("Eastern Standard Time"),
-                     QStringLiteral("North America"), -18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, F),
-                           TimezoneStruct(Military, F, QStringLiteral("F"),
-                                          QStringLiteral("Foxtrot Time Zone"),
-                                          QStringLiteral("Military"), 21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, FET),
-      TimezoneStruct(Europe, FET, QStringLiteral("FET"),
-                     QStringLiteral("Further-Eastern European Time"),
-                     QStringLiteral("Europe"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, FJST),
-      TimezoneStruct(Pacific, FJST, QStringLiteral("FJST"),
-                     QStringLiteral("Fiji Summer Time"),
-                     QStringLiteral("Pacific"), 46800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, FJT),
-                           TimezoneStruct(Pacific, FJT, QStringLiteral("FJT"),
-                                          QStringLiteral("Fiji Time"),
-                                          QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, FKST),
-      TimezoneStruct(SouthAmerica, FKST, QStringLiteral("FKST"),
-                     QStringLiteral("Falkland Islands Summer Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, FKT),
-      TimezoneStruct(SouthAmerica, FKT, QStringLiteral("FKT"),
-                     QStringLiteral("Falkland Island Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, FNT),
-      TimezoneStruct(SouthAmerica, FNT, QStringLiteral("FNT"),
-                     QStringLiteral("Fernando de Noronha Time"),
-                     QStringLiteral("South America"), -7200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, G),
-                           TimezoneStruct(Military, G, QStringLiteral("G"),
-                                          QStringLiteral("Golf Time Zone"),
-                                          QStringLiteral("Military"), 25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, GALT),
-      TimezoneStruct(Pacific, GALT, QStringLiteral("GALT"),
-                     QStringLiteral("Galapagos Time"),
-                     QStringLiteral("Pacific"), -21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, GAMT),
-      TimezoneStruct(Pacific, GAMT, QStringLiteral("GAMT"),
-                     QStringLiteral("Gambier Time"), QStringLiteral("Pacific"),
-                     -32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, GET),
-      TimezoneStruct(Asia, GET, QStringLiteral("GET"),
-                     QStringLiteral("Georgia Standard Time"),
-                     QStringLiteral("Asia"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, GFT),
-      TimezoneStruct(SouthAmerica, GFT, QStringLiteral("GFT"),
-                     QStringLiteral("French Guiana Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, GILT),
-      TimezoneStruct(Pacific, GILT, QStringLiteral("GILT"),
-                     QStringLiteral("Gilbert Island Time"),
-                     QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Europe, GMT),
-                           TimezoneStruct(Europe, GMT, QStringLiteral("GMT"),
-                                          QStringLiteral("Greenwich Mean Time"),
-                                          QStringLiteral("Europe"), 0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, GST),
-                           TimezoneStruct(Asia, GST, QStringLiteral("GST"),
-                                          QStringLiteral("Gulf Standard Time"),
-                                          QStringLiteral("Asia"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, GST),
-      TimezoneStruct(SouthAmerica, GST, QStringLiteral("GST"),
-                     QStringLiteral("South Georgia Time"),
-                     QStringLiteral("South America"), -7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, GYT),
-      TimezoneStruct(SouthAmerica, GYT, QStringLiteral("GYT"),
-                     QStringLiteral("Guyana Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, H),
-                           TimezoneStruct(Military, H, QStringLiteral("H"),
-                                          QStringLiteral("Hotel Time Zone"),
-                                          QStringLiteral("Military"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, HADT),
-      TimezoneStruct(NorthAmerica, HADT, QStringLiteral("HADT"),
-                     QStringLiteral("Hawaii-Aleutian Daylight Time"),
-                     QStringLiteral("North America"), -32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, HAST),
-      TimezoneStruct(NorthAmerica, HAST, QStringLiteral("HAST"),
-                     QStringLiteral("Hawaii-Aleutian Standard Time"),
-                     QStringLiteral("North America"), -36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, HKT),
-                           TimezoneStruct(Asia, HKT, QStringLiteral("HKT"),
-                                          QStringLiteral("Hong Kong Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, HOVST),
-                           TimezoneStruct(Asia, HOVST, QStringLiteral("HOVST"),
-                                          QStringLiteral("Hovd Summer Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, HOVT),
-                           TimezoneStruct(Asia, HOVT, QStringLiteral("HOVT"),
-                                          QStringLiteral("Hovd Time"),
-                                          QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, I),
-                           TimezoneStruct(Military, I, QStringLiteral("I"),
-                                          QStringLiteral("India Time Zone"),
-                                          QStringLiteral("Military"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ICT),
-                           TimezoneStruct(Asia, ICT, QStringLiteral("ICT"),
-                                          QStringLiteral("Indochina Time"),
-                                          QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, IDT),
-      TimezoneStruct(Asia, IDT, QStringLiteral("IDT"),
-                     QStringLiteral("Israel Daylight Time"),
-                     QStringLiteral("Asia"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(IndianOcean, IOT),
-      TimezoneStruct(IndianOcean, IOT, QStringLiteral("IOT"),
-                     QStringLiteral("Indian Chagos Time"),
-                     QStringLiteral("Indian Ocean"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, IRDT),
-                           TimezoneStruct(Asia, IRDT, QStringLiteral("IRDT"),
-                                          QStringLiteral("Iran Daylight Time"),
-                                          QStringLiteral("Asia"), 16200.0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, IRKST),
-                           TimezoneStruct(Asia, IRKST, QStringLiteral("IRKST"),
-                                          QStringLiteral("Irkutsk Summer Time"),
-                                          QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, IRKT),
-                           TimezoneStruct(Asia, IRKT, QStringLiteral("IRKT"),
-                                          QStringLiteral("Irkutsk Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, IRST),
-                           TimezoneStruct(Asia, IRST, QStringLiteral("IRST"),
-                                          QStringLiteral("Iran Standard Time"),
-                                          QStringLiteral("Asia"), 12600.0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, IST),
-                           TimezoneStruct(Asia, IST, QStringLiteral("IST"),
-                                          QStringLiteral("India Standard Time"),
-                                          QStringLiteral("Asia"), 19800.0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Europe, IST),
-                           TimezoneStruct(Europe, IST, QStringLiteral("IST"),
-                                          QStringLiteral("Irish Standard Time"),
-                                          QStringLiteral("Europe"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, IST),
-      TimezoneStruct(Asia, IST, QStringLiteral("IST"),
-                     QStringLiteral("Israel Standard Time"),
-                     QStringLiteral("Asia"), 7200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, JST),
-                           TimezoneStruct(Asia, JST, QStringLiteral("JST"),
-                                          QStringLiteral("Japan Standard Time"),
-                                          QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, K),
-                           TimezoneStruct(Military, K, QStringLiteral("K"),
-                                          QStringLiteral("Kilo Time Zone"),
-                                          QStringLiteral("Military"), 36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, KGT),
-                           TimezoneStruct(Asia, KGT, QStringLiteral("KGT"),
-                                          QStringLiteral("Kyrgyzstan Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, KOST),
-      TimezoneStruct(Pacific, KOST, QStringLiteral("KOST"),
-                     QStringLiteral("Kosrae Time"), QStringLiteral("Pacific"),
-                     39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, KRAST),
-      TimezoneStruct(Asia, KRAST, QStringLiteral("KRAST"),
-                     QStringLiteral("Krasnoyarsk Summer Time"),
-                     QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, KRAT),
-                           TimezoneStruct(Asia, KRAT, QStringLiteral("KRAT"),
-                                          QStringLiteral("Krasnoyarsk Time"),
-                                          QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, KST),
-                           TimezoneStruct(Asia, KST, QStringLiteral("KST"),
-                                          QStringLiteral("Korea Standard Time"),
-                                          QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Europe, KUYT),
-                           TimezoneStruct(Europe, KUYT, QStringLiteral("KUYT"),
-                                          QStringLiteral("Kuybyshev Time"),
-                                          QStringLiteral("Europe"), 14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, L),
-                           TimezoneStruct(Military, L, QStringLiteral("L"),
-                                          QStringLiteral("Lima Time Zone"),
-                                          QStringLiteral("Military"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, LHDT),
-      TimezoneStruct(Australia, LHDT, QStringLiteral("LHDT"),
-                     QStringLiteral("Lord Howe Daylight Time"),
-                     QStringLiteral("Australia"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, LHST),
-      TimezoneStruct(Australia, LHST, QStringLiteral("LHST"),
-                     QStringLiteral("Lord Howe Standard Time"),
-                     QStringLiteral("Australia"), 37800.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, LINT),
-      TimezoneStruct(Pacific, LINT, QStringLiteral("LINT"),
-                     QStringLiteral("Line Islands Time"),
-                     QStringLiteral("Pacific"), 50400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, M),
-                           TimezoneStruct(Military, M, QStringLiteral("M"),
-                                          QStringLiteral("Mike Time Zone"),
-                                          QStringLiteral("Military"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, MAGST),
-                           TimezoneStruct(Asia, MAGST, QStringLiteral("MAGST"),
-                                          QStringLiteral("Magadan Summer Time"),
-                                          QStringLiteral("Asia"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, MAGT),
-                           TimezoneStruct(Asia, MAGT, QStringLiteral("MAGT"),
-                                          QStringLiteral("Magadan Time"),
-                                          QStringLiteral("Asia"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, MART),
-      TimezoneStruct(Pacific, MART, QStringLiteral("MART"),
-                     QStringLiteral("Marquesas Time"),
-                     QStringLiteral("Pacific"), -34200.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, MAWT),
-      TimezoneStruct(Antarctica, MAWT, QStringLiteral("MAWT"),
-                     QStringLiteral("Mawson Time"),
-                     QStringLiteral("Antarctica"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, MDT),
-      TimezoneStruct(NorthAmerica, MDT, QStringLiteral("MDT"),
-                     QStringLiteral("Mountain Daylight Time"),
-                     QStringLiteral("North America"), -21600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, MHT),
-      TimezoneStruct(Pacific, MHT, QStringLiteral("MHT"),
-                     QStringLiteral("Marshall Islands Time"),
-                     QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, MMT),
-                           TimezoneStruct(Asia, MMT, QStringLiteral("MMT"),
-                                          QStringLiteral("Myanmar Time"),
-                                          QStringLiteral("Asia"), 23400.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, MSD),
-      TimezoneStruct(Europe, MSD, QStringLiteral("MSD"),
-                     QStringLiteral("Moscow Daylight Time"),
-                     QStringLiteral("Europe"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, MSK),
-      TimezoneStruct(Europe, MSK, QStringLiteral("MSK"),
-                     QStringLiteral("Moscow Standard Time"),
-                     QStringLiteral("Europe"), 10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, MST),
-      TimezoneStruct(NorthAmerica, MST, QStringLiteral("MST"),
-                     QStringLiteral("Mountain Standard Time"),
-                     QStringLiteral("North America"), -25200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, MUT),
-                           TimezoneStruct(Africa, MUT, QStringLiteral("MUT"),
-                                          QStringLiteral("Mauritius Time"),
-                                          QStringLiteral("Africa"), 14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, MVT),
-                           TimezoneStruct(Asia, MVT, QStringLiteral("MVT"),
-                                          QStringLiteral("Maldives Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, MYT),
-                           TimezoneStruct(Asia, MYT, QStringLiteral("MYT"),
-                                          QStringLiteral("Malaysia Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, N),
-                           TimezoneStruct(Military, N, QStringLiteral("N"),
-                                          QStringLiteral("November Time Zone"),
-                                          QStringLiteral("Military"), -3600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, NCT),
-                           TimezoneStruct(Pacific, NCT, QStringLiteral("NCT"),
-                                          QStringLiteral("New Caledonia Time"),
-                                          QStringLiteral("Pacific"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, NDT),
-      TimezoneStruct(NorthAmerica, NDT, QStringLiteral("NDT"),
-                     QStringLiteral("Newfoundland Daylight Time"),
-                     QStringLiteral("North America"), -9000.0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Australia, NFT),
-      TimezoneStruct(Australia, NFT, QStringLiteral("NFT"),
-                     QStringLiteral("Norfolk Time"),
-                     QStringLiteral("Australia"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, NOVST),
-      TimezoneStruct(Asia, NOVST, QStringLiteral("NOVST"),
-                     QStringLiteral("Novosibirsk Summer Time"),
-                     QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, NOVT),
-                           TimezoneStruct(Asia, NOVT, QStringLiteral("NOVT"),
-                                          QStringLiteral("Novosibirsk Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, NPT),
-                           TimezoneStruct(Asia, NPT, QStringLiteral("NPT"),
-                                          QStringLiteral("Nepal Time"),
-                                          QStringLiteral("Asia"), 20700.00));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, NRT),
-                           TimezoneStruct(Pacific, NRT, QStringLiteral("NRT"),
-                                          QStringLiteral("Nauru Time"),
-                                          QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, NST),
-      TimezoneStruct(NorthAmerica, NST, QStringLiteral("NST"),
-                     QStringLiteral("Newfoundland Standard Time"),
-                     QStringLiteral("North America"), -12600.0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, NUT),
-                           TimezoneStruct(Pacific, NUT, QStringLiteral("NUT"),
-                                          QStringLiteral("Niue Time"),
-                                          QStringLiteral("Pacific"), -39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, NZDT),
-      TimezoneStruct(Pacific, NZDT, QStringLiteral("NZDT"),
-                     QStringLiteral("New Zealand Daylight Time"),
-                     QStringLiteral("Pacific"), 46800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, NZST),
-      TimezoneStruct(Pacific, NZST, QStringLiteral("NZST"),
-                     QStringLiteral("New Zealand Standard Time"),
-                     QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, O),
-                           TimezoneStruct(Military, O, QStringLiteral("O"),
-                                          QStringLiteral("Oscar Time Zone"),
-                                          QStringLiteral("Military"), -7200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, OMSST),
-                           TimezoneStruct(Asia, OMSST, QStringLiteral("OMSST"),
-                                          QStringLiteral("Omsk Summer Time"),
-                                          QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, OMST),
-                           TimezoneStruct(Asia, OMST, QStringLiteral("OMST"),
-                                          QStringLiteral("Omsk Standard Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ORAT),
-                           TimezoneStruct(Asia, ORAT, QStringLiteral("ORAT"),
-                                          QStringLiteral("Oral Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, P),
-                           TimezoneStruct(Military, P, QStringLiteral("P"),
-                                          QStringLiteral("Papa Time Zone"),
-                                          QStringLiteral("Military"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, PDT),
-      TimezoneStruct(NorthAmerica, PDT, QStringLiteral("PDT"),
-                     QStringLiteral("Pacific Daylight Time"),
-                     QStringLiteral("North America"), -25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, PET),
-      TimezoneStruct(SouthAmerica, PET, QStringLiteral("PET"),
-                     QStringLiteral("Peru Time"),
-                     QStringLiteral("South America"), -18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, PETST),
-      TimezoneStruct(Asia, PETST, QStringLiteral("PETST"),
-                     QStringLiteral("Kamchatka Summer Time"),
-                     QStringLiteral("Asia"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, PETT),
-                           TimezoneStruct(Asia, PETT, QStringLiteral("PETT"),
-                                          QStringLiteral("Kamchatka Time"),
-                                          QStringLiteral("Asia"), 43200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, PGT),
-      TimezoneStruct(Pacific, PGT, QStringLiteral("PGT"),
-                     QStringLiteral("Papua New Guinea Time"),
-                     QStringLiteral("Pacific"), 36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, PHOT),
-      TimezoneStruct(Pacific, PHOT, QStringLiteral("PHOT"),
-                     QStringLiteral("Phoenix Island Time"),
-                     QStringLiteral("Pacific"), 46800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, PHT),
-                           TimezoneStruct(Asia, PHT, QStringLiteral("PHT"),
-                                          QStringLiteral("Philippine Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, PKT),
-      TimezoneStruct(Asia, PKT, QStringLiteral("PKT"),
-                     QStringLiteral("Pakistan Standard Time"),
-                     QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, PMDT),
-      TimezoneStruct(NorthAmerica, PMDT, QStringLiteral("PMDT"),
-                     QStringLiteral("Pierre & Miquelon Daylight Time"),
-                     QStringLiteral("North America"), -7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, PMST),
-      TimezoneStruct(NorthAmerica, PMST, QStringLiteral("PMST"),
-                     QStringLiteral("Pierre & Miquelon Standard Time"),
-                     QStringLiteral("North America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, PONT),
-      TimezoneStruct(Pacific, PONT, QStringLiteral("PONT"),
-                     QStringLiteral("Pohnpei Standard Time"),
-                     QStringLiteral("Pacific"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, PST),
-      TimezoneStruct(NorthAmerica, PST, QStringLiteral("PST"),
-                     QStringLiteral("Pacific Standard Time"),
-                     QStringLiteral("North America"), -28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, PST),
-      TimezoneStruct(Pacific, PST, QStringLiteral("PST"),
-                     QStringLiteral("Pitcairn Standard Time"),
-                     QStringLiteral("Pacific"), -28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, PWT),
-                           TimezoneStruct(Pacific, PWT, QStringLiteral("PWT"),
-                                          QStringLiteral("Palau Time"),
-                                          QStringLiteral("Pacific"), 32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, PYST),
-      TimezoneStruct(SouthAmerica, PYST, QStringLiteral("PYST"),
-                     QStringLiteral("Paraguay Summer Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, PYT),
-      TimezoneStruct(SouthAmerica, PYT, QStringLiteral("PYT"),
-                     QStringLiteral("Paraguay Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, PYT),
-                           TimezoneStruct(Asia, PYT, QStringLiteral("PYT"),
-                                          QStringLiteral("Pyongyang Time"),
-                                          QStringLiteral("Asia"), 30600.0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, Q),
-                           TimezoneStruct(Military, Q, QStringLiteral("Q"),
-                                          QStringLiteral("Quebec Time Zone"),
-                                          QStringLiteral("Military"), -14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, QYZT),
-                           TimezoneStruct(Asia, QYZT, QStringLiteral("QYZT"),
-                                          QStringLiteral("Qyzylorda Time"),
-                                          QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, R),
-                           TimezoneStruct(Military, R, QStringLiteral("R"),
-                                          QStringLiteral("Romeo Time Zone"),
-                                          QStringLiteral("Military"), -18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, RET),
-                           TimezoneStruct(Africa, RET, QStringLiteral("RET"),
-                                          QStringLiteral("Reunion Time"),
-                                          QStringLiteral("Africa"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, ROTT),
-      TimezoneStruct(Antarctica, ROTT, QStringLiteral("ROTT"),
-                     QStringLiteral("Rothera Time"),
-                     QStringLiteral("Antarctica"), -10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, S),
-                           TimezoneStruct(Military, S, QStringLiteral("S"),
-                                          QStringLiteral("Sierra Time Zone"),
-                                          QStringLiteral("Military"), -21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, SAKT),
-                           TimezoneStruct(Asia, SAKT, QStringLiteral("SAKT"),
-                                          QStringLiteral("Sakhalin Time"),
-                                          QStringLiteral("Asia"), 39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Europe, SAMT),
-                           TimezoneStruct(Europe, SAMT, QStringLiteral("SAMT"),
-                                          QStringLiteral("Samara Time"),
-                                          QStringLiteral("Europe"), 14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Africa, SAST),
-      TimezoneStruct(Africa, SAST, QStringLiteral("SAST"),
-                     QStringLiteral("South Africa Standard Time"),
-                     QStringLiteral("Africa"), 7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, SBT),
-      TimezoneStruct(Pacific, SBT, QStringLiteral("SBT"),
-                     QStringLiteral("Solomon Islands Time"),
-                     QStringLiteral("Pacific"), 39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, SCT),
-                           TimezoneStruct(Africa, SCT, QStringLiteral("SCT"),
-                                          QStringLiteral("Seychelles Time"),
-                                          QStringLiteral("Africa"), 14400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, SGT),
-                           TimezoneStruct(Asia, SGT, QStringLiteral("SGT"),
-                                          QStringLiteral("Singapore Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, SRET),
-                           TimezoneStruct(Asia, SRET, QStringLiteral("SRET"),
-                                          QStringLiteral("Srednekolymsk Time"),
-                                          QStringLiteral("Asia"), 39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, SRT),
-      TimezoneStruct(SouthAmerica, SRT, QStringLiteral("SRT"),
-                     QStringLiteral("Suriname Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, SST),
-                           TimezoneStruct(Pacific, SST, QStringLiteral("SST"),
-                                          QStringLiteral("Samoa Standard Time"),
-                                          QStringLiteral("Pacific"), -39600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, SYOT),
-      TimezoneStruct(Antarctica, SYOT, QStringLiteral("SYOT"),
-                     QStringLiteral("Syowa Time"), QStringLiteral("Antarctica"),
-                     10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, T),
-                           TimezoneStruct(Military, T, QStringLiteral("T"),
-                                          QStringLiteral("Tango Time Zone"),
-                                          QStringLiteral("Military"), -25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, TAHT),
-      TimezoneStruct(Pacific, TAHT, QStringLiteral("TAHT"),
-                     QStringLiteral("Tahiti Time"), QStringLiteral("Pacific"),
-                     -36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(IndianOcean, TFT),
-      TimezoneStruct(IndianOcean, TFT, QStringLiteral("TFT"),
-                     QStringLiteral("French Southern and Antarctic Time"),
-                     QStringLiteral("Indian Ocean"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, TJT),
-                           TimezoneStruct(Asia, TJT, QStringLiteral("TJT"),
-                                          QStringLiteral("Tajikistan Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, TKT),
-                           TimezoneStruct(Pacific, TKT, QStringLiteral("TKT"),
-                                          QStringLiteral("Tokelau Time"),
-                                          QStringLiteral("Pacific"), 46800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, TLT),
-                           TimezoneStruct(Asia, TLT, QStringLiteral("TLT"),
-                                          QStringLiteral("East Timor Time"),
-                                          QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, TMT),
-                           TimezoneStruct(Asia, TMT, QStringLiteral("TMT"),
-                                          QStringLiteral("Turkmenistan Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, TOST),
-      TimezoneStruct(Pacific, TOST, QStringLiteral("TOST"),
-                     QStringLiteral("Tonga Summer Time"),
-                     QStringLiteral("Pacific"), 50400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, TOT),
-                           TimezoneStruct(Pacific, TOT, QStringLiteral("TOT"),
-                                          QStringLiteral("Tonga Time"),
-                                          QStringLiteral("Pacific"), 46800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, TRT),
-                           TimezoneStruct(Asia, TRT, QStringLiteral("TRT"),
-                                          QStringLiteral("Turkey Time"),
-                                          QStringLiteral("Asia"), 10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, TVT),
-                           TimezoneStruct(Pacific, TVT, QStringLiteral("TVT"),
-                                          QStringLiteral("Tuvalu Time"),
-                                          QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, U),
-                           TimezoneStruct(Military, U, QStringLiteral("U"),
-                                          QStringLiteral("Uniform Time Zone"),
-                                          QStringLiteral("Military"), -28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, ULAST),
-      TimezoneStruct(Asia, ULAST, QStringLiteral("ULAST"),
-                     QStringLiteral("Ulaanbaatar Summer Time"),
-                     QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, ULAT),
-                           TimezoneStruct(Asia, ULAT, QStringLiteral("ULAT"),
-                                          QStringLiteral("Ulaanbaatar Time"),
-                                          QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Worldwide, UTC),
-      TimezoneStruct(Worldwide, UTC, QStringLiteral("UTC"),
-                     QStringLiteral("Coordinated Universal Time"),
-                     QStringLiteral("Worldwide"), 0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, UYST),
-      TimezoneStruct(SouthAmerica, UYST, QStringLiteral("UYST"),
-                     QStringLiteral("Uruguay Summer Time"),
-                     QStringLiteral("South America"), -7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, UYT),
-      TimezoneStruct(SouthAmerica, UYT, QStringLiteral("UYT"),
-                     QStringLiteral("Uruguay Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, UZT),
-                           TimezoneStruct(Asia, UZT, QStringLiteral("UZT"),
-                                          QStringLiteral("Uzbekistan Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, V),
-                           TimezoneStruct(Military, V, QStringLiteral("V"),
-                                          QStringLiteral("Victor Time Zone"),
-                                          QStringLiteral("Military"), -32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, VET),
-      TimezoneStruct(SouthAmerica, VET, QStringLiteral("VET"),
-                     QStringLiteral("Venezuelan Standard Time"),
-                     QStringLiteral("South America"), -14400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, VLAST),
-      TimezoneStruct(Asia, VLAST, QStringLiteral("VLAST"),
-                     QStringLiteral("Vladivostok Summer Time"),
-                     QStringLiteral("Asia"), 39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, VLAT),
-                           TimezoneStruct(Asia, VLAT, QStringLiteral("VLAT"),
-                                          QStringLiteral("Vladivostok Time"),
-                                          QStringLiteral("Asia"), 36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Antarctica, VOST),
-      TimezoneStruct(Antarctica, VOST, QStringLiteral("VOST"),
-                     QStringLiteral("Vostok Time"),
-                     QStringLiteral("Antarctica"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, VUT),
-                           TimezoneStruct(Pacific, VUT, QStringLiteral("VUT"),
-                                          QStringLiteral("Vanuatu Time"),
-                                          QStringLiteral("Pacific"), 39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, W),
-                           TimezoneStruct(Military, W, QStringLiteral("W"),
-                                          QStringLiteral("Whiskey Time Zone"),
-                                          QStringLiteral("Military"), -36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, WAKT),
-      TimezoneStruct(Pacific, WAKT, QStringLiteral("WAKT"),
-                     QStringLiteral("Wake Time"), QStringLiteral("Pacific"),
-                     43200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(SouthAmerica, WARST),
-      TimezoneStruct(SouthAmerica, WARST, QStringLiteral("WARST"),
-                     QStringLiteral("Western Argentine Summer Time"),
-                     QStringLiteral("South America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Africa, WAST),
-      TimezoneStruct(Africa, WAST, QStringLiteral("WAST"),
-                     QStringLiteral("West Africa Summer Time"),
-                     QStringLiteral("Africa"), 7200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Africa, WAT),
-                           TimezoneStruct(Africa, WAT, QStringLiteral("WAT"),
-                                          QStringLiteral("West Africa Time"),
-                                          QStringLiteral("Africa"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, WEST),
-      TimezoneStruct(Europe, WEST, QStringLiteral("WEST"),
-                     QStringLiteral("Western European Summer Time"),
-                     QStringLiteral("Europe"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Europe, WET),
-      TimezoneStruct(Europe, WET, QStringLiteral("WET"),
-                     QStringLiteral("Western European Time"),
-                     QStringLiteral("Europe"), 0));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, WFT),
-      TimezoneStruct(Pacific, WFT, QStringLiteral("WFT"),
-                     QStringLiteral("Wallis and Futuna Time"),
-                     QStringLiteral("Pacific"), 43200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, WGST),
-      TimezoneStruct(NorthAmerica, WGST, QStringLiteral("WGST"),
-                     QStringLiteral("Western Greenland Summer Time"),
-                     QStringLiteral("North America"), -7200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(NorthAmerica, WGT),
-      TimezoneStruct(NorthAmerica, WGT, QStringLiteral("WGT"),
-                     QStringLiteral("West Greenland Time"),
-                     QStringLiteral("North America"), -10800));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, WIB),
-      TimezoneStruct(Asia, WIB, QStringLiteral("WIB"),
-                     QStringLiteral("Western Indonesian Time"),
-                     QStringLiteral("Asia"), 25200));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, WIT),
-      TimezoneStruct(Asia, WIT, QStringLiteral("WIT"),
-                     QStringLiteral("Eastern Indonesian Time"),
-                     QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, WITA),
-      TimezoneStruct(Asia, WITA, QStringLiteral("WITA"),
-                     QStringLiteral("Central Indonesian Time"),
-                     QStringLiteral("Asia"), 28800));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Pacific, WST),
-                           TimezoneStruct(Pacific, WST, QStringLiteral("WST"),
-                                          QStringLiteral("West Samoa Time"),
-                                          QStringLiteral("Pacific"), 50400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Africa, WST),
-      TimezoneStruct(Africa, WST, QStringLiteral("WST"),
-                     QStringLiteral("Western Sahara Summer Time"),
-                     QStringLiteral("Africa"), 3600));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Africa, WT),
-      TimezoneStruct(Africa, WT, QStringLiteral("WT"),
-                     QStringLiteral("Western Sahara Standard Time"),
-                     QStringLiteral("Africa"), 0));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, X),
-                           TimezoneStruct(Military, X, QStringLiteral("X"),
-                                          QStringLiteral("X-ray Time Zone"),
-                                          QStringLiteral("Military"), -39600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, Y),
-                           TimezoneStruct(Military, Y, QStringLiteral("Y"),
-                                          QStringLiteral("Yankee Time Zone"),
-                                          QStringLiteral("Military"), -43200));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, YAKST),
-                           TimezoneStruct(Asia, YAKST, QStringLiteral("YAKST"),
-                                          QStringLiteral("Yakutsk Summer Time"),
-                                          QStringLiteral("Asia"), 36000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, YAKT),
-                           TimezoneStruct(Asia, YAKT, QStringLiteral("YAKT"),
-                                          QStringLiteral("Yakutsk Time"),
-                                          QStringLiteral("Asia"), 32400));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Pacific, YAPT),
-      TimezoneStruct(Pacific, YAPT, QStringLiteral("YAPT"),
-                     QStringLiteral("Yap Time"), QStringLiteral("Pacific"),
-                     36000));
-  this->m_timezones.insert(
-      std::make_pair<Location, Abbreviation>(Asia, YEKST),
-      TimezoneStruct(Asia, YEKST, QStringLiteral("YEKST"),
-                     QStringLiteral("Yekaterinburg Summer Time"),
-                     QStringLiteral("Asia"), 21600));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Asia, YEKT),
-                           TimezoneStruct(Asia, YEKT, QStringLiteral("YEKT"),
-                                          QStringLiteral("Yekaterinburg Time"),
-                                          QStringLiteral("Asia"), 18000));
-  this->m_timezones.insert(std::make_pair<Location, Abbreviation>(Military, Z),
-                           TimezoneStruct(Military, Z, QStringLiteral("Z"),
-                                          QStringLiteral("Zulu Time Zone"),
-                                          QStringLiteral("Military"), 0));
-  return;
+  const TimezoneStruct *zone =
+      timezoneIndex().find(value.simplified(), location);
+  if (zone == nullptr) return 0;
+  return zone->getOffsetSeconds();
 }
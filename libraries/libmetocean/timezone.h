@@ -22,6 +22,7 @@
 
 #include <QMap>
 #include <QObject>
+#include <QStringList>
 #include "metocean_global.h"
 #include "timezonestruct.h"
 
@@ -53,14 +54,9 @@ class Timezone : public QObject {
   QStringList getTimezoneNames(TZData::Location location);
 
  private:
-  void build();
-
   bool m_initialized;
 
   TimezoneStruct m_zone;
-
-  QMap<std::pair<TZData::Location, TZData::Abbreviation>, TimezoneStruct>
-      m_timezones;
 };
 
 #endif  // TIMEZONE_H
@@ -29,12 +29,14 @@ UsgsWaterdata::UsgsWaterdata(Station &station, QDateTime startDate,
   this->m_databaseOption = databaseOption;
 }
 
-int UsgsWaterdata::get(Hmdf *data, Datum::VDatum datum) {
+QString UsgsWaterdata::cacheKey(Datum::VDatum datum) const {
   Q_UNUSED(datum)
-  return this->fetch(data);
+  return "usgs|" + this->station().id() + "|" +
+         QString::number(this->m_databaseOption);
 }
 
-int UsgsWaterdata::fetch(Hmdf *data) {
+int UsgsWaterdata::retrieveData(Hmdf *data, Datum::VDatum datum) {
+  Q_UNUSED(datum)
   if (this->station().id() == QString()) {
     this->setErrorString("You must select a station");
     return 1;
@@ -44,6 +46,22 @@ int UsgsWaterdata::fetch(Hmdf *data) {
   return this->download(request, data);
 }
 
+QVector<QUrl> UsgsWaterdata::requestUrls() {
+  QVector<QUrl> urls;
+  if (this->station().id() != QString()) urls.push_back(this->buildUrl());
+  return urls;
+}
+
+int UsgsWaterdata::processResponses(const QVector<QByteArray> &responses,
+                                    Hmdf *data) {
+  if (responses.isEmpty()) {
+    this->setErrorString("There was an error contacting the USGS data server");
+    return 1;
+  }
+  QByteArray response = responses.first();
+  return this->readUsgsData(response, data);
+}
+
 QUrl UsgsWaterdata::buildUrl() {
   //...Format the date strings
   QString endDateString1 =
@@ -29,10 +29,14 @@ class UsgsWaterdata : public WaterData {
   UsgsWaterdata(Station &station, QDateTime startDate, QDateTime endDate,
                 int databaseOption, QObject *parent = nullptr);
 
-  int get(Hmdf *data, Datum::VDatum datum = Datum::VDatum::NullDatum);
+  QVector<QUrl> requestUrls() override;
+  int processResponses(const QVector<QByteArray> &responses,
+                       Hmdf *data) override;
 
  private:
-  int fetch(Hmdf *data);
+  int retrieveData(Hmdf *data,
+                   Datum::VDatum datum = Datum::VDatum::NullDatum) override;
+  QString cacheKey(Datum::VDatum datum) const override;
 
   QUrl buildUrl();
 
@@ -18,6 +18,11 @@
 //
 //-----------------------------------------------------------------------*/
 #include "waterdata.h"
+#include "waterdatacache.h"
+
+//...Data newer than this is requested again on every call since the
+//   servers may still revise it
+static const qint64 c_cacheHorizon = 2 * 86400000LL;
 
 WaterData::WaterData(const Station &station, const QDateTime startDate, const QDateTime endDate,
                      QObject *parent)
@@ -27,10 +32,91 @@ WaterData::WaterData(const Station &station, const QDateTime startDate, const QD
   this->m_startDate = startDate;
   this->m_endDate = endDate;
   this->m_timezone = new Timezone(this);
+  this->m_useCache = true;
+  this->m_cacheDirectory = WaterDataCache::defaultDirectory();
 }
 
 int WaterData::get(Hmdf *data, Datum::VDatum datum) {
-  return this->retrieveData(data, datum);
+  QString key = this->cacheKey(datum);
+  if (!this->m_useCache || key.isEmpty())
+    return this->retrieveData(data, datum);
+  return this->getCached(data, datum, key);
+}
+
+//...Serves the request from the local cache, calling retrieveData only for
+//   the parts of the window that have not been downloaded before
+int WaterData::getCached(Hmdf *data, Datum::VDatum datum,
+                         const QString &key) {
+  WaterDataCache cache(key, this->m_cacheDirectory);
+  cache.read();
+
+  //...Windows are kept in the same epoch milliseconds the fetchers filter
+  //   their samples by, so the recorded coverage matches what was returned
+  QDateTime startDate = this->startDate();
+  QDateTime endDate = this->endDate();
+  qint64 start = startDate.toMSecsSinceEpoch();
+  qint64 end = endDate.toMSecsSinceEpoch();
+  qint64 horizon = QDateTime::currentMSecsSinceEpoch() - c_cacheHorizon;
+
+  QVector<WaterDataCache::Interval> gaps = cache.gaps(start, end);
+  int ierr = 0;
+
+  for (auto &g : gaps) {
+    this->setStartDate(startDate.addMSecs(g.first - start));
+    this->setEndDate(endDate.addMSecs(g.second - end));
+    Hmdf *part = new Hmdf(this);
+    int err = this->retrieveData(part, datum);
+    if (err == 0) {
+      cache.insert(part, g.first, g.second, horizon);
+    } else {
+      ierr = err;
+    }
+    delete part;
+  }
+
+  this->setStartDate(startDate);
+  this->setEndDate(endDate);
+
+  if (!gaps.isEmpty()) {
+    cache.write();
+    WaterDataCache::prune(this->m_cacheDirectory);
+  }
+
+  //...The parts that did download are kept for next time, but a window
+  //   with a failed gap is not reported as complete
+  if (ierr != 0) return ierr;
+
+  if (cache.extract(data, start, end) == 0) {
+    this->setErrorString("No valid station data found.");
+    return 1;
+  }
+
+  return 0;
+}
+
+QString WaterData::cacheKey(Datum::VDatum datum) const {
+  Q_UNUSED(datum);
+  return QString();
+}
+
+bool WaterData::useCache() const { return this->m_useCache; }
+
+void WaterData::setUseCache(bool useCache) { this->m_useCache = useCache; }
+
+QString WaterData::cacheDirectory() const { return this->m_cacheDirectory; }
+
+void WaterData::setCacheDirectory(const QString &cacheDirectory) {
+  this->m_cacheDirectory = cacheDirectory;
+}
+
+QVector<QUrl> WaterData::requestUrls() { return QVector<QUrl>(); }
+
+int WaterData::processResponses(const QVector<QByteArray> &responses,
+                                Hmdf *data) {
+  Q_UNUSED(responses);
+  Q_UNUSED(data);
+  this->setErrorString("Batch requests are not supported for this source.");
+  return 1;
 }
 
 QString WaterData::errorString() const { return this->m_errorString; }
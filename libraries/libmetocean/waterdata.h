@@ -20,8 +20,11 @@
 #ifndef WATERDATA_H
 #define WATERDATA_H
 
+#include <QByteArray>
 #include <QNetworkReply>
 #include <QObject>
+#include <QUrl>
+#include <QVector>
 
 #include "datum.h"
 #include "hmdf.h"
@@ -37,14 +40,33 @@ class WaterData : public QObject {
 
   int get(Hmdf *data, Datum::VDatum datum = Datum::VDatum::NullDatum);
 
+  //...Split form of get() used by WaterDataBatch so that many stations can
+  //   share one network manager. requestUrls() lists the requests needed
+  //   for this station and processResponses() parses the ones that
+  //   succeeded, given in request order.
+  virtual QVector<QUrl> requestUrls();
+  virtual int processResponses(const QVector<QByteArray> &responses,
+                               Hmdf *data);
+
   QString errorString() const;
 
+  bool useCache() const;
+  void setUseCache(bool useCache);
+
+  QString cacheDirectory() const;
+  void setCacheDirectory(const QString &cacheDirectory);
+
   Timezone *getTimezone() const;
   void setTimezone(Timezone *timezone);
 
+ signals:
+  void progress(int complete, int total);
+
  protected:
   virtual int retrieveData(Hmdf *data, Datum::VDatum datum);
 
+  virtual QString cacheKey(Datum::VDatum datum) const;
+
   void setErrorString(const QString &errorString);
 
   Station station() const;
@@ -57,7 +79,11 @@ class WaterData : public QObject {
   void setEndDate(const QDateTime &endDate);
 
  private:
+  int getCached(Hmdf *data, Datum::VDatum datum, const QString &key);
+
   QString m_errorString;
+  QString m_cacheDirectory;
+  bool m_useCache;
   Station m_station;
   QDateTime m_startDate;
   QDateTime m_endDate;
@@ -0,0 +1,159 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "waterdatabatch.h"
+
+WaterDataBatch::WaterDataBatch(QObject *parent)
+    : QObject(parent),
+      m_manager(new QNetworkAccessManager(this)),
+      m_downloader(new ChunkDownloader(m_manager, this)),
+      m_elapsed(0),
+      m_bytesReceived(0),
+      m_numComplete(0),
+      m_numFailed(0) {
+  this->m_downloader->setMaxConcurrent(16);
+  this->m_downloader->setMaxConcurrentPerHost(6);
+  connect(this->m_downloader, SIGNAL(chunkFinished(int)), this,
+          SLOT(chunkFinished(int)));
+}
+
+int WaterDataBatch::maxConcurrent() const {
+  return this->m_downloader->maxConcurrent();
+}
+
+void WaterDataBatch::setMaxConcurrent(int maxConcurrent) {
+  this->m_downloader->setMaxConcurrent(maxConcurrent);
+}
+
+int WaterDataBatch::maxConcurrentPerHost() const {
+  return this->m_downloader->maxConcurrentPerHost();
+}
+
+void WaterDataBatch::setMaxConcurrentPerHost(int maxConcurrentPerHost) {
+  this->m_downloader->setMaxConcurrentPerHost(maxConcurrentPerHost);
+}
+
+//...The batch does not take ownership of the fetcher
+void WaterDataBatch::addFetcher(WaterData *fetcher) {
+  this->m_fetchers.push_back(fetcher);
+}
+
+int WaterDataBatch::nFetchers() const { return this->m_fetchers.size(); }
+
+int WaterDataBatch::numSucceeded() const {
+  return this->m_numComplete - this->m_numFailed;
+}
+
+int WaterDataBatch::numFailed() const { return this->m_numFailed; }
+
+qint64 WaterDataBatch::bytesReceived() const { return this->m_bytesReceived; }
+
+qint64 WaterDataBatch::elapsed() const { return this->m_elapsed; }
+
+//...Aggregate download rate over the whole batch in bytes per second
+double WaterDataBatch::throughput() const {
+  if (this->m_elapsed <= 0) return 0.0;
+  return static_cast<double>(this->m_bytesReceived) /
+         (static_cast<double>(this->m_elapsed) / 1000.0);
+}
+
+//...Downloads every station and returns once all of them have been handed
+//   out through stationFinished() or stationFailed(). The Hmdf passed to
+//   stationFinished() is deleted when the signal returns, so receivers must
+//   reparent any stations they keep. Returns the number of stations that
+//   failed.
+int WaterDataBatch::run() {
+  QVector<QUrl> urls;
+  this->m_chunkOwner.clear();
+  this->m_firstChunk.resize(this->m_fetchers.size());
+  this->m_remaining.resize(this->m_fetchers.size());
+  this->m_numComplete = 0;
+  this->m_numFailed = 0;
+
+  for (int i = 0; i < this->m_fetchers.size(); ++i) {
+    QVector<QUrl> u = this->m_fetchers[i]->requestUrls();
+    this->m_firstChunk[i] = urls.size();
+    this->m_remaining[i] = u.size();
+    for (auto &url : u) {
+      urls.push_back(url);
+      this->m_chunkOwner.push_back(i);
+    }
+  }
+
+  this->m_timer.start();
+
+  //...Stations without any requests cannot be fetched
+  for (int i = 0; i < this->m_fetchers.size(); ++i) {
+    if (this->m_remaining[i] == 0) {
+      this->m_numComplete++;
+      this->m_numFailed++;
+      emit stationFailed(i, this->m_fetchers[i]->errorString());
+      emit progress(this->m_numComplete, this->m_fetchers.size());
+    }
+  }
+
+  QVector<QByteArray> unused;
+  this->m_downloader->download(urls, unused);
+
+  this->m_elapsed = this->m_timer.elapsed();
+  this->m_bytesReceived = this->m_downloader->bytesReceived();
+
+  return this->m_numFailed;
+}
+
+void WaterDataBatch::chunkFinished(int chunk) {
+  int index = this->m_chunkOwner[chunk];
+  if (--this->m_remaining[index] > 0) return;
+
+  //...All requests for this station are in, so parse it now and release
+  //   the raw responses before the rest of the batch finishes
+  int first = this->m_firstChunk[index];
+  int last = first;
+  while (last + 1 < this->m_chunkOwner.size() &&
+         this->m_chunkOwner[last + 1] == index)
+    ++last;
+
+  QVector<QByteArray> responses;
+  QString errorString;
+  for (int i = first; i <= last; ++i) {
+    if (this->m_downloader->succeeded(i))
+      responses.push_back(this->m_downloader->takeResult(i));
+  }
+  if (responses.isEmpty()) errorString = this->m_downloader->errorString();
+
+  this->m_numComplete++;
+
+  int ierr = 1;
+  Hmdf *data = new Hmdf(this);
+  if (!responses.isEmpty()) {
+    ierr = this->m_fetchers[index]->processResponses(responses, data);
+    if (ierr != 0) errorString = this->m_fetchers[index]->errorString();
+  }
+  responses.clear();
+
+  if (ierr == 0) {
+    emit stationFinished(index, data);
+  } else {
+    this->m_numFailed++;
+    emit stationFailed(index, errorString);
+  }
+  delete data;
+
+  emit progress(this->m_numComplete, this->m_fetchers.size());
+}
@@ -0,0 +1,81 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef WATERDATABATCH_H
+#define WATERDATABATCH_H
+
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QVector>
+#include "chunkdownloader.h"
+#include "hmdf.h"
+#include "metocean_global.h"
+#include "waterdata.h"
+
+//...Fetches data for many stations at once. Every request from every
+//   station goes through one shared network manager with a global and a
+//   per host limit on requests in flight. Each station is parsed as soon as
+//   its last request finishes and handed out with stationFinished(), so
+//   callers can consume results while the remaining stations download.
+class WaterDataBatch : public QObject {
+  Q_OBJECT
+ public:
+  explicit WaterDataBatch(QObject *parent = nullptr);
+
+  int maxConcurrent() const;
+  void setMaxConcurrent(int maxConcurrent);
+
+  int maxConcurrentPerHost() const;
+  void setMaxConcurrentPerHost(int maxConcurrentPerHost);
+
+  void addFetcher(WaterData *fetcher);
+  int nFetchers() const;
+
+  int run();
+
+  int numSucceeded() const;
+  int numFailed() const;
+  qint64 bytesReceived() const;
+  qint64 elapsed() const;
+  double throughput() const;
+
+ signals:
+  void stationFinished(int index, Hmdf *data);
+  void stationFailed(int index, QString errorString);
+  void progress(int complete, int total);
+
+ private slots:
+  void chunkFinished(int chunk);
+
+ private:
+  QNetworkAccessManager *m_manager;
+  ChunkDownloader *m_downloader;
+  QVector<WaterData *> m_fetchers;
+  QVector<int> m_chunkOwner;
+  QVector<int> m_firstChunk;
+  QVector<int> m_remaining;
+  QElapsedTimer m_timer;
+  qint64 m_elapsed;
+  qint64 m_bytesReceived;
+  int m_numComplete;
+  int m_numFailed;
+};
+
+#endif  // WATERDATABATCH_H
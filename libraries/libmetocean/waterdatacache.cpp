@@ -0,0 +1,272 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#include "waterdatacache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <numeric>
+#include "generic.h"
+
+static const quint32 c_cacheMagic = 0x4d4f5643;
+static const quint32 c_cacheVersion = 2;
+
+WaterDataCache::WaterDataCache(const QString &key, const QString &directory)
+    : m_key(key) {
+  QByteArray hash =
+      QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1);
+  this->m_filename =
+      directory + "/" + QString::fromLatin1(hash.toHex()) + ".cache";
+}
+
+QString WaterDataCache::defaultDirectory() {
+  return Generic::configDirectory() + "/cache";
+}
+
+//...Removes cache files that have not been written for maxDays, then the
+//   oldest remaining ones until the directory holds at most maxBytes
+void WaterDataCache::prune(const QString &directory, qint64 maxBytes,
+                           int maxDays) {
+  QFileInfoList files =
+      QDir(directory).entryInfoList(QStringList() << "*.cache", QDir::Files,
+                                    QDir::Time | QDir::Reversed);
+  QDateTime expired = QDateTime::currentDateTimeUtc().addDays(-maxDays);
+
+  qint64 total = 0;
+  for (auto &f : files) total += f.size();
+
+  for (auto &f : files) {
+    if (f.lastModified().toUTC() >= expired && total <= maxBytes) break;
+    if (QFile::remove(f.absoluteFilePath())) total -= f.size();
+  }
+}
+
+QString WaterDataCache::key() const { return this->m_key; }
+
+QString WaterDataCache::filename() const { return this->m_filename; }
+
+QVector<WaterDataCache::Interval> WaterDataCache::coverage() const {
+  return this->m_coverage;
+}
+
+//...Loads the cache file if one exists. A missing, truncated or mismatched
+//   file leaves the cache empty so that everything is fetched again.
+bool WaterDataCache::read() {
+  this->m_coverage.clear();
+  this->m_series.clear();
+
+  QFile f(this->m_filename);
+  if (!f.exists()) return false;
+  if (!f.open(QIODevice::ReadOnly)) return false;
+
+  QDataStream header(&f);
+  header.setVersion(QDataStream::Qt_5_6);
+  quint32 magic, version;
+  header >> magic >> version;
+  if (magic != c_cacheMagic || version != c_cacheVersion) return false;
+
+  QByteArray payload = qUncompress(f.readAll());
+  f.close();
+  if (payload.isEmpty()) return false;
+
+  QDataStream in(payload);
+  in.setVersion(QDataStream::Qt_5_6);
+
+  QString key;
+  quint32 nCoverage, nSeries;
+  in >> key;
+  if (key != this->m_key) return false;
+
+  in >> nCoverage;
+  this->m_coverage.resize(nCoverage);
+  for (auto &c : this->m_coverage) in >> c.first >> c.second;
+
+  in >> nSeries;
+  this->m_series.resize(nSeries);
+  for (auto &s : this->m_series) {
+    qint32 stationIndex;
+    in >> s.id >> s.name >> s.latitude >> s.longitude >> stationIndex >>
+        s.date >> s.data;
+    s.stationIndex = stationIndex;
+  }
+
+  if (in.status() != QDataStream::Ok) {
+    this->m_coverage.clear();
+    this->m_series.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool WaterDataCache::write() const {
+  QDir().mkpath(QFileInfo(this->m_filename).absolutePath());
+
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_6);
+
+  out << this->m_key;
+  out << static_cast<quint32>(this->m_coverage.size());
+  for (auto &c : this->m_coverage) out << c.first << c.second;
+
+  out << static_cast<quint32>(this->m_series.size());
+  for (auto &s : this->m_series) {
+    out << s.id << s.name << s.latitude << s.longitude
+        << static_cast<qint32>(s.stationIndex) << s.date << s.data;
+  }
+
+  QSaveFile f(this->m_filename);
+  if (!f.open(QIODevice::WriteOnly)) return false;
+  QDataStream header(&f);
+  header.setVersion(QDataStream::Qt_5_6);
+  header << c_cacheMagic << c_cacheVersion;
+  f.write(qCompress(payload));
+  return f.commit();
+}
+
+//...Returns the parts of [start, end] not yet held in the cache, in order
+QVector<WaterDataCache::Interval> WaterDataCache::gaps(qint64 start,
+                                                       qint64 end) const {
+  QVector<Interval> g;
+  qint64 t = start;
+  for (auto &c : this->m_coverage) {
+    if (c.second < t) continue;
+    if (c.first > end) break;
+    if (c.first > t) g.push_back(Interval(t, c.first));
+    t = std::max(t, c.second);
+  }
+  if (t < end) g.push_back(Interval(t, end));
+  return g;
+}
+
+void WaterDataCache::addCoverage(qint64 start, qint64 end) {
+  if (end <= start) return;
+  this->m_coverage.push_back(Interval(start, end));
+  std::sort(this->m_coverage.begin(), this->m_coverage.end());
+
+  QVector<Interval> merged;
+  for (auto &c : this->m_coverage) {
+    if (!merged.isEmpty() && c.first <= merged.last().second) {
+      merged.last().second = std::max(merged.last().second, c.second);
+    } else {
+      merged.push_back(c);
+    }
+  }
+  this->m_coverage = merged;
+}
+
+//...Folds freshly downloaded samples into a cached series. Where both hold
+//   a value for the same time the new one wins so revised data replaces
+//   what was stored earlier.
+void WaterDataCache::merge(Series &series, HmdfStation *station) {
+  HmdfSpan<qint64> date = station->dateView();
+  HmdfSpan<double> data = station->dataView();
+
+  QVector<int> order(static_cast<int>(date.size()));
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return date[a] < date[b]; });
+
+  QVector<qint64> mergedDate;
+  QVector<double> mergedData;
+  mergedDate.reserve(series.date.size() + order.size());
+  mergedData.reserve(series.date.size() + order.size());
+
+  int i = 0, j = 0;
+  while (i < series.date.size() || j < order.size()) {
+    if (j == order.size() ||
+        (i < series.date.size() && series.date[i] < date[order[j]])) {
+      mergedDate.push_back(series.date[i]);
+      mergedData.push_back(series.data[i]);
+      ++i;
+    } else {
+      qint64 t = date[order[j]];
+      if (i < series.date.size() && series.date[i] == t) ++i;
+      if (!mergedDate.isEmpty() && mergedDate.last() == t) {
+        mergedData.last() = data[order[j]];
+      } else {
+        mergedDate.push_back(t);
+        mergedData.push_back(data[order[j]]);
+      }
+      ++j;
+    }
+  }
+
+  series.date = mergedDate;
+  series.data = mergedData;
+}
+
+//...Adds the result of a download for [start, end] to the cache. Only the
+//   part of the window up to coveredEnd is recorded as complete so data
+//   that may still be revised by the server is requested again next time.
+void WaterDataCache::insert(Hmdf *data, qint64 start, qint64 end,
+                            qint64 coveredEnd) {
+  for (size_t i = 0; i < data->nstations(); ++i) {
+    HmdfStation *st = data->station(i);
+    Series *series = nullptr;
+    for (auto &s : this->m_series) {
+      if (s.id == st->id()) {
+        series = &s;
+        break;
+      }
+    }
+    if (series == nullptr) {
+      this->m_series.push_back(Series());
+      series = &this->m_series.last();
+      series->id = st->id();
+      series->name = st->name();
+      series->latitude = st->latitude();
+      series->longitude = st->longitude();
+      series->stationIndex = st->stationIndex();
+    }
+    merge(*series, st);
+  }
+  this->addCoverage(start, std::min(end, coveredEnd));
+}
+
+//...Builds stations holding the cached samples that fall inside
+//   [start, end]. Returns the number of stations created.
+int WaterDataCache::extract(Hmdf *data, qint64 start, qint64 end) const {
+  int n = 0;
+  for (auto &s : this->m_series) {
+    auto first = std::lower_bound(s.date.begin(), s.date.end(), start);
+    auto last = std::upper_bound(first, s.date.end(), end);
+    int offset = static_cast<int>(first - s.date.begin());
+    int length = static_cast<int>(last - first);
+    if (length == 0) continue;
+
+    HmdfStation *st = new HmdfStation(data);
+    st->setId(s.id);
+    st->setName(s.name);
+    st->setLatitude(s.latitude);
+    st->setLongitude(s.longitude);
+    st->setStationIndex(s.stationIndex);
+    st->setDate(s.date.mid(offset, length));
+    st->setData(s.data.mid(offset, length));
+    data->addStation(st);
+    ++n;
+  }
+  return n;
+}
@@ -0,0 +1,79 @@
+/*-------------------------------GPL-------------------------------------//
+//
+// MetOcean Viewer - A simple interface for viewing hydrodynamic model data
+// Copyright (C) 2019  Zach Cobell
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------*/
+#ifndef WATERDATACACHE_H
+#define WATERDATACACHE_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "hmdf.h"
+#include "metocean_global.h"
+
+//...Local store of previously downloaded series for one station/product
+//   combination. Each cache file is named by a hash of its key and holds
+//   the covered time intervals plus every series seen for the key, so a
+//   request only needs to go to the server for the parts of its window
+//   that are not already on disk.
+class WaterDataCache {
+ public:
+  typedef QPair<qint64, qint64> Interval;
+
+  explicit WaterDataCache(const QString &key,
+                          const QString &directory = defaultDirectory());
+
+  static QString defaultDirectory();
+
+  static void prune(const QString &directory = defaultDirectory(),
+                    qint64 maxBytes = 256LL * 1024 * 1024, int maxDays = 90);
+
+  QString key() const;
+  QString filename() const;
+
+  bool read();
+  bool write() const;
+
+  QVector<Interval> coverage() const;
+  QVector<Interval> gaps(qint64 start, qint64 end) const;
+
+  void insert(Hmdf *data, qint64 start, qint64 end, qint64 coveredEnd);
+
+  int extract(Hmdf *data, qint64 start, qint64 end) const;
+
+ private:
+  struct Series {
+    QString id;
+    QString name;
+    double latitude;
+    double longitude;
+    int stationIndex;
+    QVector<qint64> date;
+    QVector<double> data;
+  };
+
+  void addCoverage(qint64 start, qint64 end);
+  static void merge(Series &series, HmdfStation *station);
+
+  QString m_key;
+  QString m_filename;
+  QVector<Interval> m_coverage;
+  QVector<Series> m_series;
+};
+
+#endif  // WATERDATACACHE_H